@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace fmtals {
+
+/// @brief Represents a string interned in the process wide atom table. Equal strings share the
+/// same atom, so comparing two atoms is an integer comparison even across projects. Atoms are
+/// reference counted: a string is released from the table once the last atom holding it is
+/// destroyed, so that the table only holds the strings of the projects alive. The default atom is
+/// the empty string and is not counted
+struct atom {
+    std::uint32_t index = 0;
+
+    atom() = default;
+
+    atom(const atom& other)
+        : index(other.index)
+    {
+        retain();
+    }
+
+    atom(atom&& other) noexcept
+        : index(std::exchange(other.index, 0))
+    {
+    }
+
+    atom& operator=(atom other) noexcept
+    {
+        std::swap(index, other.index);
+        return *this;
+    }
+
+    ~atom()
+    {
+        release();
+    }
+
+    /// @brief Retrieves the string of the atom, see atom_string
+    operator const std::string&() const;
+
+private:
+    void retain() const;
+    void release() const;
+
+    friend atom make_atom(const std::string_view str);
+};
+
+inline bool operator==(const atom& lhs, const atom& rhs)
+{
+    return lhs.index == rhs.index;
+}
+
+inline bool operator!=(const atom& lhs, const atom& rhs)
+{
+    return lhs.index != rhs.index;
+}
+
+/// @brief Interns a string and retrieves an atom holding it. This function is thread safe, as is
+/// copying and destroying atoms
+/// @param str
+atom make_atom(const std::string_view str);
+
+/// @brief Retrieves the string of an atom. The reference stays valid as long as an atom holding
+/// the same string exists
+/// @param value
+const std::string& atom_string(const atom& value);
+
+/// @brief Retrieves the number of distinct strings currently interned, including the empty string
+std::size_t atom_count();
+
+}
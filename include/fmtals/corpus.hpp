@@ -0,0 +1,125 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Represents a table of a corpus dataset. Every row of the other tables has a project_id
+/// column holding the row of its project, and the rows of automation lanes and audio clips a
+/// track_id column holding the row of their track. Tracks include return tracks and the master
+/// track, but not the pre hear track. Their kind column is 0 for audio, 1 for MIDI, 2 for group, 3
+/// for return and 4 for the master track. Audio clips are the arrangement clips of audio tracks as
+/// imported from the set, with their time in beats
+enum struct corpus_table : std::uint32_t {
+    project,
+    track,
+    automation_lane,
+    scene,
+    audio_clip,
+};
+
+/// @brief Represents the type of the values of a column. Booleans are stored as one byte and
+/// strings as 32 bit codes into the string dictionary of the dataset
+enum struct corpus_type : std::uint32_t {
+    boolean,
+    int32,
+    uint32,
+    float32,
+    string,
+};
+
+/// @brief Represents a column of a corpus dataset in memory before it is appended. Data holds the
+/// values in host byte order, string codes index the strings of the builder
+struct corpus_builder_column {
+    corpus_table table;
+    std::string_view name;
+    corpus_type type;
+    std::vector<std::uint8_t> data;
+};
+
+/// @brief Represents the rows of projects added in memory, to be appended to a dataset at once.
+/// Project and track ids are local to the builder and rebased when appended
+struct corpus_builder {
+    std::vector<corpus_builder_column> columns;
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, std::uint32_t> string_codes;
+    std::size_t row_counts[5] = {};
+};
+
+/// @brief Represents a corpus dataset opened read only. The manifest, the file of every column and
+/// the string dictionary are mapped in memory and read in place. Copies share the same mappings,
+/// which are released with the last of them
+struct corpus_dataset {
+    std::filesystem::path path;
+    std::shared_ptr<const char> manifest;
+    std::vector<std::shared_ptr<const char>> columns;
+    std::shared_ptr<const char> string_offsets;
+    std::shared_ptr<const char> string_data;
+};
+
+/// @brief Represents a column of an open dataset. Data points to row count contiguous values of
+/// the type of the column inside the mapping of its file, nullptr when the column has no rows,
+/// and is valid as long as the dataset is open
+struct corpus_column {
+    corpus_table table;
+    std::string_view name;
+    corpus_type type;
+    const void* data = nullptr;
+    std::size_t row_count = 0;
+};
+
+/// @brief Adds a project to a builder as one row of the project table and one row per track,
+/// automation lane, scene and arrangement audio clip. Name identifies the project, such as the
+/// path of its set
+/// @param builder
+/// @param proj
+/// @param ver
+/// @param name
+void add_corpus_project(corpus_builder& builder, const project& proj, const version& ver, const std::string_view name);
+
+/// @brief Appends the rows of a builder to the dataset in the directory at a path, creating it
+/// when it does not exist. Every column is a file of its own, the new rows and strings are written
+/// at the end of the files and the manifest holding their sizes is replaced once they are
+/// complete, so appending is linear in the size of the builder and of the string dictionary and an
+/// interrupted append leaves the previous dataset intact. Appends to a dataset must not run
+/// concurrently
+/// @param path
+/// @param builder
+void append_corpus_dataset(const std::filesystem::path& path, const corpus_builder& builder);
+
+/// @brief Opens a dataset by mapping its files in memory and checking them against its manifest
+/// @param path
+/// @param dataset
+void open_corpus_dataset(const std::filesystem::path& path, corpus_dataset& dataset);
+
+/// @brief Retrieves the number of rows of a table of a dataset
+/// @param dataset
+/// @param table
+std::size_t corpus_row_count(const corpus_dataset& dataset, const corpus_table table);
+
+/// @brief Retrieves the columns of every table of a dataset, in the order of the file
+/// @param dataset
+std::vector<corpus_column> list_corpus_columns(const corpus_dataset& dataset);
+
+/// @brief Retrieves a column of a table by name. Throws when the table has no such column
+/// @param dataset
+/// @param table
+/// @param name
+corpus_column find_corpus_column(const corpus_dataset& dataset, const corpus_table table, const std::string_view name);
+
+/// @brief Retrieves the string of a code of a string column. The string points into the mapped
+/// dataset
+/// @param dataset
+/// @param code
+std::string_view get_corpus_string(const corpus_dataset& dataset, const std::uint32_t code);
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Represents which part of a project a change applies to
+enum struct change_scope : std::uint32_t {
+    settings,
+    track,
+    return_track,
+    master_track,
+    pre_hear_track,
+    scene,
+};
+
+/// @brief Represents the kind of a change. Lane and clip changes are reported on the track that
+/// owns them, with the lane or clip position stored in the child indices
+enum struct change_type : std::uint32_t {
+    added,
+    removed,
+    moved,
+    renamed,
+    modified,
+    device_chain_modified,
+    lane_added,
+    lane_removed,
+    lane_modified,
+    clip_added,
+    clip_removed,
+    clip_moved,
+    clip_modified,
+};
+
+/// @brief Represents a single structural change between two projects. Indices refer to positions in
+/// the old and new project and are set to npos when the element does not exist on that side
+struct change {
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    change_scope scope;
+    change_type type;
+    std::size_t old_index = npos;
+    std::size_t new_index = npos;
+    std::size_t old_child_index = npos;
+    std::size_t new_child_index = npos;
+};
+
+/// @brief Represents the hashes of the subtrees of a track. Names cover the effective and user
+/// names but not the memorized first clip name, which is derived from the clips
+struct track_digest {
+    std::size_t kind = 0;
+    std::uint64_t names = 0;
+    std::uint64_t header = 0;
+    std::uint64_t device_chain = 0;
+    std::vector<std::uint64_t> lanes;
+    std::vector<std::uint64_t> clips;
+    std::vector<std::uint64_t> clip_contents;
+    std::uint64_t subtree = 0;
+};
+
+/// @brief Represents the hashes of every subtree of a project, see digest_project. The hashes are
+/// only meant to be compared within the same process
+struct project_digest {
+    std::uint64_t settings = 0;
+    std::vector<track_digest> tracks;
+    std::vector<track_digest> return_tracks;
+    track_digest master_track;
+    track_digest pre_hear_track;
+    std::vector<std::uint64_t> scenes;
+};
+
+/// @brief Hashes every track, device chain, lane, clip and scene of a project once. Keep the
+/// digest of a project that is diffed many times, such as the base of a series of revisions, so
+/// that it is not hashed again on every call
+/// @param proj
+project_digest digest_project(const project& proj);
+
+/// @brief Computes the structural changes between two projects. Every track, device chain, scene
+/// and clip is hashed once so that unchanged subtrees are skipped with a single comparison.
+/// Tracks are matched by their id, scenes and clips by content
+/// @param from
+/// @param to
+std::vector<change> diff(const project& from, const project& to);
+
+/// @brief Computes the structural changes between two projects from digests computed beforehand
+/// with digest_project. The projects must not have been modified since
+/// @param from
+/// @param from_digest
+/// @param to
+/// @param to_digest
+std::vector<change> diff(const project& from, const project_digest& from_digest, const project& to, const project_digest& to_digest);
+
+}
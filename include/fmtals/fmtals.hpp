@@ -1,8 +1,13 @@
 #pragma once
 
+#include <fmtals/atom.hpp>
+
+#include <cstddef>
 #include <iostream>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -19,128 +24,452 @@ enum struct version : std::uint32_t {
     v_12_0_0 = 11200,
 };
 
+struct project;
+
+/// @brief Moves every optional member and track of a project that was constructed outside of the
+/// memory resource of the project into it, with everything it owns. std::optional and std::variant
+/// are not allocator aware, so assigning an engaged optional to an empty one or a track of another
+/// type constructs the value with the default resource. Call it after assigning to a project that
+/// has its own memory resource
+/// @param proj
+void adopt_project_allocator(project& proj);
+
 /// @brief Represents a subset of an Ableton Live project. Subset contains everything except
 /// Live effects, instruments, modulators and max devices that are represented as info strings.
-/// VST2&3 plugins are supported
+/// VST2&3 plugins are supported. Containers use polymorphic allocators, a project constructed with
+/// a memory resource keeps every string and list it owns in that resource, including the ones
+/// created by import_project, load_stored_project and load_project_snapshot. The resource is only
+/// used by several threads at once when it is thread safe, see import_options
 struct project {
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
 
     struct warp_marker {
-        float sec_time;
-        float beat_time;
+        float sec_time = 0;
+        float beat_time = 0;
     };
 
     struct audio_clip {
-        std::uint32_t lom_id;
-        std::uint32_t lom_id_view;
-        std::uint32_t time;
-        std::vector<warp_marker> warp_markers;
-        bool markers_generated;
-        float current_start;
-        float current_end;
-        float loop_start;
-        float loop_end;
-        float loop_start_relative;
-        bool loop_on;
-        float loop_out_marker;
-        float hidden_loop_start;
-        float hidden_loop_end;
-        std::string name;
-        std::string annotation;
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        std::uint32_t lom_id = 0;
+        std::uint32_t lom_id_view = 0;
+        double time = 0;
+        std::pmr::vector<warp_marker> warp_markers;
+        bool markers_generated = false;
+        float current_start = 0;
+        float current_end = 0;
+        float loop_start = 0;
+        float loop_end = 0;
+        float loop_start_relative = 0;
+        bool loop_on = false;
+        float loop_out_marker = 0;
+        float hidden_loop_start = 0;
+        float hidden_loop_end = 0;
+        std::pmr::string name;
+        std::pmr::string annotation;
         std::optional<std::uint32_t> color_index;
         std::optional<std::uint32_t> color;
-        std::uint32_t launch_mode;
-        std::uint32_t launch_quantisation;
+        std::uint32_t launch_mode = 0;
+        std::uint32_t launch_quantisation = 0;
         // time signature bizar
         // envelopes bizar
-        float scroller_time_preserver_left_time;
-        float scroller_time_preserver_right_time;
-        float time_selection_anchor_time;
-        float time_selection_other_time;
-        bool legato;
-        bool ram;
+        float scroller_time_preserver_left_time = 0;
+        float scroller_time_preserver_right_time = 0;
+        float time_selection_anchor_time = 0;
+        float time_selection_other_time = 0;
+        bool legato = false;
+        bool ram = false;
         // groove settings
-        bool disabled;
-        float velocity_amount;
-        std::uint32_t follow_time;
-        std::uint32_t follow_action_a;
-        std::uint32_t follow_action_b;
-        std::uint32_t follow_chance_a;
-        std::uint32_t follow_chance_b;
-        std::uint32_t grid_fixed_numerator;
-        std::uint32_t grid_fixed_denominator;
-        std::uint32_t grid_interval_pixel;
-        std::uint32_t grid_ntoles;
-        bool grid_snap_to_grid;
-        bool grid_fixed;
-        float freeze_start;
-        float freeze_end;
-        bool is_song_tempo_master;
-        bool is_warped;
+        bool disabled = false;
+        float velocity_amount = 0;
+        std::uint32_t follow_time = 0;
+        std::uint32_t follow_action_a = 0;
+        std::uint32_t follow_action_b = 0;
+        std::uint32_t follow_chance_a = 0;
+        std::uint32_t follow_chance_b = 0;
+        std::uint32_t grid_fixed_numerator = 0;
+        std::uint32_t grid_fixed_denominator = 0;
+        std::uint32_t grid_interval_pixel = 0;
+        std::uint32_t grid_ntoles = 0;
+        bool grid_snap_to_grid = false;
+        bool grid_fixed = false;
+        float freeze_start = 0;
+        float freeze_end = 0;
+        bool is_song_tempo_master = false;
+        bool is_warped = false;
+
+        audio_clip() = default;
+
+        explicit audio_clip(const allocator_type& allocator)
+            : warp_markers(allocator)
+            , name(allocator)
+            , annotation(allocator)
+        {
+        }
+
+        audio_clip(const audio_clip& other, const allocator_type& allocator)
+            : audio_clip(allocator)
+        {
+            *this = other;
+        }
+
+        audio_clip(audio_clip&& other, const allocator_type& allocator)
+            : audio_clip(allocator)
+        {
+            *this = std::move(other);
+        }
+
+        allocator_type get_allocator() const
+        {
+            return name.get_allocator();
+        }
     };
 
     struct midi_clip {
     };
 
     struct automation_lane {
-        std::uint32_t selected_device;
-        std::uint32_t selected_envelope;
-        bool is_content_selected;
-        std::uint32_t lane_height;
-        bool fade_view_visible;
+        std::uint32_t selected_device = 0;
+        std::uint32_t selected_envelope = 0;
+        bool is_content_selected = false;
+        std::uint32_t lane_height = 0;
+        bool fade_view_visible = false;
+    };
+
+    struct clip_slot {
+        std::uint32_t id = 0;
+        std::uint32_t lom_id = 0;
+        bool has_clip = false;
+        std::uint32_t clip_index = 0; // Index of the clip in session_clips when has_clip is set
+        std::optional<std::uint32_t> clip_color; // Version >= 12.0.0
+        std::optional<std::uint32_t> clip_color_index; // Version < 12.0.0
+        bool has_stop = true;
+        bool need_refreeze = false;
+    };
+
+    struct automation_event {
+        std::uint32_t id = 0;
+        double time = 0;
+        float value = 0;
+    };
+
+    struct automation_envelope {
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        std::uint32_t id = 0;
+        std::uint32_t pointee_id = 0;
+        std::pmr::vector<automation_event> events;
+
+        automation_envelope() = default;
+
+        explicit automation_envelope(const allocator_type& allocator)
+            : events(allocator)
+        {
+        }
+
+        automation_envelope(const automation_envelope& other, const allocator_type& allocator)
+            : automation_envelope(allocator)
+        {
+            *this = other;
+        }
+
+        automation_envelope(automation_envelope&& other, const allocator_type& allocator)
+            : automation_envelope(allocator)
+        {
+            *this = std::move(other);
+        }
+
+        allocator_type get_allocator() const
+        {
+            return events.get_allocator();
+        }
+    };
+
+    struct plugin_parameter {
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        std::uint32_t id = 0;
+        std::pmr::string name;
+        std::int32_t parameter_id = 0;
+        float value = 0;
+
+        plugin_parameter() = default;
+
+        explicit plugin_parameter(const allocator_type& allocator)
+            : name(allocator)
+        {
+        }
+
+        plugin_parameter(const plugin_parameter& other, const allocator_type& allocator)
+            : plugin_parameter(allocator)
+        {
+            *this = other;
+        }
+
+        plugin_parameter(plugin_parameter&& other, const allocator_type& allocator)
+            : plugin_parameter(allocator)
+        {
+            *this = std::move(other);
+        }
+
+        allocator_type get_allocator() const
+        {
+            return name.get_allocator();
+        }
+    };
+
+    // Preset states are kept as the hex text of the set, see decode_plugin_state in plugin.hpp
+    struct vst2_plugin {
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        std::pmr::string path;
+        std::pmr::string plug_name;
+        std::int32_t unique_id = 0;
+        std::uint32_t inputs = 0;
+        std::uint32_t outputs = 0;
+        std::uint32_t number_of_parameters = 0;
+        std::uint32_t number_of_programs = 0;
+        std::uint32_t flags = 0;
+        bool has_preset = false;
+        std::uint32_t preset_id = 0;
+        std::pmr::string buffer;
+
+        vst2_plugin() = default;
+
+        explicit vst2_plugin(const allocator_type& allocator)
+            : path(allocator)
+            , plug_name(allocator)
+            , buffer(allocator)
+        {
+        }
+
+        vst2_plugin(const vst2_plugin& other, const allocator_type& allocator)
+            : vst2_plugin(allocator)
+        {
+            *this = other;
+        }
+
+        vst2_plugin(vst2_plugin&& other, const allocator_type& allocator)
+            : vst2_plugin(allocator)
+        {
+            *this = std::move(other);
+        }
+
+        allocator_type get_allocator() const
+        {
+            return path.get_allocator();
+        }
+    };
+
+    struct vst3_plugin {
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        bool has_preset = false;
+        std::uint32_t preset_id = 0;
+        std::pmr::string processor_state;
+        std::pmr::string controller_state;
+        std::pmr::string name;
+        std::int32_t uid_0 = 0;
+        std::int32_t uid_1 = 0;
+        std::int32_t uid_2 = 0;
+        std::int32_t uid_3 = 0;
+
+        vst3_plugin() = default;
+
+        explicit vst3_plugin(const allocator_type& allocator)
+            : processor_state(allocator)
+            , controller_state(allocator)
+            , name(allocator)
+        {
+        }
+
+        vst3_plugin(const vst3_plugin& other, const allocator_type& allocator)
+            : vst3_plugin(allocator)
+        {
+            *this = other;
+        }
+
+        vst3_plugin(vst3_plugin&& other, const allocator_type& allocator)
+            : vst3_plugin(allocator)
+        {
+            *this = std::move(other);
+        }
+
+        allocator_type get_allocator() const
+        {
+            return name.get_allocator();
+        }
+    };
+
+    struct plugin_device {
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        std::uint32_t id = 0;
+        std::optional<vst2_plugin> vst2; // Neither for Audio Units
+        std::optional<vst3_plugin> vst3;
+        std::pmr::vector<plugin_parameter> parameters;
+
+        plugin_device() = default;
+
+        explicit plugin_device(const allocator_type& allocator)
+            : parameters(allocator)
+        {
+        }
+
+        plugin_device(const plugin_device& other, const allocator_type& allocator)
+            : plugin_device(allocator)
+        {
+            *this = other;
+        }
+
+        plugin_device(plugin_device&& other, const allocator_type& allocator)
+            : plugin_device(allocator)
+        {
+            *this = std::move(other);
+        }
+
+        allocator_type get_allocator() const
+        {
+            return parameters.get_allocator();
+        }
     };
 
     struct device_chain {
-        std::vector<automation_lane> automation_lanes;
-        bool permanent_lanes_are_visible;
-        std::uint32_t envelope_chooser_selected_device;
-        std::uint32_t envelope_chooser_selected_envelope;
-        std::string audio_input_routing_target;
-        std::string audio_input_routing_upper_display_string;
-        std::string audio_input_routing_lower_display_string;
-        std::string midi_input_routing_target;
-        std::string midi_input_routing_upper_display_string;
-        std::string midi_input_routing_lower_display_string;
-        std::string audio_output_routing_target;
-        std::string audio_output_routing_upper_display_string;
-        std::string audio_output_routing_lower_display_string;
-        std::string midi_output_routing_target;
-        std::string midi_output_routing_upper_display_string;
-        std::string midi_output_routing_lower_display_string;
-        std::uint32_t mixer_lom_id;
-        std::uint32_t mixer_lom_id_view;
-        bool is_expanded;
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        std::pmr::vector<automation_lane> automation_lanes;
+        bool permanent_lanes_are_visible = false;
+        std::uint32_t envelope_chooser_selected_device = 0;
+        std::uint32_t envelope_chooser_selected_envelope = 0;
+        atom audio_input_routing_target;
+        atom audio_input_routing_upper_display_string;
+        atom audio_input_routing_lower_display_string;
+        atom midi_input_routing_target;
+        atom midi_input_routing_upper_display_string;
+        atom midi_input_routing_lower_display_string;
+        atom audio_output_routing_target;
+        atom audio_output_routing_upper_display_string;
+        atom audio_output_routing_lower_display_string;
+        atom midi_output_routing_target;
+        atom midi_output_routing_upper_display_string;
+        atom midi_output_routing_lower_display_string;
+        std::uint32_t mixer_lom_id = 0;
+        std::uint32_t mixer_lom_id_view = 0;
+        bool is_expanded = false;
+        std::uint32_t tempo_lom_id = 0;
+        float tempo = 0;
+        std::uint32_t tempo_automation_target_id = 0;
+        std::pmr::vector<plugin_device> plugin_devices; // Not in pre hear tracks
+
+        device_chain() = default;
+
+        explicit device_chain(const allocator_type& allocator)
+            : automation_lanes(allocator)
+            , plugin_devices(allocator)
+        {
+        }
+
+        device_chain(const device_chain& other, const allocator_type& allocator)
+            : device_chain(allocator)
+        {
+            *this = other;
+        }
+
+        device_chain(device_chain&& other, const allocator_type& allocator)
+            : device_chain(allocator)
+        {
+            *this = std::move(other);
+        }
+
+        allocator_type get_allocator() const
+        {
+            return automation_lanes.get_allocator();
+        }
     };
 
     struct base_track : device_chain {
-        std::uint32_t id;
-        std::uint32_t lom_id;
-        std::uint32_t lom_id_view;
-        bool envelope_mode_preferred;
-        std::uint32_t track_delay_value;
-        bool track_delay_is_value_sample_based;
-        std::string effective_name;
-        std::string user_name;
-        std::string annotation;
-        std::optional<std::string> memorized_first_clip_name; // Not in 9.7.7
+        std::uint32_t id = 0;
+        std::uint32_t lom_id = 0;
+        std::uint32_t lom_id_view = 0;
+        bool envelope_mode_preferred = false;
+        std::uint32_t track_delay_value = 0;
+        bool track_delay_is_value_sample_based = false;
+        atom effective_name;
+        std::pmr::string user_name;
+        std::pmr::string annotation;
+        std::optional<std::pmr::string> memorized_first_clip_name; // Not in 9.7.7
         std::optional<std::uint32_t> color;
         std::optional<std::uint32_t> color_index;
-        std::int32_t track_group_id;
-        bool track_unfolded;
-        std::uint32_t devices_list_wrapper_lom_id;
-        std::uint32_t clip_slots_list_wrapper_lom_id;
-        std::string view_data;
+        std::pmr::vector<automation_envelope> automation_envelopes;
+        std::int32_t track_group_id = 0;
+        bool track_unfolded = false;
+        std::uint32_t devices_list_wrapper_lom_id = 0;
+        std::uint32_t clip_slots_list_wrapper_lom_id = 0;
+        std::pmr::string view_data;
+
+        base_track() = default;
+
+        explicit base_track(const allocator_type& allocator)
+            : device_chain(allocator)
+            , user_name(allocator)
+            , annotation(allocator)
+            , automation_envelopes(allocator)
+            , view_data(allocator)
+        {
+        }
+
+        base_track(const base_track& other, const allocator_type& allocator)
+            : base_track(allocator)
+        {
+            *this = other;
+        }
+
+        base_track(base_track&& other, const allocator_type& allocator)
+            : base_track(allocator)
+        {
+            *this = std::move(other);
+        }
+
+        allocator_type get_allocator() const
+        {
+            return user_name.get_allocator();
+        }
     };
 
     struct editable_track : base_track {
-        std::int32_t saved_playing_slot;
-        std::int32_t saved_playing_offset;
-        bool midi_fold_in;
-        bool midi_prelisten;
-        bool freeze;
-        std::uint32_t velocity_detail;
-        bool need_arranger_refreeze;
-        std::uint32_t post_process_freeze_clips;
-        bool midi_target_prefers_fold_or_is_not_uniform;
+        std::int32_t saved_playing_slot = 0;
+        std::int32_t saved_playing_offset = 0;
+        bool midi_fold_in = false;
+        bool midi_prelisten = false;
+        bool freeze = false;
+        std::uint32_t velocity_detail = 0;
+        bool need_arranger_refreeze = false;
+        std::uint32_t post_process_freeze_clips = 0;
+        bool midi_target_prefers_fold_or_is_not_uniform = false;
+        std::uint32_t main_sequencer_lom_id = 0; // Audio and MIDI tracks
+        std::pmr::vector<clip_slot> clip_slots; // Audio and MIDI tracks
+        std::pmr::vector<std::pmr::string> session_clips; // Audio and MIDI tracks, XML of each clip as found in the set
+
+        editable_track() = default;
+
+        explicit editable_track(const allocator_type& allocator)
+            : base_track(allocator)
+            , clip_slots(allocator)
+            , session_clips(allocator)
+        {
+        }
+
+        editable_track(const editable_track& other, const allocator_type& allocator)
+            : editable_track(allocator)
+        {
+            *this = other;
+        }
+
+        editable_track(editable_track&& other, const allocator_type& allocator)
+            : editable_track(allocator)
+        {
+            *this = std::move(other);
+        }
     };
 
     struct audio_track : editable_track {
@@ -149,7 +478,27 @@ struct project {
 
         // main sequencer
 
-        std::vector<audio_clip> events_audio_clips;
+        std::pmr::vector<audio_clip> events_audio_clips;
+
+        audio_track() = default;
+
+        explicit audio_track(const allocator_type& allocator)
+            : editable_track(allocator)
+            , events_audio_clips(allocator)
+        {
+        }
+
+        audio_track(const audio_track& other, const allocator_type& allocator)
+            : audio_track(allocator)
+        {
+            *this = other;
+        }
+
+        audio_track(audio_track&& other, const allocator_type& allocator)
+            : audio_track(allocator)
+        {
+            *this = std::move(other);
+        }
 
         // freeze sequencer
 
@@ -157,26 +506,58 @@ struct project {
     };
 
     struct midi_track : editable_track {
+        using editable_track::editable_track;
     };
 
     struct group_track : editable_track {
+        using editable_track::editable_track;
     };
 
     struct return_track : editable_track {
+        using editable_track::editable_track;
     };
 
     struct master_track : base_track {
+        using base_track::base_track;
     };
 
     struct pre_hear_track : base_track {
+        using base_track::base_track;
     };
 
     struct scene {
-        std::string value;
-        std::string annotation;
-        std::uint32_t color_index;
-        std::uint32_t lom_id;
-        std::uint32_t clip_slots_list_wrapper_lom_id;
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        std::pmr::string value;
+        std::pmr::string annotation;
+        std::uint32_t color_index = 0;
+        std::uint32_t lom_id = 0;
+        std::uint32_t clip_slots_list_wrapper_lom_id = 0;
+
+        scene() = default;
+
+        explicit scene(const allocator_type& allocator)
+            : value(allocator)
+            , annotation(allocator)
+        {
+        }
+
+        scene(const scene& other, const allocator_type& allocator)
+            : scene(allocator)
+        {
+            *this = other;
+        }
+
+        scene(scene&& other, const allocator_type& allocator)
+            : scene(allocator)
+        {
+            *this = std::move(other);
+        }
+
+        allocator_type get_allocator() const
+        {
+            return value.get_allocator();
+        }
     };
 
     struct locator {
@@ -185,61 +566,55 @@ struct project {
     struct groove {
     };
 
-    struct vst2_plugin {
-    };
-
-    struct vst3_plugin {
-    };
-
     // We do not use polymorphism but std::variant instead
     using user_track = std::variant<audio_track, midi_track, group_track, return_track>;
 
-    std::string major_version;
-    std::string minor_version;
-    std::string creator;
-    std::string revision;
-    std::optional<std::string> schema_change_count;
-    std::int32_t overwrite_protection_number;
-    std::uint32_t lom_id;
-    std::uint32_t lom_id_view; // Version >= 12.0.0
-    std::vector<user_track> tracks;
-    std::vector<return_track> return_tracks;
+    std::pmr::string major_version;
+    std::pmr::string minor_version;
+    std::pmr::string creator;
+    std::pmr::string revision;
+    std::optional<std::pmr::string> schema_change_count;
+    std::int32_t overwrite_protection_number = 0;
+    std::uint32_t lom_id = 0;
+    std::uint32_t lom_id_view = 0; // Version >= 12.0.0
+    std::pmr::vector<user_track> tracks;
+    std::pmr::vector<return_track> return_tracks;
     master_track project_master_track;
     pre_hear_track project_prehear_track;
-    std::vector<bool> sends_pre;
-    std::vector<scene> scene_names;
-    std::uint32_t transport_phase_nudge_tempo;
-    bool transport_loop_on;
-    std::uint32_t transport_loop_start;
-    std::uint32_t transport_loop_length;
-    bool transport_loop_is_song_start;
-    std::uint32_t transport_current_time;
-    bool transport_punch_in;
-    bool transport_punch_out;
+    std::pmr::vector<bool> sends_pre;
+    std::pmr::vector<scene> scene_names;
+    std::uint32_t transport_phase_nudge_tempo = 0;
+    bool transport_loop_on = false;
+    std::uint32_t transport_loop_start = 0;
+    std::uint32_t transport_loop_length = 0;
+    bool transport_loop_is_song_start = false;
+    std::uint32_t transport_current_time = 0;
+    bool transport_punch_in = false;
+    bool transport_punch_out = false;
     std::optional<std::uint32_t> transport_metronome_tick_duration; // Version > 9.0.0
-    bool transport_draw_mode;
+    bool transport_draw_mode = false;
     std::optional<bool> transport_computer_keyboard_is_enabled; // Version < 12.0.0
-    std::uint32_t song_master_values_scroller_pos_x;
-    std::uint32_t song_master_values_scroller_pos_y;
-    std::uint32_t global_quantisation;
-    std::uint32_t auto_quantisation;
-    std::uint32_t grid_fixed_numerator;
-    std::uint32_t grid_fixed_denominator;
-    std::uint32_t grid_grid_interval_pixel;
-    std::uint32_t grid_ntoles;
-    bool grid_snap_to_grid;
-    bool grid_fixed;
-    std::uint32_t scale_information_root_note;
-    std::string scale_information_name;
+    std::uint32_t song_master_values_scroller_pos_x = 0;
+    std::uint32_t song_master_values_scroller_pos_y = 0;
+    std::uint32_t global_quantisation = 0;
+    std::uint32_t auto_quantisation = 0;
+    std::uint32_t grid_fixed_numerator = 0;
+    std::uint32_t grid_fixed_denominator = 0;
+    std::uint32_t grid_grid_interval_pixel = 0;
+    std::uint32_t grid_ntoles = 0;
+    bool grid_snap_to_grid = false;
+    bool grid_fixed = false;
+    std::uint32_t scale_information_root_note = 0;
+    atom scale_information_name;
     std::optional<bool> in_key; // Version >= 12.0.0
-    std::uint32_t smpte_format;
-    std::uint32_t time_selection_anchor_time;
-    std::uint32_t time_selection_other_time;
-    double sequencer_navigator_current_zoom;
-    std::uint32_t sequencer_navigator_scroller_pos_x;
-    std::uint32_t sequencer_navigator_scroller_pos_y;
-    std::uint32_t sequencer_navigator_client_size_x;
-    std::uint32_t sequencer_navigator_client_size_y;
+    std::uint32_t smpte_format = 0;
+    std::uint32_t time_selection_anchor_time = 0;
+    std::uint32_t time_selection_other_time = 0;
+    double sequencer_navigator_current_zoom = 0;
+    std::uint32_t sequencer_navigator_scroller_pos_x = 0;
+    std::uint32_t sequencer_navigator_scroller_pos_y = 0;
+    std::uint32_t sequencer_navigator_client_size_x = 0;
+    std::uint32_t sequencer_navigator_client_size_y = 0;
     std::optional<bool> is_content_splitter_open; // Version >= 12.0.0
     std::optional<bool> is_expression_splitter_open; // Version >= 12.0.0
     std::optional<bool> view_state_launch_panel; // Version < 12.0.0
@@ -247,62 +622,148 @@ struct project {
     std::optional<bool> view_state_sample_panel; // Version < 12.0.0
     std::optional<bool> content_splitter_properties_open; // Version < 12.0.0
     std::optional<std::uint32_t> content_splitter_properties_size; // Version < 12.0.0
-    std::uint32_t view_state_fx_slot_count;
-    std::uint32_t view_state_session_mixer_height;
-    std::vector<locator> locators;
+    std::uint32_t view_state_fx_slot_count = 0;
+    std::uint32_t view_state_session_mixer_height = 0;
+    std::pmr::vector<locator> locators;
     // detail clip keys midi
-    std::uint32_t tracks_list_wrapper_lom_id;
-    std::uint32_t visible_tracks_list_wrapper_lom_id;
-    std::uint32_t return_tracks_list_wrapper_lom_id;
-    std::uint32_t scenes_list_wrapper_lom_id;
-    std::uint32_t cue_points_list_wrapper_lom_id;
-    std::uint32_t chooser_bar;
-    std::string annotation;
-    bool solo_or_pfl_saved_value;
-    bool solo_in_place;
-    std::uint32_t crossfade_curve;
-    std::uint32_t latency_compensation;
-    std::int32_t highlighted_track_index;
-    std::vector<groove> groove_pool;
-    bool arrangement_overdub;
-    std::uint32_t color_sequence_index;
-    std::uint32_t auto_color_picker_for_player_and_group_tracks;
-    std::uint32_t auto_color_picker_for_return_and_master_tracks;
-    std::string view_data;
-    bool use_warper_legacy_hiq_mode;
-    std::int32_t video_window_rect_top;
-    std::int32_t video_window_rect_bottom;
-    std::int32_t video_window_rect_left;
-    std::int32_t video_window_rect_right;
-    bool show_video_window;
-    std::uint32_t track_header_width;
-    bool view_state_arranger_has_detail;
-    bool view_state_session_has_detail;
-    bool view_state_detail_is_sample;
-    std::uint32_t view_states_session_io;
-    std::uint32_t view_states_session_sends;
-    std::uint32_t view_states_session_returns;
-    std::uint32_t view_states_session_mixer;
-    std::uint32_t view_states_session_track_delay;
-    std::uint32_t view_states_session_cross_fade;
-    std::uint32_t view_states_session_show_over_view;
-    std::uint32_t view_states_arranger_io;
-    std::uint32_t view_states_arranger_returns;
-    std::uint32_t view_states_arranger_mixer;
-    std::uint32_t view_states_arranger_track_delay;
-    std::uint32_t view_states_arranger_show_over_view;
+    std::uint32_t tracks_list_wrapper_lom_id = 0;
+    std::uint32_t visible_tracks_list_wrapper_lom_id = 0;
+    std::uint32_t return_tracks_list_wrapper_lom_id = 0;
+    std::uint32_t scenes_list_wrapper_lom_id = 0;
+    std::uint32_t cue_points_list_wrapper_lom_id = 0;
+    std::uint32_t chooser_bar = 0;
+    std::pmr::string annotation;
+    bool solo_or_pfl_saved_value = false;
+    bool solo_in_place = false;
+    std::uint32_t crossfade_curve = 0;
+    std::uint32_t latency_compensation = 0;
+    std::int32_t highlighted_track_index = 0;
+    std::pmr::vector<groove> groove_pool;
+    bool arrangement_overdub = false;
+    std::uint32_t color_sequence_index = 0;
+    std::uint32_t auto_color_picker_for_player_and_group_tracks = 0;
+    std::uint32_t auto_color_picker_for_return_and_master_tracks = 0;
+    std::pmr::string view_data;
+    bool use_warper_legacy_hiq_mode = false;
+    std::int32_t video_window_rect_top = 0;
+    std::int32_t video_window_rect_bottom = 0;
+    std::int32_t video_window_rect_left = 0;
+    std::int32_t video_window_rect_right = 0;
+    bool show_video_window = false;
+    std::uint32_t track_header_width = 0;
+    bool view_state_arranger_has_detail = false;
+    bool view_state_session_has_detail = false;
+    bool view_state_detail_is_sample = false;
+    std::uint32_t view_states_session_io = 0;
+    std::uint32_t view_states_session_sends = 0;
+    std::uint32_t view_states_session_returns = 0;
+    std::uint32_t view_states_session_mixer = 0;
+    std::uint32_t view_states_session_track_delay = 0;
+    std::uint32_t view_states_session_cross_fade = 0;
+    std::uint32_t view_states_session_show_over_view = 0;
+    std::uint32_t view_states_arranger_io = 0;
+    std::uint32_t view_states_arranger_returns = 0;
+    std::uint32_t view_states_arranger_mixer = 0;
+    std::uint32_t view_states_arranger_track_delay = 0;
+    std::uint32_t view_states_arranger_show_over_view = 0;
+
+    project() = default;
+
+    explicit project(const allocator_type& allocator)
+        : major_version(allocator)
+        , minor_version(allocator)
+        , creator(allocator)
+        , revision(allocator)
+        , tracks(allocator)
+        , return_tracks(allocator)
+        , project_master_track(allocator)
+        , project_prehear_track(allocator)
+        , sends_pre(allocator)
+        , scene_names(allocator)
+        , locators(allocator)
+        , annotation(allocator)
+        , groove_pool(allocator)
+        , view_data(allocator)
+    {
+    }
+
+    project(const project& other, const allocator_type& allocator)
+        : project(allocator)
+    {
+        *this = other;
+        adopt_project_allocator(*this);
+    }
+
+    project(project&& other, const allocator_type& allocator)
+        : project(allocator)
+    {
+        *this = std::move(other);
+        adopt_project_allocator(*this);
+    }
+
+    allocator_type get_allocator() const
+    {
+        return creator.get_allocator();
+    }
 };
 
-/// @brief
+/// @brief Imports a project and retrieves the Ableton Live version it was created with. The
+/// previous content of the project is replaced and the capacity of its containers is reused, so
+/// importing sets of the same shape into the same project barely allocates
 /// @param stream
 /// @param proj
 /// @param ver
 void import_project(std::istream& stream, project& proj, version& ver);
 
+/// @brief Represents the options of a project import. Jobs is the number of threads binding
+/// tracks, 0 meaning one per hardware thread. The imported project does not depend on it. Tracks
+/// are bound on one thread when the memory resource of the project is not thread safe according
+/// to is_thread_safe_resource of fmtals/memory.hpp. Resource is the memory resource of the
+/// inflated text and the XML document of the call, nullptr meaning the default resource, it is
+/// only used from the calling thread and the project keeps allocating from its own
+struct import_options {
+    std::size_t jobs = 1;
+    std::pmr::memory_resource* resource = nullptr;
+};
+
+/// @brief Imports a project and retrieves the Ableton Live version it was created with. With more
+/// than one job the tracks are bound concurrently on a thread pool, each into its own position of
+/// the presized track list. When several tracks fail the error of the first one is thrown
+/// @param stream
+/// @param proj
+/// @param ver
+/// @param options
+void import_project(std::istream& stream, project& proj, version& ver, const import_options& options);
+
 /// @brief
 /// @param stream
 /// @param proj
 /// @param ver
 void export_project(std::ostream& stream, const project& proj, const version& ver);
 
+/// @brief Represents the options of a project export. Jobs is the number of threads serializing
+/// tracks, 0 meaning one per hardware thread. The output does not depend on it. Resource is the
+/// memory resource of the XML documents, the printed text and the compression buffers of the call,
+/// nullptr meaning the default resource. When it is not thread safe according to
+/// is_thread_safe_resource of fmtals/memory.hpp, the tracks serialized in parallel allocate from a
+/// synchronized pool over it
+struct export_options {
+    std::size_t jobs = 1;
+    std::pmr::memory_resource* resource = nullptr;
+};
+
+/// @brief Exports a project for a specified Ableton Live version. With more than one job every
+/// track is serialized into its own buffer on a thread pool and the buffers are written in order
+/// @param stream
+/// @param proj
+/// @param ver
+/// @param options
+void export_project(std::ostream& stream, const project& proj, const version& ver, const export_options& options);
+
+/// @brief Fills and clears the version dependent fields of a project so that it can be exported
+/// for a specified Ableton Live version. Header strings are rewritten to match that version
+/// @param proj
+/// @param ver
+void migrate_project(project& proj, const version& ver);
+
 }
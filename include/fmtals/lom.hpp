@@ -0,0 +1,97 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Represents which object of a project owns a LOM id
+enum struct lom_owner : std::uint32_t {
+    project,
+    track,
+    return_track,
+    master_track,
+    pre_hear_track,
+    scene,
+    audio_clip,
+    clip_slot,
+};
+
+/// @brief Represents which member of the owner holds a LOM id
+enum struct lom_field : std::uint32_t {
+    lom_id,
+    lom_id_view,
+    devices_list_wrapper,
+    clip_slots_list_wrapper,
+    mixer,
+    mixer_view,
+    tracks_list_wrapper,
+    visible_tracks_list_wrapper,
+    return_tracks_list_wrapper,
+    scenes_list_wrapper,
+    cue_points_list_wrapper,
+    tempo,
+    main_sequencer,
+};
+
+/// @brief Represents the location of a LOM id inside a project. The index is the position in the
+/// tracks, return tracks or scenes of the project, and the child index is the position of the
+/// clip or clip slot inside its track. Both are set to npos when they do not apply
+struct lom_handle {
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    lom_owner owner;
+    lom_field field;
+    std::size_t index = npos;
+    std::size_t child_index = npos;
+};
+
+/// @brief Represents a flat open addressing hash map from LOM id to its location. Id 0 means no
+/// id in Ableton Live sets and is never indexed, it marks empty slots instead. Ids that are
+/// inserted more than once keep their first location and are listed in duplicate_ids
+struct lom_index {
+    std::vector<std::uint32_t> ids;
+    std::vector<lom_handle> handles;
+    std::size_t count = 0;
+    std::uint32_t max_id = 0;
+    std::vector<std::uint32_t> duplicate_ids;
+};
+
+/// @brief Clears an index and fills it with every non zero LOM id of a project
+/// @param proj
+/// @param index
+void index_lom_ids(const project& proj, lom_index& index);
+
+/// @brief Imports a project and builds its LOM id index
+/// @param stream
+/// @param proj
+/// @param ver
+/// @param index
+void import_project(std::istream& stream, project& proj, version& ver, lom_index& index);
+
+/// @brief Adds a LOM id to an index. Returns false and records the id as a duplicate when it is
+/// already indexed
+/// @param index
+/// @param id
+/// @param handle
+bool insert_lom_id(lom_index& index, const std::uint32_t id, const lom_handle& handle);
+
+/// @brief Finds the location of a LOM id in constant time. Returns nullptr when the id is not
+/// indexed
+/// @param index
+/// @param id
+const lom_handle* find_lom_id(const lom_index& index, const std::uint32_t id);
+
+/// @brief Allocates the next free LOM id, greater than every indexed id, and indexes it at the
+/// specified location. The caller stores the returned id in the owner
+/// @param index
+/// @param handle
+std::uint32_t allocate_lom_id(lom_index& index, const lom_handle& handle);
+
+/// @brief Throws an exception listing the duplicate LOM ids of an index, if any
+/// @param index
+void validate_lom_ids(const lom_index& index);
+
+}
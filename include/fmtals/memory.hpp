@@ -0,0 +1,59 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace fmtals {
+
+/// @brief Represents the heap memory owned by a project, in bytes, by subsystem. Settings holds
+/// the project itself with its strings and lists, tracks the track lists with the names, headers,
+/// routings and clip slots of every track, automation the lanes and envelopes, clips the
+/// arrangement clips with their warp markers and the session clips, scenes the scene list and plugins the plugin devices
+/// with their preset states. Interned strings are shared by every project and are not counted
+struct project_memory {
+    std::size_t settings = 0;
+    std::size_t tracks = 0;
+    std::size_t automation = 0;
+    std::size_t clips = 0;
+    std::size_t scenes = 0;
+    std::size_t plugins = 0;
+    std::size_t total = 0;
+};
+
+/// @brief Computes the memory owned by a project from the capacity of its containers
+/// @param proj
+project_memory memory_usage(const project& proj);
+
+/// @brief Represents a memory resource that counts the bytes allocated from an upstream resource
+/// and keeps their peak. An allocation that would take the count above a non zero budget throws
+/// an exception instead, so that an import or export exceeding it is aborted and its memory
+/// released before the system runs out. Counting is thread safe. Passed to import_options and
+/// export_options, it counts the document, the text, the buffers and the state of zlib and the
+/// temporaries of the call. Small temporaries such as error messages and the stacks and stream
+/// buffers of the standard library are not counted, so keep some headroom over the budget
+struct memory_counter : std::pmr::memory_resource {
+    std::pmr::memory_resource* upstream = std::pmr::new_delete_resource();
+    std::size_t budget = 0;
+    std::atomic<std::size_t> bytes = 0;
+    std::atomic<std::size_t> peak_bytes = 0;
+
+    /// @brief Sets the peak to the bytes currently allocated, so that the peak of the next call
+    /// can be read afterwards
+    void reset_peak();
+
+protected:
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t size, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+/// @brief Retrieves whether several threads can allocate from a memory resource at once: the new
+/// delete resource, a synchronized pool resource or a memory counter over one of them. Other
+/// resources, such as monotonic buffers and unsynchronized pools, are only used from one thread
+/// @param resource
+bool is_thread_safe_resource(const std::pmr::memory_resource* resource);
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Represents a file stored in a Live Pack archive. Directory offset and file number locate
+/// the entry in the central directory so that it can be read without scanning the archive again
+struct pack_member {
+    std::string name;
+    std::uint64_t size = 0;
+    std::uint64_t compressed_size = 0;
+    std::uint32_t crc = 0;
+    std::uint64_t directory_offset = 0;
+    std::uint64_t file_number = 0;
+};
+
+/// @brief Represents a Live Pack (.alp) archive listed from its central directory. Members are
+/// read from the archive on demand, nothing is extracted when the pack is opened
+struct pack {
+    std::filesystem::path path;
+    std::vector<pack_member> members;
+};
+
+/// @brief Represents a project imported from a Live Pack with the name of its member
+struct pack_project {
+    std::string name;
+    project proj;
+    version ver;
+};
+
+/// @brief Opens a Live Pack and lists its members without reading their content. Directory
+/// entries are skipped
+/// @param path
+/// @param pk
+void open_pack(const std::filesystem::path& path, pack& pk);
+
+/// @brief Streams the uncompressed content of a member. The crc is verified once the member has
+/// been read entirely
+/// @param pk
+/// @param member
+/// @param callback
+void read_pack_member(const pack& pk, const pack_member& member, const std::function<void(const char*, std::size_t)>& callback);
+
+/// @brief Opens a member as an input stream over its uncompressed content and passes it to a
+/// callback, so that it is read in chunks straight from the archive. The crc is verified once the
+/// callback returns
+/// @param pk
+/// @param member
+/// @param callback
+void stream_pack_member(const pack& pk, const pack_member& member, const std::function<void(std::istream&)>& callback);
+
+/// @brief Imports the project stored in a member and retrieves the Ableton Live version it was
+/// created with
+/// @param pk
+/// @param member
+/// @param proj
+/// @param ver
+void import_pack_member(const pack& pk, const pack_member& member, project& proj, version& ver);
+
+/// @brief Imports every .als member of a Live Pack in archive order on a number of threads, 0
+/// meaning one per hardware thread. Each thread opens the archive once and seeks to the members it
+/// imports. The capacity of the previous projects is reused
+/// @param pk
+/// @param projects
+/// @param jobs
+void import_pack_projects(const pack& pk, std::vector<pack_project>& projects, const std::size_t jobs = 0);
+
+}
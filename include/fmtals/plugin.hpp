@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Decodes the hex text of a plugin preset state, such as vst2_plugin::buffer or
+/// vst3_plugin::processor_state, into bytes. Whitespace between digit pairs is skipped and runs of
+/// digits are decoded with SIMD instructions when available. Throws when the text contains another
+/// character or an odd number of digits
+/// @param text
+/// @param state
+void decode_plugin_state(const std::string_view text, std::vector<std::uint8_t>& state);
+
+/// @brief Encodes a plugin preset state as upper case hex text in lines of 80 digits, each starting
+/// with a line feed, replacing the content of the text
+/// @param data
+/// @param size
+/// @param text
+void encode_plugin_state(const std::uint8_t* data, const std::size_t size, std::pmr::string& text);
+
+}
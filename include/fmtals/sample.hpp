@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Represents the file referenced by a SampleRef node. Paths use '/' as separator. Live 11
+/// and later store both paths as strings, older versions store them as lists of directories that
+/// are joined with the file name here. Size and crc are the values Live recorded when the sample
+/// was added and are empty when the set does not contain them
+struct sample_reference {
+    std::string path;
+    std::string relative_path;
+    std::optional<std::uint32_t> relative_path_type;
+    std::optional<std::uint64_t> file_size;
+    std::optional<std::uint32_t> crc;
+};
+
+/// @brief Extracts every sample reference of a project in document order. The compressed stream
+/// is inflated chunk by chunk and only the SampleRef fragments are parsed, the rest of the
+/// document is never bound
+/// @param stream
+std::vector<sample_reference> scan_sample_references(std::istream& stream);
+
+}
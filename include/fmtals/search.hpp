@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Represents the kind of a term of a search index. Plugins are the names of the VST2, VST3
+/// and Audio Unit plugins, samples the paths of the referenced files and sample names their file
+/// names. Tracks and scenes are the names of the tracks, including return tracks, and of the
+/// scenes. Version is the Ableton Live version the set was created with, as in 11.0.0, and creator
+/// the Creator string of the set
+enum struct search_field : std::uint32_t {
+    plugin,
+    sample,
+    sample_name,
+    track,
+    scene,
+    version,
+    creator,
+};
+
+/// @brief Represents a set of a search index. The path points into the mapped index and is valid
+/// as long as the index is open. Last write time is the value reported by the filesystem when the
+/// set was indexed and hash the hash of the content of the file
+struct search_set {
+    std::string_view path;
+    std::int64_t last_write_time = 0;
+    std::uint64_t size = 0;
+    std::uint64_t hash = 0;
+};
+
+/// @brief Represents a search index opened read only. The file is mapped in memory and queries read
+/// it in place, nothing is loaded when the index is opened. Copies share the same mapping, which is
+/// released with the last of them
+struct search_index {
+    std::filesystem::path path;
+    std::shared_ptr<const char> data;
+    std::size_t size = 0;
+};
+
+/// @brief Represents the result of a search index update. Indexed sets were read and imported,
+/// reused sets kept their terms from the previous index because their last write time and size, or
+/// their hash, did not change. Removed sets were in the previous index but not in the update.
+/// Failed sets could not be read or imported, they are listed with their error and are not part of
+/// the index
+struct search_update {
+    std::size_t indexed = 0;
+    std::size_t reused = 0;
+    std::size_t removed = 0;
+    std::vector<std::pair<std::filesystem::path, std::string>> failed;
+};
+
+/// @brief Updates the search index at a path so that it holds exactly the specified sets, creating
+/// it when it does not exist. Only new and modified sets are read, on a number of threads, 0 meaning
+/// one per hardware thread. The index file is then written to a temporary that replaces it once
+/// complete, so that an interrupted update never leaves a partial index behind
+/// @param path
+/// @param set_paths
+/// @param jobs
+search_update update_search_index(const std::filesystem::path& path, const std::vector<std::filesystem::path>& set_paths, const std::size_t jobs = 0);
+
+/// @brief Opens a search index by mapping its file in memory
+/// @param path
+/// @param index
+void open_search_index(const std::filesystem::path& path, search_index& index);
+
+/// @brief Retrieves the number of sets of a search index
+/// @param index
+std::size_t search_set_count(const search_index& index);
+
+/// @brief Retrieves a set of a search index. Sets are sorted by path
+/// @param index
+/// @param set_index
+search_set get_search_set(const search_index& index, const std::size_t set_index);
+
+/// @brief Retrieves the sorted indices of the sets containing a term. The term is found with a
+/// binary search in the sorted term table and its posting list is read from the mapped index, so
+/// the result of two queries can be combined with std::set_intersection or std::set_union
+/// @param index
+/// @param field
+/// @param term
+/// @param set_indices
+void find_search_sets(const search_index& index, const search_field field, const std::string_view term, std::vector<std::size_t>& set_indices);
+
+/// @brief Retrieves the sorted indices of the sets containing a term that starts with a prefix,
+/// such as every sample under a directory. The posting lists of the matching terms are merged
+/// @param index
+/// @param field
+/// @param prefix
+/// @param set_indices
+void find_search_sets_by_prefix(const search_index& index, const search_field field, const std::string_view prefix, std::vector<std::size_t>& set_indices);
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Represents a clip slot of the session view. The color is the Color or the ColorIndex of
+/// the clip, depending on the version of the set, and the clip index the index of the clip in the
+/// session clips of the track, both 0 for slots without a clip. Tracks without clip slots, such as
+/// group tracks, hold slots without a clip nor a stop button
+struct session_slot {
+    std::uint32_t color = 0;
+    std::uint32_t clip_index = 0;
+    bool has_clip = false;
+    bool has_stop = false;
+};
+
+/// @brief Represents the clip slots of every track and scene of a project as a dense matrix.
+/// Slots are stored scene by scene, so that the slots of a scene are contiguous and the slot of a
+/// track in a scene is at scene_index * track_count + track_index. Clip counts holds the number of
+/// clips of each scene and slot track count the number of tracks that have clip slots
+struct session_matrix {
+    std::size_t track_count = 0;
+    std::size_t scene_count = 0;
+    std::size_t slot_track_count = 0;
+    std::vector<session_slot> slots;
+    std::vector<std::size_t> clip_counts;
+};
+
+/// @brief Clears a matrix and fills it with the clip slots of a project, one row per track of the
+/// project and one column per scene. Slots beyond the scenes of the project are ignored
+/// @param proj
+/// @param matrix
+void index_session(const project& proj, session_matrix& matrix);
+
+/// @brief Finds the slot of a track in a scene in constant time. Returns nullptr when the track or
+/// the scene is out of range
+/// @param matrix
+/// @param track_index
+/// @param scene_index
+const session_slot* find_session_slot(const session_matrix& matrix, const std::size_t track_index, const std::size_t scene_index);
+
+/// @brief Retrieves the indices of the scenes where every track that has clip slots holds a clip
+/// @param matrix
+/// @param scene_indices
+void find_full_scenes(const session_matrix& matrix, std::vector<std::size_t>& scene_indices);
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Represents a track of a snapshot as two immutable nodes. The header is the track with an
+/// empty device chain, so that editing the clips of a track keeps sharing its automation lanes and
+/// plugin devices, and editing its device chain keeps sharing its clips
+template <typename T>
+struct snapshot_track {
+    std::shared_ptr<const T> header;
+    std::shared_ptr<const project::device_chain> device_chain;
+};
+
+/// @brief Represents a project as a tree of immutable nodes shared between snapshots. Settings is
+/// the project without its tracks and scenes. Copying a snapshot only copies pointers, so an edit
+/// copies the snapshot, replaces the nodes it changes with edit_snapshot_node and shares every other
+/// node with the previous snapshot, which makes an undo history cost the size of the edits. Nodes
+/// are never modified once shared, readers holding a snapshot never observe a later edit and
+/// threads may publish and read snapshots through std::atomic_load and std::atomic_store of a
+/// std::shared_ptr<const project_snapshot>. Nodes made from a project keep allocating from its
+/// memory resource, which must outlive them, edited copies allocate from the default one
+struct project_snapshot {
+    std::shared_ptr<const project> settings;
+    std::vector<snapshot_track<project::user_track>> tracks;
+    std::vector<snapshot_track<project::return_track>> return_tracks;
+    snapshot_track<project::master_track> master_track;
+    snapshot_track<project::pre_hear_track> pre_hear_track;
+    std::vector<std::shared_ptr<const project::scene>> scenes;
+};
+
+/// @brief Splits a project into the nodes of a snapshot. The project is taken by value, so that
+/// moving a project that is no longer needed into the snapshot does not copy it
+/// @param proj
+/// @param snapshot
+void make_project_snapshot(project proj, project_snapshot& snapshot);
+
+/// @brief Rebuilds a project from the nodes of a snapshot, replacing its previous content
+/// @param snapshot
+/// @param proj
+void load_project_snapshot(const project_snapshot& snapshot, project& proj);
+
+/// @brief Rebuilds a project from a snapshot and exports it for a specified Ableton Live version
+/// @param stream
+/// @param snapshot
+/// @param ver
+void export_project_snapshot(std::ostream& stream, const project_snapshot& snapshot, const version& ver);
+
+/// @brief Replaces a node with an edited copy of it. Other snapshots sharing the node keep the
+/// original, the copy is owned by the snapshot holding the pointer until it is shared in turn
+/// @param node
+/// @param edit called with a mutable reference to the copy
+template <typename T, typename Edit>
+void edit_snapshot_node(std::shared_ptr<const T>& node, Edit&& edit)
+{
+    std::shared_ptr<T> _copy = std::make_shared<T>(*node);
+    std::forward<Edit>(edit)(*_copy);
+    node = std::move(_copy);
+}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Stores a project inside a content-addressed directory. The project is split into chunks
+/// (global settings, scene list, and the header and device chain of every track) that are written
+/// once per unique content, so revisions sharing tracks or device chains only add what changed.
+/// Chunks that already exist are read back and compared, throws on a hash collision. Returns the
+/// revision id that identifies the stored project
+/// @param directory
+/// @param proj
+/// @param ver
+std::string store_project(const std::filesystem::path& directory, const project& proj, const version& ver);
+
+/// @brief Rebuilds a stored revision from its chunks and retrieves the version it was stored with.
+/// Throws when the revision is not an id returned by store_project
+/// @param directory
+/// @param revision
+/// @param proj
+/// @param ver
+void load_stored_project(const std::filesystem::path& directory, const std::string& revision, project& proj, version& ver);
+
+/// @brief Rebuilds a stored revision and exports it for a specified Ableton Live version
+/// @param stream
+/// @param directory
+/// @param revision
+/// @param ver
+void export_stored_project(std::ostream& stream, const std::filesystem::path& directory, const std::string& revision, const version& ver);
+
+/// @brief Lists the revision ids available in a store
+/// @param directory
+std::vector<std::string> list_stored_projects(const std::filesystem::path& directory);
+
+}
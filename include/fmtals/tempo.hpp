@@ -0,0 +1,58 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Represents a part of the arrangement where the tempo changes linearly with the beat
+/// position, as Ableton Live interpolates between two points of the tempo envelope. The tempo is
+/// in beats per minute and the slope in beats per minute per beat
+struct tempo_segment {
+    double beat = 0;
+    double second = 0;
+    double tempo = 0;
+    double slope = 0;
+};
+
+/// @brief Represents the tempo of the master track over the arrangement as segments sorted by
+/// beat, with the seconds elapsed since beat 0 precomputed at the start of each one. The tempo is
+/// held constant before the first segment and the last segment extends to the end of the
+/// arrangement. A segment starts at beat 0 whenever the envelope starts before it
+struct tempo_map {
+    std::vector<tempo_segment> segments;
+};
+
+/// @brief Builds the tempo map of a project from the tempo of its master track and the
+/// automation envelope that targets it, if any. Throws an exception on a tempo that is not
+/// positive
+/// @param proj
+/// @param map
+void build_tempo_map(const project& proj, tempo_map& map);
+
+/// @brief Converts an arrangement position in beats to seconds in logarithmic time
+/// @param map
+/// @param beat
+double beats_to_seconds(const tempo_map& map, const double beat);
+
+/// @brief Converts a time in seconds to an arrangement position in beats in logarithmic time
+/// @param map
+/// @param second
+double seconds_to_beats(const tempo_map& map, const double second);
+
+/// @brief Converts arrangement positions in beats to seconds. Each search starts from the segment
+/// of the previous position, so sorted positions are converted in a single pass over the map
+/// @param map
+/// @param beats
+/// @param seconds
+void beats_to_seconds(const tempo_map& map, const std::vector<double>& beats, std::vector<double>& seconds);
+
+/// @brief Converts times in seconds to arrangement positions in beats. Each search starts from
+/// the segment of the previous time, so sorted times are converted in a single pass over the map
+/// @param map
+/// @param seconds
+/// @param beats
+void seconds_to_beats(const tempo_map& map, const std::vector<double>& seconds, std::vector<double>& beats);
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace fmtals {
+
+/// @brief Represents the arrangement interval of a clip, in beats. A clip plays from its start
+/// included to its end excluded. The track index is the position of the track in the tracks of
+/// the project and the clip index is the position of the clip inside its track
+struct timeline_clip {
+    double start = 0;
+    double end = 0;
+    std::size_t track_index = 0;
+    std::size_t clip_index = 0;
+};
+
+/// @brief Represents an implicit interval tree over the arrangement clips of every track. The
+/// clips are sorted by start and read as the in order traversal of a complete binary tree, where
+/// max_ends holds the greatest end of the subtree rooted at each clip. Positions maps the clips of
+/// each track, from track_offsets, to their position in the sorted clips
+struct timeline_index {
+    std::vector<timeline_clip> clips;
+    std::vector<double> max_ends;
+    std::vector<std::size_t> track_offsets;
+    std::vector<std::size_t> positions;
+    std::size_t max_level = 0;
+};
+
+/// @brief Clears an index and fills it with the arrangement clips of every track of a project.
+/// Only audio clips are indexed, as imported from the AudioClip events of the audio tracks
+/// @param proj
+/// @param index
+void index_timeline(const project& proj, timeline_index& index);
+
+/// @brief Updates an index after a clip of a project has been moved or resized. Only the clips
+/// between its previous and its new position are shifted and only the subtree ends covering them
+/// are recomputed. Clips that are added or removed require to index the project again
+/// @param index
+/// @param proj
+/// @param track_index
+/// @param clip_index
+void move_timeline_clip(timeline_index& index, const project& proj, const std::size_t track_index, const std::size_t clip_index);
+
+/// @brief Retrieves the clips playing at a time, in beats, sorted by start
+/// @param index
+/// @param time
+/// @param clips
+void find_timeline_clips(const timeline_index& index, const double time, std::vector<timeline_clip>& clips);
+
+/// @brief Retrieves the clips overlapping a time range, in beats, sorted by start. The range
+/// includes its start and excludes its end
+/// @param index
+/// @param start
+/// @param end
+/// @param clips
+void find_timeline_clips(const timeline_index& index, const double start, const double end, std::vector<timeline_clip>& clips);
+
+}
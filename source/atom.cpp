@@ -0,0 +1,153 @@
+#include <fmtals/atom.hpp>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+// Strings live in chunks that are allocated once and never move, chunk k holding 256 << k
+// entries. Lookups only take the mutex when interning or releasing, atom_string reads the chunks
+// directly. Released entries are reused by the next strings interned.
+
+struct atom_entry {
+    std::string string;
+    std::atomic<std::uint32_t> references = 0;
+    bool live = false;
+};
+
+struct atom_table {
+    std::mutex mutex;
+    std::unordered_map<std::string_view, std::uint32_t> indices;
+    std::vector<std::uint32_t> free_indices;
+    std::array<std::atomic<atom_entry*>, 24> chunks = {};
+    std::atomic<std::uint32_t> size = 0;
+    std::atomic<std::uint32_t> count = 0;
+
+    atom_table()
+    {
+        chunks[0].store(new atom_entry[256], std::memory_order_release);
+        chunks[0].load(std::memory_order_relaxed)[0].live = true;
+        indices.emplace(std::string_view(), 0);
+        size.store(1, std::memory_order_release);
+        count.store(1, std::memory_order_release);
+    }
+};
+
+/// @brief Retrieves the table. It is never destroyed so that atoms with static storage duration
+/// can still release their strings at exit
+static atom_table& get_atom_table()
+{
+    static atom_table* _table = new atom_table();
+    return *_table;
+}
+
+static std::size_t atom_chunk(std::uint32_t& index)
+{
+    std::size_t _chunk = 0;
+    std::uint64_t _size = 256;
+    while (index >= _size) {
+        index -= static_cast<std::uint32_t>(_size);
+        _size <<= 1;
+        ++_chunk;
+    }
+    return _chunk;
+}
+
+static atom_entry& atom_get_entry(atom_table& table, const std::uint32_t index)
+{
+    std::uint32_t _offset = index;
+    const std::size_t _chunk = atom_chunk(_offset);
+    return table.chunks[_chunk].load(std::memory_order_acquire)[_offset];
+}
+
+namespace fmtals {
+
+atom::operator const std::string&() const
+{
+    return atom_string(*this);
+}
+
+void atom::retain() const
+{
+    if (index) {
+        atom_get_entry(get_atom_table(), index).references.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void atom::release() const
+{
+    if (!index) {
+        return;
+    }
+    atom_table& _table = get_atom_table();
+    atom_entry& _entry = atom_get_entry(_table, index);
+    if (_entry.references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    // make_atom may have revived the entry or released and reused it before the lock is taken
+    std::lock_guard<std::mutex> _lock(_table.mutex);
+    if (!_entry.live || _entry.references.load(std::memory_order_acquire) != 0) {
+        return;
+    }
+    _table.indices.erase(_entry.string);
+    _entry.live = false;
+    _entry.string.clear();
+    _entry.string.shrink_to_fit();
+    _table.free_indices.push_back(index);
+    _table.count.fetch_sub(1, std::memory_order_release);
+}
+
+atom make_atom(const std::string_view str)
+{
+    atom_table& _table = get_atom_table();
+    std::lock_guard<std::mutex> _lock(_table.mutex);
+    atom _atom;
+    const std::unordered_map<std::string_view, std::uint32_t>::const_iterator _found = _table.indices.find(str);
+    if (_found != _table.indices.end()) {
+        _atom.index = _found->second;
+        _atom.retain();
+        return _atom;
+    }
+    std::uint32_t _index;
+    if (!_table.free_indices.empty()) {
+        _index = _table.free_indices.back();
+        _table.free_indices.pop_back();
+    } else {
+        _index = _table.size.load(std::memory_order_relaxed);
+        std::uint32_t _offset = _index;
+        const std::size_t _chunk = atom_chunk(_offset);
+        if (_chunk >= _table.chunks.size()) {
+            throw std::runtime_error("Atom table is full");
+        }
+        if (_offset == 0) {
+            _table.chunks[_chunk].store(new atom_entry[std::size_t(256) << _chunk], std::memory_order_release);
+        }
+        _table.size.store(_index + 1, std::memory_order_release);
+    }
+    atom_entry& _entry = atom_get_entry(_table, _index);
+    _entry.string.assign(str.data(), str.size());
+    _entry.references.store(1, std::memory_order_relaxed);
+    _entry.live = true;
+    _table.indices.emplace(_entry.string, _index);
+    _table.count.fetch_add(1, std::memory_order_release);
+    _atom.index = _index;
+    return _atom;
+}
+
+const std::string& atom_string(const atom& value)
+{
+    atom_table& _table = get_atom_table();
+    if (value.index >= _table.size.load(std::memory_order_acquire)) {
+        throw std::out_of_range("Invalid atom");
+    }
+    return atom_get_entry(_table, value.index).string;
+}
+
+std::size_t atom_count()
+{
+    return get_atom_table().count.load(std::memory_order_acquire);
+}
+
+}
@@ -0,0 +1,619 @@
+#include <fmtals/atom.hpp>
+#include <fmtals/corpus.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+
+#include "mapping.hpp"
+
+// a dataset is a directory holding one file per column with the values of every row, the string
+// dictionary as a file of the end offset of every string and a file of their characters, and a
+// manifest with the header, the column records and their names. Values are in host byte order.
+// Appends add to the end of the files and commit by replacing the manifest, so the files may end
+// with bytes of an interrupted append past the sizes of the manifest, which are ignored by readers
+// and dropped by the next append
+
+struct corpus_header {
+    char magic[8];
+    std::uint32_t format;
+    std::uint32_t reserved;
+    std::uint64_t string_count;
+    std::uint64_t string_data_size;
+    std::uint64_t row_counts[5];
+    std::uint64_t column_count;
+    std::uint64_t names_size;
+};
+
+struct corpus_column_record {
+    std::uint32_t table;
+    std::uint32_t type;
+    std::uint64_t name_offset;
+    std::uint64_t name_size;
+    std::uint64_t row_count;
+};
+
+static constexpr char corpus_magic[8] = { 'F', 'M', 'T', 'A', 'L', 'S', 'C', 'O' };
+static constexpr std::uint32_t corpus_format = 3;
+static constexpr std::size_t corpus_table_count = 5;
+static constexpr const char* corpus_table_names[corpus_table_count] = { "project", "track", "automation_lane", "scene", "audio_clip" };
+static constexpr const char* corpus_manifest_name = "manifest";
+static constexpr const char* corpus_string_offsets_name = "strings.offsets";
+static constexpr const char* corpus_string_data_name = "strings.data";
+
+/// @brief Represents a column of the schema. Columns named project_id and track_id hold rows of
+/// the project and track tables and are rebased when appended
+struct corpus_descriptor {
+    fmtals::corpus_table table;
+    const char* name;
+    fmtals::corpus_type type;
+};
+
+static constexpr corpus_descriptor corpus_schema[] = {
+    { fmtals::corpus_table::project, "name", fmtals::corpus_type::string },
+    { fmtals::corpus_table::project, "version", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::project, "creator", fmtals::corpus_type::string },
+    { fmtals::corpus_table::project, "minor_version", fmtals::corpus_type::string },
+    { fmtals::corpus_table::project, "tempo", fmtals::corpus_type::float32 },
+    { fmtals::corpus_table::project, "scale_name", fmtals::corpus_type::string },
+    { fmtals::corpus_table::project, "scale_root_note", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "project_id", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "index", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "kind", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "id", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "lom_id", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "effective_name", fmtals::corpus_type::string },
+    { fmtals::corpus_table::track, "user_name", fmtals::corpus_type::string },
+    { fmtals::corpus_table::track, "annotation", fmtals::corpus_type::string },
+    { fmtals::corpus_table::track, "has_color", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::track, "color", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "has_color_index", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::track, "color_index", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "track_group_id", fmtals::corpus_type::int32 },
+    { fmtals::corpus_table::track, "track_unfolded", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::track, "track_delay_value", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "audio_output_routing_target", fmtals::corpus_type::string },
+    { fmtals::corpus_table::track, "automation_envelope_count", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "automation_event_count", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "plugin_device_count", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "session_clip_count", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::track, "freeze", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::automation_lane, "project_id", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::automation_lane, "track_id", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::automation_lane, "index", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::automation_lane, "selected_device", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::automation_lane, "selected_envelope", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::automation_lane, "is_content_selected", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::automation_lane, "lane_height", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::automation_lane, "fade_view_visible", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::scene, "project_id", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::scene, "index", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::scene, "name", fmtals::corpus_type::string },
+    { fmtals::corpus_table::scene, "annotation", fmtals::corpus_type::string },
+    { fmtals::corpus_table::scene, "color_index", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::scene, "lom_id", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::audio_clip, "project_id", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::audio_clip, "track_id", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::audio_clip, "index", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::audio_clip, "time", fmtals::corpus_type::float32 },
+    { fmtals::corpus_table::audio_clip, "current_start", fmtals::corpus_type::float32 },
+    { fmtals::corpus_table::audio_clip, "current_end", fmtals::corpus_type::float32 },
+    { fmtals::corpus_table::audio_clip, "loop_start", fmtals::corpus_type::float32 },
+    { fmtals::corpus_table::audio_clip, "loop_end", fmtals::corpus_type::float32 },
+    { fmtals::corpus_table::audio_clip, "loop_on", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::audio_clip, "name", fmtals::corpus_type::string },
+    { fmtals::corpus_table::audio_clip, "has_color", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::audio_clip, "color", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::audio_clip, "has_color_index", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::audio_clip, "color_index", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::audio_clip, "launch_mode", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::audio_clip, "launch_quantisation", fmtals::corpus_type::uint32 },
+    { fmtals::corpus_table::audio_clip, "legato", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::audio_clip, "ram", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::audio_clip, "disabled", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::audio_clip, "velocity_amount", fmtals::corpus_type::float32 },
+    { fmtals::corpus_table::audio_clip, "is_warped", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::audio_clip, "is_song_tempo_master", fmtals::corpus_type::boolean },
+    { fmtals::corpus_table::audio_clip, "warp_marker_count", fmtals::corpus_type::uint32 },
+};
+
+static constexpr std::size_t corpus_column_count = sizeof(corpus_schema) / sizeof(corpus_descriptor);
+
+static std::size_t corpus_type_size(const fmtals::corpus_type type)
+{
+    return type == fmtals::corpus_type::boolean ? 1 : 4;
+}
+
+/// @brief Retrieves the name of the file of a column of the schema, such as track.project_id
+static std::string corpus_column_file_name(const std::size_t column_index)
+{
+    return std::string(corpus_table_names[static_cast<std::size_t>(corpus_schema[column_index].table)]) + '.' + corpus_schema[column_index].name;
+}
+
+// rows
+
+/// @brief Represents the row being added to a table, values are pushed in the order of the schema
+struct corpus_row {
+    fmtals::corpus_builder& builder;
+    fmtals::corpus_table table;
+    std::size_t column;
+};
+
+static corpus_row corpus_begin_row(fmtals::corpus_builder& builder, const fmtals::corpus_table table)
+{
+    std::size_t _column = 0;
+    while (_column < corpus_column_count && corpus_schema[_column].table != table) {
+        ++_column;
+    }
+    ++builder.row_counts[static_cast<std::size_t>(table)];
+    return corpus_row { builder, table, _column };
+}
+
+static void corpus_push_bytes(corpus_row& row, const char* name, const fmtals::corpus_type type, const void* value)
+{
+    if (row.column >= row.builder.columns.size()) {
+        throw std::logic_error(std::string("Corpus column out of schema: ") + name);
+    }
+    fmtals::corpus_builder_column& _column = row.builder.columns[row.column++];
+    if (_column.table != row.table || _column.type != type || _column.name != name) {
+        throw std::logic_error(std::string("Corpus column out of schema: ") + name);
+    }
+    const std::uint8_t* _bytes = static_cast<const std::uint8_t*>(value);
+    _column.data.insert(_column.data.end(), _bytes, _bytes + corpus_type_size(type));
+}
+
+static void corpus_push(corpus_row& row, const char* name, const bool value)
+{
+    const std::uint8_t _value = value ? 1 : 0;
+    corpus_push_bytes(row, name, fmtals::corpus_type::boolean, &_value);
+}
+
+static void corpus_push(corpus_row& row, const char* name, const std::int32_t value)
+{
+    corpus_push_bytes(row, name, fmtals::corpus_type::int32, &value);
+}
+
+static void corpus_push(corpus_row& row, const char* name, const std::uint32_t value)
+{
+    corpus_push_bytes(row, name, fmtals::corpus_type::uint32, &value);
+}
+
+static void corpus_push(corpus_row& row, const char* name, const float value)
+{
+    corpus_push_bytes(row, name, fmtals::corpus_type::float32, &value);
+}
+
+static void corpus_push(corpus_row& row, const char* name, const std::string_view value)
+{
+    const std::pair<std::unordered_map<std::string, std::uint32_t>::iterator, bool> _code = row.builder.string_codes.try_emplace(std::string(value), static_cast<std::uint32_t>(row.builder.strings.size()));
+    if (_code.second) {
+        row.builder.strings.emplace_back(value);
+    }
+    corpus_push_bytes(row, name, fmtals::corpus_type::string, &_code.first->second);
+}
+
+static void corpus_push(corpus_row& row, const char* has_name, const char* name, const std::optional<std::uint32_t>& value)
+{
+    corpus_push(row, has_name, value.has_value());
+    corpus_push(row, name, value.value_or(0));
+}
+
+template <typename T>
+static void corpus_add_track(fmtals::corpus_builder& builder, const std::uint32_t project_id, const std::uint32_t index, const std::uint32_t kind, const T& track)
+{
+    const std::uint32_t _track_id = static_cast<std::uint32_t>(builder.row_counts[static_cast<std::size_t>(fmtals::corpus_table::track)]);
+    std::size_t _event_count = 0;
+    for (const fmtals::project::automation_envelope& _envelope : track.automation_envelopes) {
+        _event_count += _envelope.events.size();
+    }
+    std::uint32_t _session_clip_count = 0;
+    bool _freeze = false;
+    if constexpr (std::is_base_of_v<fmtals::project::editable_track, T>) {
+        for (const fmtals::project::clip_slot& _slot : track.clip_slots) {
+            _session_clip_count += _slot.has_clip ? 1 : 0;
+        }
+        _freeze = track.freeze;
+    }
+    corpus_row _row = corpus_begin_row(builder, fmtals::corpus_table::track);
+    corpus_push(_row, "project_id", project_id);
+    corpus_push(_row, "index", index);
+    corpus_push(_row, "kind", kind);
+    corpus_push(_row, "id", track.id);
+    corpus_push(_row, "lom_id", track.lom_id);
+    corpus_push(_row, "effective_name", std::string_view(fmtals::atom_string(track.effective_name)));
+    corpus_push(_row, "user_name", std::string_view(track.user_name));
+    corpus_push(_row, "annotation", std::string_view(track.annotation));
+    corpus_push(_row, "has_color", "color", track.color);
+    corpus_push(_row, "has_color_index", "color_index", track.color_index);
+    corpus_push(_row, "track_group_id", track.track_group_id);
+    corpus_push(_row, "track_unfolded", track.track_unfolded);
+    corpus_push(_row, "track_delay_value", track.track_delay_value);
+    corpus_push(_row, "audio_output_routing_target", std::string_view(fmtals::atom_string(track.audio_output_routing_target)));
+    corpus_push(_row, "automation_envelope_count", static_cast<std::uint32_t>(track.automation_envelopes.size()));
+    corpus_push(_row, "automation_event_count", static_cast<std::uint32_t>(_event_count));
+    corpus_push(_row, "plugin_device_count", static_cast<std::uint32_t>(track.plugin_devices.size()));
+    corpus_push(_row, "session_clip_count", _session_clip_count);
+    corpus_push(_row, "freeze", _freeze);
+
+    for (std::size_t _index = 0; _index < track.automation_lanes.size(); ++_index) {
+        const fmtals::project::automation_lane& _lane = track.automation_lanes[_index];
+        corpus_row _lane_row = corpus_begin_row(builder, fmtals::corpus_table::automation_lane);
+        corpus_push(_lane_row, "project_id", project_id);
+        corpus_push(_lane_row, "track_id", _track_id);
+        corpus_push(_lane_row, "index", static_cast<std::uint32_t>(_index));
+        corpus_push(_lane_row, "selected_device", _lane.selected_device);
+        corpus_push(_lane_row, "selected_envelope", _lane.selected_envelope);
+        corpus_push(_lane_row, "is_content_selected", _lane.is_content_selected);
+        corpus_push(_lane_row, "lane_height", _lane.lane_height);
+        corpus_push(_lane_row, "fade_view_visible", _lane.fade_view_visible);
+    }
+
+    if constexpr (std::is_same_v<T, fmtals::project::audio_track>) {
+        for (std::size_t _index = 0; _index < track.events_audio_clips.size(); ++_index) {
+            const fmtals::project::audio_clip& _clip = track.events_audio_clips[_index];
+            corpus_row _clip_row = corpus_begin_row(builder, fmtals::corpus_table::audio_clip);
+            corpus_push(_clip_row, "project_id", project_id);
+            corpus_push(_clip_row, "track_id", _track_id);
+            corpus_push(_clip_row, "index", static_cast<std::uint32_t>(_index));
+            corpus_push(_clip_row, "time", static_cast<float>(_clip.time));
+            corpus_push(_clip_row, "current_start", _clip.current_start);
+            corpus_push(_clip_row, "current_end", _clip.current_end);
+            corpus_push(_clip_row, "loop_start", _clip.loop_start);
+            corpus_push(_clip_row, "loop_end", _clip.loop_end);
+            corpus_push(_clip_row, "loop_on", _clip.loop_on);
+            corpus_push(_clip_row, "name", std::string_view(_clip.name));
+            corpus_push(_clip_row, "has_color", "color", _clip.color);
+            corpus_push(_clip_row, "has_color_index", "color_index", _clip.color_index);
+            corpus_push(_clip_row, "launch_mode", _clip.launch_mode);
+            corpus_push(_clip_row, "launch_quantisation", _clip.launch_quantisation);
+            corpus_push(_clip_row, "legato", _clip.legato);
+            corpus_push(_clip_row, "ram", _clip.ram);
+            corpus_push(_clip_row, "disabled", _clip.disabled);
+            corpus_push(_clip_row, "velocity_amount", _clip.velocity_amount);
+            corpus_push(_clip_row, "is_warped", _clip.is_warped);
+            corpus_push(_clip_row, "is_song_tempo_master", _clip.is_song_tempo_master);
+            corpus_push(_clip_row, "warp_marker_count", static_cast<std::uint32_t>(_clip.warp_markers.size()));
+        }
+    }
+}
+
+// reading
+
+template <typename T>
+static T corpus_read(const char* data, const std::uint64_t offset)
+{
+    T _value;
+    std::memcpy(&_value, data + offset, sizeof(T));
+    return _value;
+}
+
+static corpus_header corpus_get_header(const fmtals::corpus_dataset& dataset)
+{
+    if (!dataset.manifest) {
+        throw std::runtime_error("Corpus dataset is not open");
+    }
+    return corpus_read<corpus_header>(dataset.manifest.get(), 0);
+}
+
+static corpus_column_record corpus_get_record(const fmtals::corpus_dataset& dataset, const std::size_t column_index)
+{
+    return corpus_read<corpus_column_record>(dataset.manifest.get(), sizeof(corpus_header) + column_index * sizeof(corpus_column_record));
+}
+
+static fmtals::corpus_column corpus_get_column(const fmtals::corpus_dataset& dataset, const corpus_header& header, const std::size_t column_index)
+{
+    const corpus_column_record _record = corpus_get_record(dataset, column_index);
+    const std::uint64_t _names_offset = sizeof(corpus_header) + header.column_count * sizeof(corpus_column_record);
+    fmtals::corpus_column _column;
+    _column.table = static_cast<fmtals::corpus_table>(_record.table);
+    _column.name = std::string_view(dataset.manifest.get() + _names_offset + _record.name_offset, static_cast<std::size_t>(_record.name_size));
+    _column.type = static_cast<fmtals::corpus_type>(_record.type);
+    _column.data = dataset.columns[column_index].get();
+    _column.row_count = static_cast<std::size_t>(_record.row_count);
+    return _column;
+}
+
+/// @brief Maps a file of a dataset when the manifest says it holds data and checks that it holds
+/// at least that many bytes. Files without data are not mapped and may not exist
+static std::shared_ptr<const char> corpus_map_file(const std::filesystem::path& path, const std::uint64_t size)
+{
+    if (size == 0) {
+        return nullptr;
+    }
+    std::size_t _size = 0;
+    std::shared_ptr<const char> _data = map_file(path, _size);
+    if (_size < size) {
+        throw std::runtime_error("Truncated corpus dataset file: " + path.string());
+    }
+    return _data;
+}
+
+// writing
+
+template <typename T>
+static void corpus_write(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void corpus_write_bytes(std::ostream& stream, const void* data, const std::size_t size)
+{
+    stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+/// @brief Appends to a file of a dataset after dropping the bytes past its size in the manifest
+/// that an interrupted append may have left
+static void corpus_append_file(const std::filesystem::path& path, const std::uint64_t size, const std::function<void(std::ostream&)>& callback)
+{
+    if (std::filesystem::exists(path)) {
+        std::filesystem::resize_file(path, size);
+    } else if (size != 0) {
+        throw std::runtime_error("Missing corpus dataset file: " + path.string());
+    }
+    std::ofstream _stream(path, std::ios::binary | std::ios::app);
+    callback(_stream);
+    _stream.flush();
+    if (!_stream) {
+        throw std::runtime_error("Failed to write to file: " + path.string());
+    }
+}
+
+/// @brief Writes the new values of a column, translating string codes of the builder into codes
+/// of the dataset and rebasing project and track ids after the rows of the previous dataset
+static void corpus_write_values(std::ostream& stream, const fmtals::corpus_builder_column& column, const std::vector<std::uint32_t>& string_codes, const std::uint64_t (&previous_row_counts)[corpus_table_count])
+{
+    std::uint32_t _base = 0;
+    if (column.name == "project_id") {
+        _base = static_cast<std::uint32_t>(previous_row_counts[static_cast<std::size_t>(fmtals::corpus_table::project)]);
+    } else if (column.name == "track_id") {
+        _base = static_cast<std::uint32_t>(previous_row_counts[static_cast<std::size_t>(fmtals::corpus_table::track)]);
+    }
+    if (column.type != fmtals::corpus_type::string && _base == 0) {
+        corpus_write_bytes(stream, column.data.data(), column.data.size());
+        return;
+    }
+    std::vector<std::uint32_t> _values(column.data.size() / sizeof(std::uint32_t));
+    std::memcpy(_values.data(), column.data.data(), _values.size() * sizeof(std::uint32_t));
+    for (std::uint32_t& _value : _values) {
+        _value = column.type == fmtals::corpus_type::string ? string_codes[_value] : _value + _base;
+    }
+    corpus_write_bytes(stream, _values.data(), _values.size() * sizeof(std::uint32_t));
+}
+
+namespace fmtals {
+
+void add_corpus_project(corpus_builder& builder, const project& proj, const version& ver, const std::string_view name)
+{
+    if (builder.columns.empty()) {
+        builder.columns.reserve(corpus_column_count);
+        for (const corpus_descriptor& _descriptor : corpus_schema) {
+            builder.columns.push_back(corpus_builder_column { _descriptor.table, _descriptor.name, _descriptor.type, {} });
+        }
+    }
+    const std::uint32_t _project_id = static_cast<std::uint32_t>(builder.row_counts[static_cast<std::size_t>(corpus_table::project)]);
+    corpus_row _row = corpus_begin_row(builder, corpus_table::project);
+    corpus_push(_row, "name", name);
+    corpus_push(_row, "version", static_cast<std::uint32_t>(ver));
+    corpus_push(_row, "creator", std::string_view(proj.creator));
+    corpus_push(_row, "minor_version", std::string_view(proj.minor_version));
+    corpus_push(_row, "tempo", proj.project_master_track.tempo);
+    corpus_push(_row, "scale_name", std::string_view(atom_string(proj.scale_information_name)));
+    corpus_push(_row, "scale_root_note", proj.scale_information_root_note);
+
+    std::uint32_t _index = 0;
+    for (const project::user_track& _track : proj.tracks) {
+        std::visit([&](const auto& _track_visit) { corpus_add_track(builder, _project_id, _index, static_cast<std::uint32_t>(_track.index()), _track_visit); }, _track);
+        ++_index;
+    }
+    for (const project::return_track& _track : proj.return_tracks) {
+        corpus_add_track(builder, _project_id, _index++, 3, _track);
+    }
+    corpus_add_track(builder, _project_id, _index, 4, proj.project_master_track);
+
+    for (std::size_t _scene_index = 0; _scene_index < proj.scene_names.size(); ++_scene_index) {
+        const project::scene& _scene = proj.scene_names[_scene_index];
+        corpus_row _scene_row = corpus_begin_row(builder, corpus_table::scene);
+        corpus_push(_scene_row, "project_id", _project_id);
+        corpus_push(_scene_row, "index", static_cast<std::uint32_t>(_scene_index));
+        corpus_push(_scene_row, "name", std::string_view(_scene.value));
+        corpus_push(_scene_row, "annotation", std::string_view(_scene.annotation));
+        corpus_push(_scene_row, "color_index", _scene.color_index);
+        corpus_push(_scene_row, "lom_id", _scene.lom_id);
+    }
+}
+
+void append_corpus_dataset(const std::filesystem::path& path, const corpus_builder& builder)
+{
+    if (!builder.columns.empty() && builder.columns.size() != corpus_column_count) {
+        throw std::runtime_error("Invalid corpus builder");
+    }
+    corpus_header _previous_header {};
+    std::vector<std::uint32_t> _string_codes(builder.strings.size());
+    std::vector<const std::string*> _new_strings;
+    {
+        corpus_dataset _previous;
+        if (std::filesystem::exists(path / corpus_manifest_name)) {
+            open_corpus_dataset(path, _previous);
+            _previous_header = corpus_get_header(_previous);
+            bool _same_schema = _previous_header.column_count == corpus_column_count;
+            for (std::size_t _column_index = 0; _same_schema && _column_index < corpus_column_count; ++_column_index) {
+                const corpus_column _column = corpus_get_column(_previous, _previous_header, _column_index);
+                _same_schema = _column.table == corpus_schema[_column_index].table && _column.type == corpus_schema[_column_index].type && _column.name == corpus_schema[_column_index].name;
+            }
+            if (!_same_schema) {
+                throw std::runtime_error("Unsupported corpus dataset schema: " + path.string());
+            }
+        } else if (std::filesystem::exists(path) && !std::filesystem::is_directory(path)) {
+            throw std::runtime_error("Unsupported corpus dataset format: " + path.string());
+        }
+
+        // the dictionary keeps the previous codes and adds the strings it does not hold yet. The
+        // previous dataset is closed before its files are appended to
+        std::unordered_map<std::string_view, std::uint32_t> _codes;
+        _codes.reserve(static_cast<std::size_t>(_previous_header.string_count) + builder.strings.size());
+        for (std::uint64_t _code = 0; _code < _previous_header.string_count; ++_code) {
+            _codes.emplace(get_corpus_string(_previous, static_cast<std::uint32_t>(_code)), static_cast<std::uint32_t>(_code));
+        }
+        for (std::size_t _index = 0; _index < builder.strings.size(); ++_index) {
+            const std::pair<std::unordered_map<std::string_view, std::uint32_t>::iterator, bool> _code = _codes.try_emplace(builder.strings[_index], static_cast<std::uint32_t>(_codes.size()));
+            if (_code.second) {
+                _new_strings.push_back(&builder.strings[_index]);
+            }
+            _string_codes[_index] = _code.first->second;
+        }
+    }
+
+    // only the new rows and strings are written, at the end of the files of the dataset
+    std::filesystem::create_directories(path);
+    corpus_header _header {};
+    std::memcpy(_header.magic, corpus_magic, sizeof(corpus_magic));
+    _header.format = corpus_format;
+    _header.string_count = _previous_header.string_count + _new_strings.size();
+    _header.string_data_size = _previous_header.string_data_size;
+    for (std::size_t _table = 0; _table < corpus_table_count; ++_table) {
+        _header.row_counts[_table] = _previous_header.row_counts[_table] + builder.row_counts[_table];
+    }
+    _header.column_count = corpus_column_count;
+    std::vector<corpus_column_record> _records(corpus_column_count);
+    std::string _names;
+    for (std::size_t _column_index = 0; _column_index < corpus_column_count; ++_column_index) {
+        const std::size_t _table = static_cast<std::size_t>(corpus_schema[_column_index].table);
+        const std::uint64_t _type_size = corpus_type_size(corpus_schema[_column_index].type);
+        corpus_column_record& _record = _records[_column_index];
+        _record.table = static_cast<std::uint32_t>(_table);
+        _record.type = static_cast<std::uint32_t>(corpus_schema[_column_index].type);
+        _record.name_offset = _names.size();
+        _record.name_size = std::strlen(corpus_schema[_column_index].name);
+        _record.row_count = _header.row_counts[_table];
+        _names += corpus_schema[_column_index].name;
+        corpus_append_file(path / corpus_column_file_name(_column_index), _previous_header.row_counts[_table] * _type_size, [&](std::ostream& stream) {
+            if (!builder.columns.empty()) {
+                corpus_write_values(stream, builder.columns[_column_index], _string_codes, _previous_header.row_counts);
+            }
+        });
+    }
+    _header.names_size = _names.size();
+    corpus_append_file(path / corpus_string_data_name, _previous_header.string_data_size, [&](std::ostream& stream) {
+        for (const std::string* _string : _new_strings) {
+            corpus_write_bytes(stream, _string->data(), _string->size());
+        }
+    });
+    corpus_append_file(path / corpus_string_offsets_name, _previous_header.string_count * sizeof(std::uint64_t), [&](std::ostream& stream) {
+        for (const std::string* _string : _new_strings) {
+            _header.string_data_size += _string->size();
+            corpus_write(stream, _header.string_data_size);
+        }
+    });
+
+    // the manifest is replaced last, so that readers and interrupted appends only ever see a
+    // complete dataset
+    write_file_atomically(path / corpus_manifest_name, [&](std::ostream& stream) {
+        corpus_write(stream, _header);
+        corpus_write_bytes(stream, _records.data(), _records.size() * sizeof(corpus_column_record));
+        corpus_write_bytes(stream, _names.data(), _names.size());
+    });
+}
+
+void open_corpus_dataset(const std::filesystem::path& path, corpus_dataset& dataset)
+{
+    corpus_dataset _dataset;
+    _dataset.path = path;
+    std::size_t _size = 0;
+    _dataset.manifest = map_file(path / corpus_manifest_name, _size);
+    if (_size < sizeof(corpus_header)) {
+        throw std::runtime_error("Invalid corpus dataset: " + path.string());
+    }
+    const corpus_header _header = corpus_read<corpus_header>(_dataset.manifest.get(), 0);
+    if (std::memcmp(_header.magic, corpus_magic, sizeof(corpus_magic)) != 0) {
+        throw std::runtime_error("Invalid corpus dataset: " + path.string());
+    }
+    if (_header.format != corpus_format) {
+        throw std::runtime_error("Unsupported corpus dataset format: " + std::to_string(_header.format));
+    }
+    const std::uint64_t _records_size = _size - sizeof(corpus_header);
+    bool _valid = _header.column_count <= _records_size / sizeof(corpus_column_record)
+        && _header.names_size == _records_size - _header.column_count * sizeof(corpus_column_record);
+    for (std::uint64_t _column_index = 0; _valid && _column_index < _header.column_count; ++_column_index) {
+        const corpus_column_record _record = corpus_get_record(_dataset, static_cast<std::size_t>(_column_index));
+        _valid = _record.table < corpus_table_count
+            && _record.type <= static_cast<std::uint32_t>(corpus_type::string)
+            && _record.name_offset <= _header.names_size
+            && _record.name_size <= _header.names_size - _record.name_offset
+            && _record.row_count == _header.row_counts[_record.table]
+            && _record.row_count <= std::numeric_limits<std::uint64_t>::max() / 4;
+    }
+    _valid = _valid && _header.string_count <= std::numeric_limits<std::uint64_t>::max() / sizeof(std::uint64_t);
+    if (!_valid) {
+        throw std::runtime_error("Invalid corpus dataset: " + path.string());
+    }
+
+    _dataset.columns.reserve(static_cast<std::size_t>(_header.column_count));
+    const std::uint64_t _names_offset = sizeof(corpus_header) + _header.column_count * sizeof(corpus_column_record);
+    for (std::size_t _column_index = 0; _column_index < _header.column_count; ++_column_index) {
+        const corpus_column_record _record = corpus_get_record(_dataset, _column_index);
+        const std::string _name(_dataset.manifest.get() + _names_offset + _record.name_offset, static_cast<std::size_t>(_record.name_size));
+        if (_name.empty() || _name.find_first_of("/\\") != std::string::npos || _name.front() == '.') {
+            throw std::runtime_error("Invalid corpus dataset: " + path.string());
+        }
+        const std::filesystem::path _column_path = path / (std::string(corpus_table_names[_record.table]) + '.' + _name);
+        _dataset.columns.push_back(corpus_map_file(_column_path, _record.row_count * corpus_type_size(static_cast<corpus_type>(_record.type))));
+    }
+    _dataset.string_offsets = corpus_map_file(path / corpus_string_offsets_name, _header.string_count * sizeof(std::uint64_t));
+    _dataset.string_data = corpus_map_file(path / corpus_string_data_name, _header.string_data_size);
+    if (_header.string_count && corpus_read<std::uint64_t>(_dataset.string_offsets.get(), (_header.string_count - 1) * sizeof(std::uint64_t)) != _header.string_data_size) {
+        throw std::runtime_error("Invalid corpus dataset: " + path.string());
+    }
+    dataset = std::move(_dataset);
+}
+
+std::size_t corpus_row_count(const corpus_dataset& dataset, const corpus_table table)
+{
+    if (static_cast<std::size_t>(table) >= corpus_table_count) {
+        throw std::runtime_error("Invalid corpus table: " + std::to_string(static_cast<std::uint32_t>(table)));
+    }
+    return static_cast<std::size_t>(corpus_get_header(dataset).row_counts[static_cast<std::size_t>(table)]);
+}
+
+std::vector<corpus_column> list_corpus_columns(const corpus_dataset& dataset)
+{
+    const corpus_header _header = corpus_get_header(dataset);
+    std::vector<corpus_column> _columns;
+    _columns.reserve(static_cast<std::size_t>(_header.column_count));
+    for (std::size_t _column_index = 0; _column_index < _header.column_count; ++_column_index) {
+        _columns.push_back(corpus_get_column(dataset, _header, _column_index));
+    }
+    return _columns;
+}
+
+corpus_column find_corpus_column(const corpus_dataset& dataset, const corpus_table table, const std::string_view name)
+{
+    const corpus_header _header = corpus_get_header(dataset);
+    for (std::size_t _column_index = 0; _column_index < _header.column_count; ++_column_index) {
+        const corpus_column _column = corpus_get_column(dataset, _header, _column_index);
+        if (_column.table == table && _column.name == name) {
+            return _column;
+        }
+    }
+    throw std::runtime_error("Missing corpus column: " + std::string(name));
+}
+
+std::string_view get_corpus_string(const corpus_dataset& dataset, const std::uint32_t code)
+{
+    const corpus_header _header = corpus_get_header(dataset);
+    if (code >= _header.string_count) {
+        throw std::runtime_error("Invalid corpus string code: " + std::to_string(code));
+    }
+    const std::uint64_t _begin = code ? corpus_read<std::uint64_t>(dataset.string_offsets.get(), (code - 1) * sizeof(std::uint64_t)) : 0;
+    const std::uint64_t _end = corpus_read<std::uint64_t>(dataset.string_offsets.get(), code * sizeof(std::uint64_t));
+    if (_begin > _end || _end > _header.string_data_size) {
+        throw std::runtime_error("Invalid corpus string code: " + std::to_string(code));
+    }
+    return std::string_view(dataset.string_data.get() + _begin, static_cast<std::size_t>(_end - _begin));
+}
+
+}
@@ -0,0 +1,406 @@
+#include <fmtals/diff.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "serialize.hpp"
+
+/// @brief Candidate positions per key, consumed in order so that equal elements keep their
+/// relative order and are never reported as moved
+template <typename Key>
+using diff_queues = std::unordered_map<Key, std::deque<std::size_t>>;
+
+template <typename Key>
+static std::size_t diff_pop(diff_queues<Key>& queues, const Key& key)
+{
+    auto _it = queues.find(key);
+    if (_it == queues.end() || _it->second.empty()) {
+        return fmtals::change::npos;
+    }
+    const std::size_t _index = _it->second.front();
+    _it->second.pop_front();
+    return _index;
+}
+
+static std::uint64_t diff_combine(const std::uint64_t seed, const std::uint64_t value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+static const std::pmr::vector<fmtals::project::audio_clip>* diff_get_clips(const fmtals::project::user_track& track)
+{
+    if (const fmtals::project::audio_track* _audio_track = std::get_if<fmtals::project::audio_track>(&track)) {
+        return &_audio_track->events_audio_clips;
+    }
+    return nullptr;
+}
+
+template <typename T>
+static fmtals::track_digest diff_digest_track(const T& track, const std::size_t kind)
+{
+    fmtals::track_digest _digest;
+    _digest.kind = kind;
+    // the memorized first clip name follows the clips and is left out
+    _digest.names = hash_archive([&](auto& archive) { archive(track.effective_name, track.user_name); });
+    _digest.header = hash_archive([&](auto& archive) { fmtals::serialize_track_header(archive, track); });
+    _digest.device_chain = hash_archive([&](auto& archive) {
+        fmtals::serialize_device_chain_settings(archive, track);
+        archive(track.plugin_devices);
+    });
+    _digest.subtree = diff_combine(diff_combine(diff_combine(kind, _digest.names), _digest.header), _digest.device_chain);
+    _digest.lanes.reserve(track.automation_lanes.size());
+    for (const fmtals::project::automation_lane& _lane : track.automation_lanes) {
+        _digest.lanes.emplace_back(hash_archive([&](auto& archive) { archive(_lane); }));
+        _digest.subtree = diff_combine(_digest.subtree, _digest.lanes.back());
+    }
+    if constexpr (std::is_same_v<T, fmtals::project::audio_track>) {
+        _digest.clips.reserve(track.events_audio_clips.size());
+        _digest.clip_contents.reserve(track.events_audio_clips.size());
+        for (const fmtals::project::audio_clip& _clip : track.events_audio_clips) {
+            _digest.clip_contents.emplace_back(hash_archive([&](auto& archive) { fmtals::serialize_clip_content(archive, _clip); }));
+            _digest.clips.emplace_back(diff_combine(hash_archive([&](auto& archive) { fmtals::serialize_clip_position(archive, _clip); }), _digest.clip_contents.back()));
+            _digest.subtree = diff_combine(_digest.subtree, _digest.clips.back());
+        }
+    }
+    return _digest;
+}
+
+static fmtals::track_digest diff_digest_user_track(const fmtals::project::user_track& track)
+{
+    return std::visit([&](const auto& _track_visit) { return diff_digest_track(_track_visit, track.index()); }, track);
+}
+
+/// @brief Flags the elements of a sequence that belong to one of its longest increasing
+/// subsequences. Matched elements outside of it are the ones that have moved
+static std::vector<bool> diff_longest_increasing(const std::vector<std::size_t>& sequence)
+{
+    std::vector<std::size_t> _tails;
+    std::vector<std::size_t> _previous(sequence.size(), fmtals::change::npos);
+    for (std::size_t _index = 0; _index < sequence.size(); ++_index) {
+        auto _it = std::lower_bound(_tails.begin(), _tails.end(), sequence[_index], [&](const std::size_t tail, const std::size_t value) {
+            return sequence[tail] < value;
+        });
+        if (_it != _tails.begin()) {
+            _previous[_index] = *(_it - 1);
+        }
+        if (_it == _tails.end()) {
+            _tails.emplace_back(_index);
+        } else {
+            *_it = _index;
+        }
+    }
+    std::vector<bool> _in_sequence(sequence.size(), false);
+    std::size_t _index = _tails.empty() ? fmtals::change::npos : _tails.back();
+    while (_index != fmtals::change::npos) {
+        _in_sequence[_index] = true;
+        _index = _previous[_index];
+    }
+    return _in_sequence;
+}
+
+static bool diff_digest_matches(const fmtals::project& proj, const fmtals::project_digest& digest)
+{
+    return digest.tracks.size() == proj.tracks.size() && digest.return_tracks.size() == proj.return_tracks.size() && digest.scenes.size() == proj.scene_names.size();
+}
+
+static void diff_push(std::vector<fmtals::change>& changes, const fmtals::change_scope scope, const fmtals::change_type type, const std::size_t old_index, const std::size_t new_index, const std::size_t old_child_index = fmtals::change::npos, const std::size_t new_child_index = fmtals::change::npos)
+{
+    fmtals::change& _change = changes.emplace_back();
+    _change.scope = scope;
+    _change.type = type;
+    _change.old_index = old_index;
+    _change.new_index = new_index;
+    _change.old_child_index = old_child_index;
+    _change.new_child_index = new_child_index;
+}
+
+static void diff_clips(
+    std::vector<fmtals::change>& changes,
+    const fmtals::change_scope scope,
+    const std::size_t old_index,
+    const std::size_t new_index,
+    const std::pmr::vector<fmtals::project::audio_clip>& old_clips,
+    const std::pmr::vector<fmtals::project::audio_clip>& new_clips,
+    const fmtals::track_digest& old_digest,
+    const fmtals::track_digest& new_digest)
+{
+    // identical clips, wherever they are stored
+    diff_queues<std::uint64_t> _old_by_hash;
+    _old_by_hash.reserve(old_clips.size());
+    for (std::size_t _old_clip = 0; _old_clip < old_clips.size(); ++_old_clip) {
+        _old_by_hash[old_digest.clips[_old_clip]].emplace_back(_old_clip);
+    }
+    std::vector<bool> _old_matched(old_clips.size(), false);
+    std::vector<std::size_t> _remaining_new;
+    for (std::size_t _new_clip = 0; _new_clip < new_clips.size(); ++_new_clip) {
+        const std::size_t _old_clip = diff_pop(_old_by_hash, new_digest.clips[_new_clip]);
+        if (_old_clip != fmtals::change::npos) {
+            _old_matched[_old_clip] = true;
+        } else {
+            _remaining_new.emplace_back(_new_clip);
+        }
+    }
+
+    // same content at another position
+    diff_queues<std::uint64_t> _old_by_content;
+    for (std::size_t _old_clip = 0; _old_clip < old_clips.size(); ++_old_clip) {
+        if (!_old_matched[_old_clip]) {
+            _old_by_content[old_digest.clip_contents[_old_clip]].emplace_back(_old_clip);
+        }
+    }
+    std::vector<std::size_t> _unmatched_new;
+    for (const std::size_t _new_clip : _remaining_new) {
+        const std::size_t _old_clip = diff_pop(_old_by_content, new_digest.clip_contents[_new_clip]);
+        if (_old_clip != fmtals::change::npos) {
+            _old_matched[_old_clip] = true;
+            diff_push(changes, scope, fmtals::change_type::clip_moved, old_index, new_index, _old_clip, _new_clip);
+        } else {
+            _unmatched_new.emplace_back(_new_clip);
+        }
+    }
+    std::vector<std::size_t> _unmatched_old;
+    for (std::size_t _old_clip = 0; _old_clip < old_clips.size(); ++_old_clip) {
+        if (!_old_matched[_old_clip]) {
+            _unmatched_old.emplace_back(_old_clip);
+        }
+    }
+
+    // everything else is paired in order
+    const std::size_t _paired = std::min(_unmatched_old.size(), _unmatched_new.size());
+    for (std::size_t _index = 0; _index < _paired; ++_index) {
+        diff_push(changes, scope, fmtals::change_type::clip_modified, old_index, new_index, _unmatched_old[_index], _unmatched_new[_index]);
+    }
+    for (std::size_t _index = _paired; _index < _unmatched_old.size(); ++_index) {
+        diff_push(changes, scope, fmtals::change_type::clip_removed, old_index, new_index, _unmatched_old[_index], fmtals::change::npos);
+    }
+    for (std::size_t _index = _paired; _index < _unmatched_new.size(); ++_index) {
+        diff_push(changes, scope, fmtals::change_type::clip_added, old_index, new_index, fmtals::change::npos, _unmatched_new[_index]);
+    }
+}
+
+static void diff_track(
+    std::vector<fmtals::change>& changes,
+    const fmtals::change_scope scope,
+    const std::size_t old_index,
+    const std::size_t new_index,
+    const fmtals::track_digest& old_digest,
+    const fmtals::track_digest& new_digest,
+    const std::pmr::vector<fmtals::project::audio_clip>* old_clips,
+    const std::pmr::vector<fmtals::project::audio_clip>* new_clips)
+{
+    if (old_digest.kind == new_digest.kind && old_digest.subtree == new_digest.subtree) {
+        return;
+    }
+    if (old_digest.names != new_digest.names) {
+        diff_push(changes, scope, fmtals::change_type::renamed, old_index, new_index);
+    }
+    if (old_digest.kind != new_digest.kind || old_digest.header != new_digest.header) {
+        diff_push(changes, scope, fmtals::change_type::modified, old_index, new_index);
+    }
+    if (old_digest.device_chain != new_digest.device_chain) {
+        diff_push(changes, scope, fmtals::change_type::device_chain_modified, old_index, new_index);
+    }
+    const std::size_t _common_lanes = std::min(old_digest.lanes.size(), new_digest.lanes.size());
+    for (std::size_t _lane = 0; _lane < _common_lanes; ++_lane) {
+        if (old_digest.lanes[_lane] != new_digest.lanes[_lane]) {
+            diff_push(changes, scope, fmtals::change_type::lane_modified, old_index, new_index, _lane, _lane);
+        }
+    }
+    for (std::size_t _lane = _common_lanes; _lane < old_digest.lanes.size(); ++_lane) {
+        diff_push(changes, scope, fmtals::change_type::lane_removed, old_index, new_index, _lane, fmtals::change::npos);
+    }
+    for (std::size_t _lane = _common_lanes; _lane < new_digest.lanes.size(); ++_lane) {
+        diff_push(changes, scope, fmtals::change_type::lane_added, old_index, new_index, fmtals::change::npos, _lane);
+    }
+    static const std::pmr::vector<fmtals::project::audio_clip> _no_clips;
+    diff_clips(changes, scope, old_index, new_index, old_clips ? *old_clips : _no_clips, new_clips ? *new_clips : _no_clips, old_digest, new_digest);
+}
+
+/// @brief Matches tracks by id and reports additions, removals, moves and per-track changes
+template <typename T>
+static void diff_track_list(
+    std::vector<fmtals::change>& changes,
+    const fmtals::change_scope scope,
+    const std::pmr::vector<T>& old_tracks,
+    const std::pmr::vector<T>& new_tracks,
+    const std::vector<fmtals::track_digest>& old_digests,
+    const std::vector<fmtals::track_digest>& new_digests)
+{
+    const auto _get_id = [](const T& track) {
+        if constexpr (std::is_same_v<T, fmtals::project::user_track>) {
+            return std::visit([](const auto& _track_visit) { return _track_visit.id; }, track);
+        } else {
+            return track.id;
+        }
+    };
+    const auto _get_clips = [](const T& track) -> const std::pmr::vector<fmtals::project::audio_clip>* {
+        if constexpr (std::is_same_v<T, fmtals::project::user_track>) {
+            return diff_get_clips(track);
+        } else {
+            return nullptr;
+        }
+    };
+
+    diff_queues<std::uint32_t> _old_by_id;
+    _old_by_id.reserve(old_tracks.size());
+    for (std::size_t _old_track = 0; _old_track < old_tracks.size(); ++_old_track) {
+        _old_by_id[_get_id(old_tracks[_old_track])].emplace_back(_old_track);
+    }
+    std::vector<bool> _old_matched(old_tracks.size(), false);
+    std::vector<std::pair<std::size_t, std::size_t>> _matches;
+    std::vector<std::size_t> _added;
+    for (std::size_t _new_track = 0; _new_track < new_tracks.size(); ++_new_track) {
+        const std::size_t _old_track = diff_pop(_old_by_id, _get_id(new_tracks[_new_track]));
+        if (_old_track != fmtals::change::npos) {
+            _old_matched[_old_track] = true;
+            _matches.emplace_back(_old_track, _new_track);
+        } else {
+            _added.emplace_back(_new_track);
+        }
+    }
+    for (std::size_t _old_track = 0; _old_track < old_tracks.size(); ++_old_track) {
+        if (!_old_matched[_old_track]) {
+            diff_push(changes, scope, fmtals::change_type::removed, _old_track, fmtals::change::npos);
+        }
+    }
+    for (const std::size_t _new_track : _added) {
+        diff_push(changes, scope, fmtals::change_type::added, fmtals::change::npos, _new_track);
+    }
+
+    std::vector<std::size_t> _old_order;
+    _old_order.reserve(_matches.size());
+    for (const std::pair<std::size_t, std::size_t>& _match : _matches) {
+        _old_order.emplace_back(_match.first);
+    }
+    const std::vector<bool> _in_place = diff_longest_increasing(_old_order);
+    for (std::size_t _index = 0; _index < _matches.size(); ++_index) {
+        const std::size_t _old_track = _matches[_index].first;
+        const std::size_t _new_track = _matches[_index].second;
+        if (!_in_place[_index]) {
+            diff_push(changes, scope, fmtals::change_type::moved, _old_track, _new_track);
+        }
+        const T& _old = old_tracks[_old_track];
+        const T& _new = new_tracks[_new_track];
+        diff_track(changes, scope, _old_track, _new_track, old_digests[_old_track], new_digests[_new_track], _get_clips(_old), _get_clips(_new));
+    }
+}
+
+static void diff_scenes(
+    std::vector<fmtals::change>& changes,
+    const std::pmr::vector<fmtals::project::scene>& old_scenes,
+    const std::pmr::vector<fmtals::project::scene>& new_scenes,
+    const std::vector<std::uint64_t>& old_digests,
+    const std::vector<std::uint64_t>& new_digests)
+{
+    // identical scenes first, then the remaining ones in order
+    diff_queues<std::uint64_t> _old_by_hash;
+    _old_by_hash.reserve(old_scenes.size());
+    for (std::size_t _old_scene = 0; _old_scene < old_scenes.size(); ++_old_scene) {
+        _old_by_hash[old_digests[_old_scene]].emplace_back(_old_scene);
+    }
+    std::vector<std::size_t> _new_to_old(new_scenes.size(), fmtals::change::npos);
+    std::vector<bool> _old_matched(old_scenes.size(), false);
+    std::vector<std::size_t> _unmatched_new;
+    for (std::size_t _new_scene = 0; _new_scene < new_scenes.size(); ++_new_scene) {
+        const std::size_t _old_scene = diff_pop(_old_by_hash, new_digests[_new_scene]);
+        if (_old_scene != fmtals::change::npos) {
+            _new_to_old[_new_scene] = _old_scene;
+            _old_matched[_old_scene] = true;
+        } else {
+            _unmatched_new.emplace_back(_new_scene);
+        }
+    }
+    std::vector<std::size_t> _unmatched_old;
+    for (std::size_t _old_scene = 0; _old_scene < old_scenes.size(); ++_old_scene) {
+        if (!_old_matched[_old_scene]) {
+            _unmatched_old.emplace_back(_old_scene);
+        }
+    }
+    const std::size_t _paired = std::min(_unmatched_old.size(), _unmatched_new.size());
+    for (std::size_t _index = 0; _index < _paired; ++_index) {
+        const std::size_t _old_scene = _unmatched_old[_index];
+        const std::size_t _new_scene = _unmatched_new[_index];
+        const fmtals::project::scene& _old = old_scenes[_old_scene];
+        const fmtals::project::scene& _new = new_scenes[_new_scene];
+        _new_to_old[_new_scene] = _old_scene;
+        if (_old.value != _new.value) {
+            diff_push(changes, fmtals::change_scope::scene, fmtals::change_type::renamed, _old_scene, _new_scene);
+        }
+        if (_old.annotation != _new.annotation || _old.color_index != _new.color_index || _old.lom_id != _new.lom_id || _old.clip_slots_list_wrapper_lom_id != _new.clip_slots_list_wrapper_lom_id) {
+            diff_push(changes, fmtals::change_scope::scene, fmtals::change_type::modified, _old_scene, _new_scene);
+        }
+    }
+    for (std::size_t _index = _paired; _index < _unmatched_old.size(); ++_index) {
+        diff_push(changes, fmtals::change_scope::scene, fmtals::change_type::removed, _unmatched_old[_index], fmtals::change::npos);
+    }
+    for (std::size_t _index = _paired; _index < _unmatched_new.size(); ++_index) {
+        diff_push(changes, fmtals::change_scope::scene, fmtals::change_type::added, fmtals::change::npos, _unmatched_new[_index]);
+    }
+
+    std::vector<std::size_t> _old_order;
+    std::vector<std::size_t> _new_order;
+    for (std::size_t _new_scene = 0; _new_scene < new_scenes.size(); ++_new_scene) {
+        if (_new_to_old[_new_scene] != fmtals::change::npos) {
+            _old_order.emplace_back(_new_to_old[_new_scene]);
+            _new_order.emplace_back(_new_scene);
+        }
+    }
+    const std::vector<bool> _in_place = diff_longest_increasing(_old_order);
+    for (std::size_t _index = 0; _index < _old_order.size(); ++_index) {
+        if (!_in_place[_index]) {
+            diff_push(changes, fmtals::change_scope::scene, fmtals::change_type::moved, _old_order[_index], _new_order[_index]);
+        }
+    }
+}
+
+namespace fmtals {
+
+project_digest digest_project(const project& proj)
+{
+    project_digest _digest;
+    _digest.settings = hash_archive([&](auto& archive) { serialize_settings(archive, proj); });
+    _digest.tracks.reserve(proj.tracks.size());
+    for (const project::user_track& _track : proj.tracks) {
+        _digest.tracks.emplace_back(diff_digest_user_track(_track));
+    }
+    _digest.return_tracks.reserve(proj.return_tracks.size());
+    for (const project::return_track& _track : proj.return_tracks) {
+        _digest.return_tracks.emplace_back(diff_digest_track(_track, 0));
+    }
+    _digest.master_track = diff_digest_track(proj.project_master_track, 0);
+    _digest.pre_hear_track = diff_digest_track(proj.project_prehear_track, 0);
+    _digest.scenes.reserve(proj.scene_names.size());
+    for (const project::scene& _scene : proj.scene_names) {
+        _digest.scenes.emplace_back(hash_archive([&](auto& archive) { archive(_scene); }));
+    }
+    return _digest;
+}
+
+std::vector<change> diff(const project& from, const project& to)
+{
+    return diff(from, digest_project(from), to, digest_project(to));
+}
+
+std::vector<change> diff(const project& from, const project_digest& from_digest, const project& to, const project_digest& to_digest)
+{
+    if (!diff_digest_matches(from, from_digest) || !diff_digest_matches(to, to_digest)) {
+        throw std::runtime_error("Digest does not match project");
+    }
+    std::vector<change> _changes;
+    if (from_digest.settings != to_digest.settings) {
+        diff_push(_changes, change_scope::settings, change_type::modified, 0, 0);
+    }
+    diff_track_list(_changes, change_scope::track, from.tracks, to.tracks, from_digest.tracks, to_digest.tracks);
+    diff_track_list(_changes, change_scope::return_track, from.return_tracks, to.return_tracks, from_digest.return_tracks, to_digest.return_tracks);
+    diff_track(_changes, change_scope::master_track, 0, 0, from_digest.master_track, to_digest.master_track, nullptr, nullptr);
+    diff_track(_changes, change_scope::pre_hear_track, 0, 0, from_digest.pre_hear_track, to_digest.pre_hear_track, nullptr, nullptr);
+    diff_scenes(_changes, from.scene_names, to.scene_names, from_digest.scenes, to_digest.scenes);
+    return _changes;
+}
+
+}
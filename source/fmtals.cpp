@@ -1,125 +1,286 @@
 #include <fmtals/fmtals.hpp>
+#include <fmtals/memory.hpp>
 
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
 #include <exception>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <optional>
 #include <sstream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include <cereal/archives/xml.hpp>
 #include <zlib.h>
 
+#include "parallel.hpp"
+#include "schema.hpp"
+#include "serialize.hpp"
+#include "xml.hpp"
+
 // gz
 
-void gz_decompress(std::istream& gz_stream, std::string& data)
+/// @brief Routes the allocations of zlib to a memory resource. zlib frees without a size, so every
+/// block starts with its size. An allocation that throws, such as one over the budget of a memory
+/// counter, fails inside zlib and is rethrown once zlib returns
+struct gz_allocator {
+    std::pmr::memory_resource* resource;
+    std::exception_ptr error;
+};
+
+static voidpf gz_allocate(voidpf opaque, uInt items, uInt size)
 {
-    std::vector<char> _compressed_data((std::istreambuf_iterator<char>(gz_stream)), std::istreambuf_iterator<char>());
-    if (_compressed_data.empty()) {
-        throw std::runtime_error("Input stream is empty or unreadable");
+    gz_allocator& _allocator = *static_cast<gz_allocator*>(opaque);
+    const std::size_t _size = alignof(std::max_align_t) + static_cast<std::size_t>(items) * size;
+    try {
+        void* _block = _allocator.resource->allocate(_size, alignof(std::max_align_t));
+        *static_cast<std::size_t*>(_block) = _size;
+        return static_cast<char*>(_block) + alignof(std::max_align_t);
+    } catch (...) {
+        _allocator.error = std::current_exception();
+        return Z_NULL;
     }
+}
+
+static void gz_free(voidpf opaque, voidpf address)
+{
+    gz_allocator& _allocator = *static_cast<gz_allocator*>(opaque);
+    char* _block = static_cast<char*>(address) - alignof(std::max_align_t);
+    _allocator.resource->deallocate(_block, *reinterpret_cast<std::size_t*>(_block), alignof(std::max_align_t));
+}
+
+template <typename Stream>
+static void gz_set_allocator(Stream& stream, gz_allocator& allocator)
+{
+    stream.zalloc = gz_allocate;
+    stream.zfree = gz_free;
+    stream.opaque = &allocator;
+}
+
+static void gz_rethrow(const gz_allocator& allocator)
+{
+    if (allocator.error) {
+        std::rethrow_exception(allocator.error);
+    }
+}
+
+void gz_decompress(std::istream& gz_stream, const std::function<void(const char*, std::size_t)>& callback, std::pmr::memory_resource* resource)
+{
+    // The buffers are allocated before zlib so that a failing allocation leaves no state behind
+    std::pmr::vector<char> _input_buffer(65536, resource);
+    std::pmr::vector<char> _output_buffer(65536, resource);
+    gz_allocator _allocator { resource, nullptr };
     z_stream _zstream {};
-    _zstream.next_in = reinterpret_cast<Bytef*>(_compressed_data.data());
-    _zstream.avail_in = static_cast<uInt>(_compressed_data.size());
+    gz_set_allocator(_zstream, _allocator);
     if (inflateInit2(&_zstream, 16 + MAX_WBITS) != Z_OK) {
+        gz_rethrow(_allocator);
         throw std::runtime_error("Failed to initialize zlib (gzip mode)");
     }
-    data.clear();
-    char _buffer[4096];
-    int _ret;
-    do {
-        _zstream.next_out = reinterpret_cast<Bytef*>(_buffer);
-        _zstream.avail_out = sizeof(_buffer);
-        _ret = inflate(&_zstream, Z_NO_FLUSH);
-        if (_ret != Z_OK && _ret != Z_STREAM_END) {
-            inflateEnd(&_zstream);
-            throw std::runtime_error("Zlib inflate error: " + std::to_string(_ret));
-        }
-        std::size_t _n_written = sizeof(_buffer) - _zstream.avail_out;
-        data.append(_buffer, _n_written);
-    } while (_ret != Z_STREAM_END);
+    bool _is_empty = true;
+    int _ret = Z_OK;
+    try {
+        while (_ret != Z_STREAM_END) {
+            if (_zstream.avail_in == 0) {
+                gz_stream.read(_input_buffer.data(), static_cast<std::streamsize>(_input_buffer.size()));
+                const std::size_t _n_read = static_cast<std::size_t>(gz_stream.gcount());
+                if (_n_read == 0) {
+                    throw std::runtime_error(_is_empty ? "Input stream is empty or unreadable" : "Zlib inflate error: unexpected end of stream");
+                }
+                _is_empty = false;
+                _zstream.next_in = reinterpret_cast<Bytef*>(_input_buffer.data());
+                _zstream.avail_in = static_cast<uInt>(_n_read);
+            }
+            do {
+                _zstream.next_out = reinterpret_cast<Bytef*>(_output_buffer.data());
+                _zstream.avail_out = static_cast<uInt>(_output_buffer.size());
+                _ret = inflate(&_zstream, Z_NO_FLUSH);
+                if (_ret == Z_BUF_ERROR && _zstream.avail_in == 0) {
+                    break; // needs more input
+                }
+                if (_ret != Z_OK && _ret != Z_STREAM_END) {
+                    gz_rethrow(_allocator);
+                    throw std::runtime_error("Zlib inflate error: " + std::to_string(_ret));
+                }
+                std::size_t _n_written = _output_buffer.size() - _zstream.avail_out;
+                callback(_output_buffer.data(), _n_written);
+            } while (_zstream.avail_out == 0 && _ret != Z_STREAM_END);
+        }
+    } catch (...) {
+        inflateEnd(&_zstream);
+        throw;
+    }
     inflateEnd(&_zstream);
 }
 
-void gz_compress(std::ostream& gz_stream, const std::string& data)
+void gz_decompress(std::istream& gz_stream, const std::function<void(const char*, std::size_t)>& callback)
+{
+    gz_decompress(gz_stream, callback, std::pmr::get_default_resource());
+}
+
+void gz_decompress(std::istream& gz_stream, std::pmr::string& data)
+{
+    data.clear();
+    gz_decompress(
+        gz_stream, [&](const char* chunk, const std::size_t size) {
+            data.append(chunk, size);
+        },
+        data.get_allocator().resource());
+}
+
+void gz_compress(std::ostream& gz_stream, const std::function<std::size_t(char*, std::size_t)>& read, std::pmr::memory_resource* resource)
 {
     if (!gz_stream) {
         throw std::runtime_error("Failed to open file for writing");
     }
+    std::pmr::vector<char> _input_buffer(65536, resource);
+    std::pmr::vector<char> _output_buffer(65536, resource);
+    gz_allocator _allocator { resource, nullptr };
     z_stream _stream {};
-    _stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data())); // Input data
-    _stream.avail_in = static_cast<uInt>(data.length());
+    gz_set_allocator(_stream, _allocator);
     if (deflateInit2(&_stream, Z_BEST_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        gz_rethrow(_allocator);
         throw std::runtime_error("Failed to initialize zlib for compression");
     }
-    char _buffer[4096];
-    int _ret;
-    do {
-        _stream.next_out = reinterpret_cast<Bytef*>(_buffer); // Output buffer
-        _stream.avail_out = sizeof(_buffer); // Buffer size
+    int _flush;
+    try {
+        do {
+            const std::size_t _n_read = read(_input_buffer.data(), _input_buffer.size());
+            _flush = _n_read == 0 ? Z_FINISH : Z_NO_FLUSH; // Finish once the input is exhausted
+            _stream.next_in = reinterpret_cast<Bytef*>(_input_buffer.data());
+            _stream.avail_in = static_cast<uInt>(_n_read);
+            do {
+                _stream.next_out = reinterpret_cast<Bytef*>(_output_buffer.data()); // Output buffer
+                _stream.avail_out = static_cast<uInt>(_output_buffer.size()); // Buffer size
+                if (deflate(&_stream, _flush) == Z_STREAM_ERROR) { // Compress
+                    throw std::runtime_error("Stream error during compression");
+                }
+                size_t _compressed_size = _output_buffer.size() - _stream.avail_out;
+                gz_stream.write(_output_buffer.data(), _compressed_size);
+                if (!gz_stream) {
+                    throw std::runtime_error("Failed to write to file");
+                }
+            } while (_stream.avail_out == 0); // Continue until the input chunk is consumed
+        } while (_flush != Z_FINISH);
+    } catch (...) {
+        deflateEnd(&_stream);
+        throw;
+    }
+    deflateEnd(&_stream);
+}
 
-        _ret = deflate(&_stream, Z_FINISH); // Compress
-        if (_ret != Z_OK && _ret != Z_STREAM_END) {
-            deflateEnd(&_stream);
-            throw std::runtime_error("Stream error during compression");
+void gz_compress(std::ostream& gz_stream, std::istream& data_stream)
+{
+    gz_compress(
+        gz_stream, [&](char* chunk, const std::size_t size) {
+            data_stream.read(chunk, static_cast<std::streamsize>(size));
+            return static_cast<std::size_t>(data_stream.gcount());
+        },
+        std::pmr::get_default_resource());
+}
+
+void gz_compress(std::ostream& gz_stream, const std::pmr::string& data)
+{
+    std::size_t _offset = 0;
+    gz_compress(
+        gz_stream, [&](char* chunk, const std::size_t size) {
+            const std::size_t _n_read = std::min(size, data.size() - _offset);
+            std::copy_n(data.data() + _offset, _n_read, chunk);
+            _offset += _n_read;
+            return _n_read;
+        },
+        data.get_allocator().resource());
+}
+
+// xml
+
+static bool xml_has_name(const xml_node* node, const std::string_view name)
+{
+    return node->name_size() == name.size() && std::memcmp(node->name(), name.data(), name.size()) == 0;
+}
+
+/// @brief Finds a child node by name. Ableton Live writes children in the order of the schema
+/// tables so the search starts after the previously found sibling and wraps around
+xml_node* xml_get_node(const xml_node* parent_node, const std::string_view child_name, const xml_node*& cursor)
+{
+    xml_node* _start = cursor ? cursor->next_sibling() : parent_node->first_node();
+    for (xml_node* _child = _start; _child; _child = _child->next_sibling()) {
+        if (xml_has_name(_child, child_name)) {
+            cursor = _child;
+            return _child;
         }
-        size_t _compressed_size = sizeof(_buffer) - _stream.avail_out;
-        gz_stream.write(_buffer, _compressed_size);
-        if (!gz_stream) {
-            deflateEnd(&_stream);
-            throw std::runtime_error("Failed to write to file");
+    }
+    for (xml_node* _child = parent_node->first_node(); _child != _start; _child = _child->next_sibling()) {
+        if (xml_has_name(_child, child_name)) {
+            cursor = _child;
+            return _child;
         }
-    } while (_ret != Z_STREAM_END); // Continue until all data is compressed
-    deflateEnd(&_stream);
+    }
+    throw std::runtime_error("Missing XML node: " + std::string(child_name));
 }
 
-// xml
+template <typename T>
+struct is_string : std::false_type { };
 
-using xml_document = cereal::rapidxml::xml_document<char>;
-using xml_node = cereal::rapidxml::xml_node<char>;
-using xml_attribute = cereal::rapidxml::xml_attribute<char>;
+template <typename Allocator>
+struct is_string<std::basic_string<char, std::char_traits<char>, Allocator>> : std::true_type { };
 
-xml_node* xml_get_node(const xml_node* parent_node, const std::string& child_name)
+template <typename T>
+T xml_parse_integer(const std::string_view str)
 {
-    return parent_node->first_node(child_name.c_str(), child_name.length());
+    T _value = 0;
+    const std::from_chars_result _result = std::from_chars(str.data(), str.data() + str.size(), _value);
+    if (_result.ec != std::errc() || _result.ptr != str.data() + str.size()) {
+        throw std::invalid_argument("Expected integer, got: " + std::string(str));
+    }
+    return _value;
 }
 
-std::vector<xml_node*> xml_get_nodes(xml_node* parent_node)
+template <typename T>
+T xml_parse_floating(const char* str)
 {
-    std::vector<xml_node*> _nodes;
-    xml_node* _current_node = parent_node->first_node(0);
-    while (_current_node) {
-        _nodes.emplace_back(_current_node);
-        _current_node = _current_node->next_sibling(0);
+    char* _end = nullptr;
+    const T _value = static_cast<T>(std::strtod(str, &_end));
+    if (_end == str) {
+        throw std::invalid_argument("Expected floating point number, got: " + std::string(str));
     }
-    return _nodes;
+    return _value;
 }
 
 template <typename T>
-void xml_get_value(const xml_node* node, const std::string& attribute, T& value)
+void xml_get_value(const xml_node* node, const std::string_view attribute, T& value)
 {
-    xml_attribute* _attribute = node->first_attribute(attribute.c_str(), attribute.length());
-    std::string _str = _attribute->value();
+    const xml_attribute* _attribute = node->first_attribute(attribute.data(), attribute.size());
+    if (!_attribute) {
+        throw std::runtime_error("Missing XML attribute: " + std::string(attribute));
+    }
+    const std::string_view _str(_attribute->value(), _attribute->value_size());
     if constexpr (std::is_same_v<T, bool>) {
         if (_str == "true" || _str == "1") {
             value = true;
         } else if (_str == "false" || _str == "0") {
             value = false;
         } else {
-            throw std::invalid_argument("Expected 'true', '1', 'false', '0', got: " + _str);
-        }
-    } else if constexpr (std::is_same_v<T, std::string>) {
-        value = _str;
-    } else if constexpr (std::is_same_v<T, float>) {
-        value = std::stof(_str);
-    } else if constexpr (std::is_same_v<T, double>) {
-        value = std::stod(_str);
+            throw std::invalid_argument("Expected 'true', '1', 'false', '0', got: " + std::string(_str));
+        }
+    } else if constexpr (is_string<T>::value) {
+        value.assign(_str.data(), _str.size());
+    } else if constexpr (std::is_same_v<T, fmtals::atom>) {
+        value = fmtals::make_atom(_str);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        value = xml_parse_floating<T>(_attribute->value());
     } else if constexpr (std::is_integral_v<T>) {
-        if constexpr (std::is_signed_v<T>) {
-            value = static_cast<T>(std::stoll(_str));
+        if (std::is_signed_v<T> || (!_str.empty() && _str.front() == '-')) {
+            value = static_cast<T>(xml_parse_integer<long long>(_str));
         } else {
-            value = static_cast<T>(std::stoull(_str));
+            value = static_cast<T>(xml_parse_integer<unsigned long long>(_str));
         }
     } else {
         static_assert(!sizeof(T*), "xml_get_value: unsupported T");
@@ -127,15 +288,16 @@ void xml_get_value(const xml_node* node, const std::string& attribute, T& value)
 }
 
 template <typename T>
-void xml_get_node_and_value(const xml_node* node, const std::string& child_name, T& value)
+void xml_get_value(const xml_node* node, const std::string_view attribute, std::optional<T>& value)
 {
-    xml_get_value(xml_get_node(node, child_name), "Value", value);
+    xml_get_value(node, attribute, value ? *value : value.emplace());
 }
 
-xml_node* xml_create_node(xml_document& document, xml_node* node, const std::string& child_name, cereal::rapidxml::node_type child_type = cereal::rapidxml::node_element)
+/// @brief Appends a child node. The name is not copied into the document and must outlive it,
+/// which holds for the names of the schema tables
+xml_node* xml_create_node(xml_document& document, xml_node* node, const std::string_view child_name, cereal::rapidxml::node_type child_type = cereal::rapidxml::node_element)
 {
-    char* _allocated_name = document.allocate_string(child_name.c_str());
-    xml_node* _child = document.allocate_node(child_type, _allocated_name);
+    xml_node* _child = document.allocate_node(child_type, child_name.data(), nullptr, child_name.size());
     if (node) {
         node->append_node(_child);
     } else {
@@ -145,24 +307,46 @@ xml_node* xml_create_node(xml_document& document, xml_node* node, const std::str
 }
 
 template <typename T>
-void xml_create_value(xml_document& document, xml_node* node, const std::string& attribute, const T& value)
+void xml_create_value(xml_document& document, xml_node* node, const std::string_view attribute, const T& value)
 {
-    char* _allocated_attribute_name = document.allocate_string(attribute.c_str());
-    char* _allocated_attribute_value;
-    if constexpr (std::is_same_v<T, std::string>) {
-        _allocated_attribute_value = document.allocate_string(value.c_str());
+    std::string_view _value;
+    if constexpr (is_string<T>::value) {
+        _value = std::string_view(document.allocate_string(value.data(), value.size()), value.size());
+    } else if constexpr (std::is_same_v<T, fmtals::atom>) {
+        _value = fmtals::atom_string(value);
     } else if constexpr (std::is_same_v<T, bool>) {
-        _allocated_attribute_value = document.allocate_string(value ? "true" : "false");
+        _value = value ? "true" : "false";
+    } else if constexpr (std::is_integral_v<T>) {
+        char _buffer[24];
+        const std::to_chars_result _result = std::to_chars(_buffer, _buffer + sizeof(_buffer), value);
+        const std::size_t _size = static_cast<std::size_t>(_result.ptr - _buffer);
+        _value = std::string_view(document.allocate_string(_buffer, _size), _size);
     } else {
-        _allocated_attribute_value = document.allocate_string(std::to_string(value).c_str());
+        const std::string _str = std::to_string(value);
+        _value = std::string_view(document.allocate_string(_str.data(), _str.size()), _str.size());
     }
-    node->append_attribute(document.allocate_attribute(_allocated_attribute_name, _allocated_attribute_value));
+    node->append_attribute(document.allocate_attribute(attribute.data(), _value.data(), attribute.size(), _value.size()));
 }
 
 template <typename T>
-void xml_create_node_and_value(xml_document& document, xml_node* parent, const std::string& child_name, const T& value)
+void xml_create_value(xml_document& document, xml_node* node, const std::string_view attribute, const std::optional<T>& value)
+{
+    xml_create_value(document, node, attribute, value.value());
+}
+
+/// @brief Copies the text of a child node as it is, such as the hex state of a plugin preset
+static void xml_get_text(const xml_node* node, const std::string_view name, std::pmr::string& text)
+{
+    const xml_node* _cursor = nullptr;
+    const xml_node* _text_node = xml_get_node(node, name, _cursor);
+    text.assign(_text_node->value(), _text_node->value_size());
+}
+
+/// @brief Appends a child node holding a text. The text is not copied into the document and must
+/// outlive it, which holds for the strings of the exported project
+static void xml_create_text(xml_document& document, xml_node* node, const std::string_view name, const std::pmr::string& text)
 {
-    xml_create_value(document, xml_create_node(document, parent, child_name), "Value", value);
+    xml_create_node(document, node, name)->value(text.data(), text.size());
 }
 
 // version
@@ -187,735 +371,772 @@ static fmtals::version detect_version(const std::string& creator)
     throw std::runtime_error("Unimplemented Ableton Live version");
 }
 
-template <typename T>
-void import_track_base(xml_node* node, T& track, const fmtals::version ver)
+/// @brief Calls the callback with the version as an std::integral_constant so that the schema
+/// is instantiated once per supported version
+template <typename Callback>
+void visit_version(const fmtals::version ver, Callback&& callback)
 {
-    xml_get_node_and_value(node, "LomId", track.lom_id);
-    xml_get_node_and_value(node, "LomIdView", track.lom_id_view);
-    xml_get_node_and_value(node, "EnvelopeModePreferred", track.envelope_mode_preferred);
+    switch (ver) {
+    case fmtals::version::v_9_0_0:
+        return callback(std::integral_constant<fmtals::version, fmtals::version::v_9_0_0>());
+    case fmtals::version::v_9_1_0:
+        return callback(std::integral_constant<fmtals::version, fmtals::version::v_9_1_0>());
+    case fmtals::version::v_9_2_0:
+        return callback(std::integral_constant<fmtals::version, fmtals::version::v_9_2_0>());
+    case fmtals::version::v_9_7_7:
+        return callback(std::integral_constant<fmtals::version, fmtals::version::v_9_7_7>());
+    case fmtals::version::v_11_0_0:
+        return callback(std::integral_constant<fmtals::version, fmtals::version::v_11_0_0>());
+    case fmtals::version::v_12_0_0:
+        return callback(std::integral_constant<fmtals::version, fmtals::version::v_12_0_0>());
+    }
+    throw std::runtime_error("Unimplemented Ableton Live version");
+}
 
-    xml_node* _delay_node = xml_get_node(node, "TrackDelay");
-    xml_get_node_and_value(_delay_node, "Value", track.track_delay_value);
-    xml_get_node_and_value(_delay_node, "IsValueSampleBased", track.track_delay_is_value_sample_based);
+// allocator
 
-    xml_node* _name_node = xml_get_node(node, "Name");
-    xml_get_node_and_value(_name_node, "EffectiveName", track.effective_name);
-    xml_get_node_and_value(_name_node, "UserName", track.user_name);
-    xml_get_node_and_value(_name_node, "Annotation", track.annotation);
+/// @brief Represents an archive that walks the binary field lists of a project and moves every
+/// engaged optional member that lives in another memory resource into the resource of the project
+struct allocator_archive {
+    fmtals::project::allocator_type allocator;
 
-    if (ver >= fmtals::version::v_12_0_0) {
-        xml_get_node_and_value(node, "Color", track.color.emplace());
-    } else {
-        xml_get_node_and_value(node, "ColorIndex", track.color_index.emplace());
+    template <typename... Values>
+    void operator()(Values&... values)
+    {
+        (add(values), ...);
     }
 
-    xml_get_node_and_value(node, "TrackGroupId", track.track_group_id);
-    xml_get_node_and_value(node, "TrackUnfolded", track.track_unfolded);
+    template <typename T>
+    void add(std::pmr::vector<T>& value)
+    {
+        if constexpr (!std::is_arithmetic_v<T>) {
+            for (T& _element : value) {
+                add(_element);
+            }
+        }
+    }
 
-    xml_node* _devices_list_node = xml_get_node(node, "DevicesListWrapper");
-    xml_get_value(_devices_list_node, "LomId", track.devices_list_wrapper_lom_id);
+    template <typename T>
+    void add(std::optional<T>& value)
+    {
+        if (!value) {
+            return;
+        }
+        if constexpr (std::uses_allocator_v<T, fmtals::project::allocator_type>) {
+            if (value->get_allocator() != allocator) {
+                T _value(std::move(*value), allocator);
+                value.reset();
+                value.emplace(std::move(_value));
+            }
+        }
+        add(*value);
+    }
 
-    xml_node* _clip_slots_list_node = xml_get_node(node, "ClipSlotsListWrapper");
-    xml_get_value(_clip_slots_list_node, "LomId", track.clip_slots_list_wrapper_lom_id);
+    template <typename T>
+    void add(T& value)
+    {
+        if constexpr (std::is_class_v<T> && !std::is_empty_v<T> && !std::is_same_v<T, fmtals::atom> && !is_string<T>::value) {
+            fmtals::serialize(*this, value);
+        }
+    }
+};
 
-    xml_get_node_and_value(node, "ViewData", track.view_data);
+template <typename T>
+static void allocator_add_track(allocator_archive& archive, T& track)
+{
+    fmtals::serialize_track_names(archive, track);
+    fmtals::serialize_track_header(archive, track);
+    fmtals::serialize(archive, static_cast<fmtals::project::device_chain&>(track));
+    if constexpr (std::is_same_v<T, fmtals::project::audio_track>) {
+        archive(track.events_audio_clips);
+    }
 }
 
+// schema
+
+/// @brief Holds the options of the running import, passed down to every field and binding.
+/// Resource is the resource of the call, used for the temporaries of the bindings
+struct import_context {
+    std::size_t jobs = 1;
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+};
+
+/// @brief Holds the options of the running export, passed down to every field and binding. When
+/// track_placeholder is set the tracks are replaced by a placeholder comment and printed
+/// separately by export_project
+struct export_context {
+    bool track_placeholder = false;
+};
+
+template <fmtals::version Version, typename Fields, typename Object>
+void import_fields(const xml_node* node, Object& object, const import_context& context);
+
+template <fmtals::version Version, typename Fields, typename Object>
+void export_fields(xml_document& document, xml_node* node, const Object& object, const export_context& context);
+
 template <typename T>
-void import_device_chain_base(xml_node* node, T& track, const fmtals::version ver)
+struct is_optional : std::false_type { };
+
+template <typename T>
+struct is_optional<std::optional<T>> : std::true_type { };
+
+template <typename Fields, typename Object>
+void reset_fields(Object& object);
+
+/// @brief Engages an optional member with the allocator of its owner, so that its content lives in
+/// the same memory resource as the rest of the project
+template <typename Object, typename T>
+void emplace_member(const Object& object, std::optional<T>& member)
 {
-    xml_node* _automation_lanes_node = xml_get_node(node, "AutomationLanes");
-    xml_node* _automation_lanes_child_node = xml_get_node(_automation_lanes_node, "AutomationLanes");
-    for (xml_node* _automation_lane_node : xml_get_nodes(_automation_lanes_child_node)) {
-        fmtals::project::automation_lane& _automation_lane = track.automation_lanes.emplace_back();
-        xml_get_node_and_value(_automation_lane_node, "SelectedDevice", _automation_lane.selected_device);
-        xml_get_node_and_value(_automation_lane_node, "SelectedEnvelope", _automation_lane.selected_envelope);
-        xml_get_node_and_value(_automation_lane_node, "IsContentSelected", _automation_lane.is_content_selected);
-        xml_get_node_and_value(_automation_lane_node, "LaneHeight", _automation_lane.lane_height);
-        xml_get_node_and_value(_automation_lane_node, "FadeViewVisible", _automation_lane.fade_view_visible);
+    if (!member) {
+        if constexpr (std::uses_allocator_v<T, fmtals::project::allocator_type>) {
+            member.emplace(object.get_allocator());
+        } else {
+            member.emplace();
+        }
     }
-    xml_get_node_and_value(_automation_lanes_node, "PermanentLanesAreVisible", track.permanent_lanes_are_visible);
-
-    xml_node* _envelope_chooser_node = xml_get_node(node, "EnvelopeChooser");
-    xml_get_node_and_value(_envelope_chooser_node, "SelectedDevice", track.envelope_chooser_selected_device);
-    xml_get_node_and_value(_envelope_chooser_node, "SelectedEnvelope", track.envelope_chooser_selected_envelope);
+}
 
-    // AudioInputRouting TODO
-    // MidiInputRouting TODO
-    // AudioOutputRouting TODO
-    // MidiOutputRouting TODO
-    // Mixer TODO
+/// @brief Clears an optional member that does not exist in the version being imported, so that
+/// importing into an existing project does not keep it from the previous one
+template <typename Fields, std::size_t Index, typename Object>
+void reset_field(Object& object)
+{
+    constexpr const auto& _field = std::get<Index>(Fields::get());
+    using _field_type = std::decay_t<decltype(_field)>;
+    if constexpr (_field_type::kind == schema::field_kind::value) {
+        if constexpr (is_optional<std::decay_t<decltype(object.*_field.member)>>::value) {
+            (object.*_field.member).reset();
+        }
+    } else if constexpr (_field_type::kind == schema::field_kind::node) {
+        reset_fields<schema::nested<Fields, Index>>(object);
+    }
 }
 
-template <typename T>
-void export_track_base(xml_document& document, xml_node* node, const T& track, const fmtals::version ver)
+template <typename Fields, typename Object, std::size_t... Indices>
+void reset_fields(Object& object, std::index_sequence<Indices...>)
 {
-    xml_create_node_and_value(document, node, "LomId", track.lom_id);
-    xml_create_node_and_value(document, node, "LomIdView", track.lom_id_view);
-    xml_create_node_and_value(document, node, "EnvelopeModePreferred", track.envelope_mode_preferred);
+    (reset_field<Fields, Indices>(object), ...);
+}
 
-    xml_node* _track_delay_node = xml_create_node(document, node, "TrackDelay");
-    xml_create_node_and_value(document, _track_delay_node, "Value", track.track_delay_value);
-    xml_create_node_and_value(document, _track_delay_node, "IsValueSampleBased", track.track_delay_is_value_sample_based);
+template <typename Fields, typename Object>
+void reset_fields(Object& object)
+{
+    reset_fields<Fields>(object, std::make_index_sequence<std::tuple_size_v<std::decay_t<decltype(Fields::get())>>>());
+}
 
-    xml_node* _track_name_node = xml_create_node(document, node, "Name");
-    xml_create_node_and_value(document, _track_name_node, "EffectiveName", track.effective_name);
-    xml_create_node_and_value(document, _track_name_node, "UserName", track.user_name);
-    xml_create_node_and_value(document, _track_name_node, "Annotation", track.annotation);
-    if (ver >= fmtals::version::v_12_0_0) {
-        xml_create_node_and_value(document, _track_name_node, "MemorizedFirstClipName", track.memorized_first_clip_name.value());
+template <fmtals::version Version, typename Fields, std::size_t Index, typename Object>
+void import_field(const xml_node* node, Object& object, const xml_node*& cursor, const import_context& context)
+{
+    constexpr const auto& _field = std::get<Index>(Fields::get());
+    using _field_type = std::decay_t<decltype(_field)>;
+    using _nested = schema::nested<Fields, Index>;
+    if constexpr (_field.since <= Version && Version < _field.until) {
+        if constexpr (_field_type::kind == schema::field_kind::value) {
+            if constexpr (is_optional<std::decay_t<decltype(object.*_field.member)>>::value) {
+                emplace_member(object, object.*_field.member);
+            }
+            if constexpr (_field.name.empty()) {
+                xml_get_value(node, _field.attribute, object.*_field.member);
+            } else {
+                xml_get_value(xml_get_node(node, _field.name, cursor), _field.attribute, object.*_field.member);
+            }
+        } else if constexpr (_field_type::kind == schema::field_kind::node) {
+            if constexpr (std::tuple_size_v<decltype(_field.fields)> != 0) {
+                import_fields<Version, _nested>(xml_get_node(node, _field.name, cursor), object, context);
+            }
+        } else if constexpr (_field_type::kind == schema::field_kind::member) {
+            import_fields<Version, _nested>(xml_get_node(node, _field.name, cursor), object.*_field.member, context);
+        } else if constexpr (_field_type::kind == schema::field_kind::list) {
+            auto& _container = object.*_field.member;
+            const xml_node* _list_node = xml_get_node(node, _field.name, cursor);
+            std::size_t _count = 0;
+            for (const xml_node* _element_node = _list_node->first_node(_field.element.data(), _field.element.size()); _element_node; _element_node = _element_node->next_sibling(_field.element.data(), _field.element.size())) {
+                ++_count;
+            }
+            _container.resize(_count);
+            std::size_t _element_index = 0;
+            for (const xml_node* _element_node = _list_node->first_node(_field.element.data(), _field.element.size()); _element_node; _element_node = _element_node->next_sibling(_field.element.data(), _field.element.size())) {
+                import_fields<Version, _nested>(_element_node, _container[_element_index++], context);
+            }
+        } else if constexpr (_field_type::kind == schema::field_kind::binding) {
+            _field_type::binding_type::template import_node<Version>(xml_get_node(node, _field.name, cursor), object, context);
+        }
+    } else {
+        reset_field<Fields, Index>(object);
     }
+}
 
-    if (ver >= fmtals::version::v_12_0_0) {
-        xml_create_node_and_value(document, node, "Color", track.color.value());
-    } else {
-        xml_create_node_and_value(document, node, "ColorIndex", track.color_index.value());
+template <fmtals::version Version, typename Fields, std::size_t Index, typename Object>
+void export_field(xml_document& document, xml_node* node, const Object& object, const export_context& context)
+{
+    constexpr const auto& _field = std::get<Index>(Fields::get());
+    using _field_type = std::decay_t<decltype(_field)>;
+    using _nested = schema::nested<Fields, Index>;
+    if constexpr (_field.since <= Version && Version < _field.until) {
+        if constexpr (_field_type::kind == schema::field_kind::value) {
+            if constexpr (_field.name.empty()) {
+                xml_create_value(document, node, _field.attribute, object.*_field.member);
+            } else {
+                xml_create_value(document, xml_create_node(document, node, _field.name), _field.attribute, object.*_field.member);
+            }
+        } else if constexpr (_field_type::kind == schema::field_kind::node) {
+            export_fields<Version, _nested>(document, xml_create_node(document, node, _field.name), object, context);
+        } else if constexpr (_field_type::kind == schema::field_kind::member) {
+            export_fields<Version, _nested>(document, xml_create_node(document, node, _field.name), object.*_field.member, context);
+        } else if constexpr (_field_type::kind == schema::field_kind::list) {
+            xml_node* _list_node = xml_create_node(document, node, _field.name);
+            for (const auto& _element : object.*_field.member) {
+                export_fields<Version, _nested>(document, xml_create_node(document, _list_node, _field.element), _element, context);
+            }
+        } else if constexpr (_field_type::kind == schema::field_kind::binding) {
+            _field_type::binding_type::template export_node<Version>(document, xml_create_node(document, node, _field.name), object, context);
+        }
     }
+}
 
-    xml_create_node_and_value(document, node, "TrackGroupId", track.track_group_id); // -1 vers master
-    xml_create_node_and_value(document, node, "TrackUnfolded", track.track_unfolded);
+template <fmtals::version Version, typename Fields, typename Object, std::size_t... Indices>
+void import_fields([[maybe_unused]] const xml_node* node, [[maybe_unused]] Object& object, [[maybe_unused]] const import_context& context, std::index_sequence<Indices...>)
+{
+    [[maybe_unused]] const xml_node* _cursor = nullptr;
+    (import_field<Version, Fields, Indices>(node, object, _cursor, context), ...);
+}
 
-    xml_node* _devices_list_node = xml_create_node(document, node, "DevicesListWrapper");
-    xml_create_value(document, _devices_list_node, "LomId", track.devices_list_wrapper_lom_id);
+template <fmtals::version Version, typename Fields, typename Object, std::size_t... Indices>
+void export_fields([[maybe_unused]] xml_document& document, [[maybe_unused]] xml_node* node, [[maybe_unused]] const Object& object, [[maybe_unused]] const export_context& context, std::index_sequence<Indices...>)
+{
+    (export_field<Version, Fields, Indices>(document, node, object, context), ...);
+}
 
-    xml_node* _clip_slots_list_node = xml_create_node(document, node, "ClipSlotsListWrapper");
-    xml_create_value(document, _clip_slots_list_node, "LomId", track.clip_slots_list_wrapper_lom_id);
+template <fmtals::version Version, typename Fields, typename Object>
+void import_fields(const xml_node* node, Object& object, const import_context& context)
+{
+    import_fields<Version, Fields>(node, object, context, std::make_index_sequence<std::tuple_size_v<std::decay_t<decltype(Fields::get())>>>());
+}
 
-    xml_create_node_and_value(document, node, "ViewData", track.view_data);
+template <fmtals::version Version, typename Fields, typename Object>
+void export_fields(xml_document& document, xml_node* node, const Object& object, const export_context& context)
+{
+    export_fields<Version, Fields>(document, node, object, context, std::make_index_sequence<std::tuple_size_v<std::decay_t<decltype(Fields::get())>>>());
 }
 
-namespace fmtals {
+struct schema::tracks_binding {
+    template <fmtals::version Version>
+    static void import_node(const xml_node* node, fmtals::project& proj, const import_context& context)
+    {
+        std::size_t _count = 0;
+        for (const xml_node* _track_node = node->first_node(); _track_node; _track_node = _track_node->next_sibling()) {
+            _count += !xml_has_name(_track_node, schema::track_element_name<fmtals::project::return_track>);
+        }
+        proj.tracks.resize(_count);
+        // tracks allocate from the resource of the project, which is only shared between threads
+        // when it is synchronized
+        if (parallel_jobs(context.jobs) == 1 || _count < 2 || !fmtals::is_thread_safe_resource(proj.get_allocator().resource())) {
+            std::size_t _track_index = 0;
+            for (const xml_node* _track_node = node->first_node(); _track_node; _track_node = _track_node->next_sibling()) {
+                if (!xml_has_name(_track_node, schema::track_element_name<fmtals::project::return_track>)) {
+                    import_user_track<Version>(_track_node, proj.tracks[_track_index++], proj.get_allocator(), context);
+                }
+            }
+            return;
+        }
+        std::pmr::vector<const xml_node*> _track_nodes(context.resource);
+        _track_nodes.reserve(_count);
+        for (const xml_node* _track_node = node->first_node(); _track_node; _track_node = _track_node->next_sibling()) {
+            if (!xml_has_name(_track_node, schema::track_element_name<fmtals::project::return_track>)) {
+                _track_nodes.emplace_back(_track_node);
+            }
+        }
+        parallel_for(_count, context.jobs, [&](const std::size_t index) {
+            import_user_track<Version>(_track_nodes[index], proj.tracks[index], proj.get_allocator(), context);
+        });
+    }
 
-void import_project(std::istream& stream, project& proj, version& ver)
-{
-    xml_document _xml_doc;
-    std::string _xml_data;
-    gz_decompress(stream, _xml_data);
-    _xml_doc.parse<0>(_xml_data.data());
-
-    xml_node* _ableton_node = _xml_doc.first_node("Ableton");
-    xml_get_value(_ableton_node, "MajorVersion", proj.major_version);
-    xml_get_value(_ableton_node, "MinorVersion", proj.minor_version);
-    xml_get_value(_ableton_node, "Creator", proj.creator);
-    xml_get_value(_ableton_node, "Revision", proj.revision);
-    ver = detect_version(proj.creator);
-    if (ver >= version::v_11_0_0) {
-        xml_get_value(_ableton_node, "SchemaChangeCount", proj.schema_change_count.emplace());
-    }
-
-    xml_node* _liveset_node = xml_get_node(_ableton_node, "LiveSet");
-    xml_get_node_and_value(_liveset_node, "OverwriteProtectionNumber", proj.overwrite_protection_number);
-    xml_get_node_and_value(_liveset_node, "LomId", proj.lom_id);
-    xml_get_node_and_value(_liveset_node, "LomIdView", proj.lom_id_view);
-
-    for (xml_node* _track_node : xml_get_nodes(xml_get_node(_liveset_node, "Tracks"))) {
-        project::user_track _user_track;
-        std::string _track_type(_track_node->name());
-        if (_track_type == "AudioTrack") {
-            _user_track = project::audio_track();
-        } else if (_track_type == "MidiTrack") {
-            _user_track = project::midi_track();
-        } else if (_track_type == "GroupTrack") {
-            _user_track = project::group_track();
-        } else if (_track_type == "ReturnTrack") {
-            continue;
-            _user_track = project::return_track();
+    template <fmtals::version Version>
+    static void import_user_track(const xml_node* node, fmtals::project::user_track& user_track, const fmtals::project::allocator_type& allocator, const import_context& context)
+    {
+        if (xml_has_name(node, schema::track_element_name<fmtals::project::audio_track>)) {
+            import_track<Version, fmtals::project::audio_track>(node, user_track, allocator, context);
+        } else if (xml_has_name(node, schema::track_element_name<fmtals::project::midi_track>)) {
+            import_track<Version, fmtals::project::midi_track>(node, user_track, allocator, context);
+        } else if (xml_has_name(node, schema::track_element_name<fmtals::project::group_track>)) {
+            import_track<Version, fmtals::project::group_track>(node, user_track, allocator, context);
         } else {
             throw std::runtime_error("Invalid track type");
         }
-
-        std::visit([&](auto& _track_visit) {
-            using _track_type_t = std::decay_t<decltype(_track_visit)>;
-            xml_get_value(_track_node, "Id", _track_visit.id);
-            import_track_base(_track_node, _track_visit, ver);
-            xml_get_node_and_value(_track_node, "SavedPlayingSlot", _track_visit.saved_playing_slot);
-            xml_get_node_and_value(_track_node, "SavedPlayingOffset", _track_visit.saved_playing_offset);
-            xml_get_node_and_value(_track_node, "MidiFoldIn", _track_visit.midi_fold_in);
-            xml_get_node_and_value(_track_node, "MidiPrelisten", _track_visit.midi_prelisten);
-            xml_get_node_and_value(_track_node, "Freeze", _track_visit.freeze);
-            xml_get_node_and_value(_track_node, "VelocityDetail", _track_visit.velocity_detail);
-            xml_get_node_and_value(_track_node, "NeedArrangerRefreeze", _track_visit.need_arranger_refreeze);
-            xml_get_node_and_value(_track_node, "PostProcessFreezeClips", _track_visit.post_process_freeze_clips);
-            xml_get_node_and_value(_track_node, "MidiTargetPrefersFoldOrIsNotUniform", _track_visit.midi_target_prefers_fold_or_is_not_uniform);
-
-            xml_node* _device_chain_node = xml_get_node(_track_node, "DeviceChain");
-            import_device_chain_base(_device_chain_node, _track_visit, ver);
-            // mixer TODO
-
-            xml_node* _main_sequencer_node = xml_get_node(_device_chain_node, "MainSequencer");
-            xml_node* _sample_node = xml_get_node(_main_sequencer_node, "Sample");
-            // xml_node* _arranger_automation_node = xml_get_node(_sample_node, "ArrangerAutomation");
-
-            // for (xml_node* _event_node : xml_get_nodes(xml_get_node(_arranger_automation_node, "Events"))) {
-
-            //     // audio events
-            //     if constexpr (std::is_same_v<_track_type_t, project::audio_track>) {
-            //         if (std::string(_event_node->name()) == "AudioClip") {
-            //             project::audio_clip _audio_clip = _track_visit.events_audio_clips.emplace_back();
-            //             xml_get_value(_event_node, "Time", _audio_clip.time);
-            //             xml_get_node_and_value(_event_node, "LomId", _audio_clip.lom_id);
-            //             xml_get_node_and_value(_event_node, "LomIdView", _audio_clip.lom_id_view);
-
-            //             for (xml_node* _warp_marker_node : xml_get_nodes(xml_get_node(_event_node, "WarpMarkers"))) {
-            //                 project::warp_marker& _warp_marker = _audio_clip.warp_markers.emplace_back();
-            //                 xml_get_value(_warp_marker_node, "SecTime", _warp_marker.sec_time);
-            //                 xml_get_value(_warp_marker_node, "BeatTime", _warp_marker.beat_time);
-            //             }
-
-            //             xml_get_node_and_value(_event_node, "MarkersGenerated", _audio_clip.markers_generated);
-            //             xml_get_node_and_value(_event_node, "CurrentStart", _audio_clip.current_start);
-            //             xml_get_node_and_value(_event_node, "CurrentEnd", _audio_clip.current_end);
-
-            //             xml_node* _loop_node = xml_get_node(_event_node, "Loop");
-            //             xml_get_node_and_value(_loop_node, "LoopStart", _audio_clip.loop_start);
-            //             xml_get_node_and_value(_loop_node, "LoopEnd", _audio_clip.loop_end);
-            //             xml_get_node_and_value(_loop_node, "StartRelative", _audio_clip.loop_start_relative);
-            //             xml_get_node_and_value(_loop_node, "LoopOn", _audio_clip.loop_on);
-            //             xml_get_node_and_value(_loop_node, "OutMarker", _audio_clip.loop_out_marker);
-            //             xml_get_node_and_value(_loop_node, "HiddenLoopStart", _audio_clip.hidden_loop_start);
-            //             xml_get_node_and_value(_loop_node, "HiddenLoopEnd", _audio_clip.hidden_loop_end);
-
-            //             xml_get_node_and_value(_event_node, "Name", _audio_clip.name);
-            //             xml_get_node_and_value(_event_node, "Annotation", _audio_clip.annotation);
-            //             if (ver >= version::v_12_0_0) {
-            //                 xml_get_node_and_value(_event_node, "Color", _audio_clip.color.emplace());
-            //             } else {
-            //                 xml_get_node_and_value(_event_node, "ColorIndex", _audio_clip.color_index.emplace());
-            //             }
-            //             xml_get_node_and_value(_event_node, "LaunchMode", _audio_clip.launch_mode);
-            //             xml_get_node_and_value(_event_node, "LaunchQuantisation", _audio_clip.launch_quantisation);
-
-            //             // TODO time signature
-
-            //             // TODO envelopes
-
-            //             // TODO ScrollerTimePreserver
-
-            //             // TODO TimeSelection
-
-            //             xml_get_node_and_value(_event_node, "Legato", _audio_clip.legato);
-            //             xml_get_node_and_value(_event_node, "Ram", _audio_clip.ram);
-            //             // groove settings ?
-            //             xml_get_node_and_value(_event_node, "Disabled", _audio_clip.disabled);
-            //             xml_get_node_and_value(_event_node, "VelocityAmount", _audio_clip.velocity_amount);
-            //             xml_get_node_and_value(_event_node, "FollowTime", _audio_clip.follow_time);
-            //             xml_get_node_and_value(_event_node, "FollowActionA", _audio_clip.follow_action_a);
-            //             xml_get_node_and_value(_event_node, "FollowActionB", _audio_clip.follow_action_b);
-            //             xml_get_node_and_value(_event_node, "FollowChanceA", _audio_clip.follow_chance_a);
-            //             xml_get_node_and_value(_event_node, "FollowChanceB", _audio_clip.follow_chance_b);
-
-            //             // grid
-            //             xml_node* _grid_node = xml_get_node(_event_node, "Grid");
-            //             xml_get_node_and_value(_grid_node, "FixedNumerator", _audio_clip.grid_fixed_numerator);
-            //             xml_get_node_and_value(_grid_node, "FixedDenominator", _audio_clip.grid_fixed_denominator);
-            //             xml_get_node_and_value(_grid_node, "GridIntervalPixel", _audio_clip.grid_interval_pixel);
-            //             xml_get_node_and_value(_grid_node, "Ntoles", _audio_clip.grid_ntoles);
-            //             xml_get_node_and_value(_grid_node, "SnapToGrid", _audio_clip.grid_snap_to_grid);
-            //             xml_get_node_and_value(_grid_node, "Fixed", _audio_clip.grid_fixed);
-
-            //             xml_get_node_and_value(_event_node, "FreezeStart", _audio_clip.freeze_start);
-            //             xml_get_node_and_value(_event_node, "FreezeEnd", _audio_clip.freeze_end);
-            //             xml_get_node_and_value(_event_node, "IsSongTempoMaster", _audio_clip.is_song_tempo_master);
-            //             xml_get_node_and_value(_event_node, "IsWarped", _audio_clip.is_warped);
-
-            //             // TODO many ahah
-            //         }
-            //     }
-            // }
-
-            // Inner DeviceChain TODO
-        },
-            _user_track);
-
-        proj.tracks.emplace_back(_user_track);
     }
 
-    xml_node* _master_track_node;
-    if (ver >= version::v_12_0_0) {
-        _master_track_node = xml_get_node(_liveset_node, "MainTrack");
-    } else {
-        _master_track_node = xml_get_node(_liveset_node, "MasterTrack");
+    /// @brief Binds a track in place, reusing the storage of the previous track at the same
+    /// position when it holds the same alternative and lives in the memory resource of the project
+    template <fmtals::version Version, typename Track>
+    static void import_track(const xml_node* node, fmtals::project::user_track& user_track, const fmtals::project::allocator_type& allocator, const import_context& context)
+    {
+        Track* _track = std::get_if<Track>(&user_track);
+        if (!_track || _track->get_allocator() != allocator) {
+            _track = &user_track.template emplace<Track>(allocator);
+        }
+        import_fields<Version, schema::track_accessor<Track>>(node, *_track, context);
     }
-    import_track_base(_master_track_node, proj.project_master_track, ver);
-
-    xml_node* _master_device_chain_node = xml_get_node(_master_track_node, "DeviceChain");
-    import_device_chain_base(_master_device_chain_node, proj.project_master_track, ver);
-
-    // todo Mixer etc
-
-    xml_node* _pre_hear_track_node = xml_get_node(_liveset_node, "PreHearTrack");
-    import_track_base(_pre_hear_track_node, proj.project_prehear_track, ver);
-
-    xml_node* _pre_hear_device_chain_node = xml_get_node(_pre_hear_track_node, "DeviceChain");
-    import_device_chain_base(_pre_hear_device_chain_node, proj.project_prehear_track, ver);
 
-    // todo Mixer etc
+    template <fmtals::version Version>
+    static void export_node(xml_document& document, xml_node* node, const fmtals::project& proj, const export_context& context)
+    {
+        if (context.track_placeholder) {
+            xml_node* _placeholder_node = xml_create_node(document, node, std::string_view(), cereal::rapidxml::node_comment);
+            _placeholder_node->value(placeholder.data(), placeholder.size());
+            return;
+        }
+        for (const fmtals::project::user_track& _track : proj.tracks) {
+            export_track<Version>(document, node, _track, context);
+        }
+    }
 
-    for (xml_node* _sends_pre_node : xml_get_nodes(xml_get_node(_liveset_node, "SendsPre"))) {
-        // TODO
+    template <fmtals::version Version>
+    static xml_node* export_track(xml_document& document, xml_node* node, const fmtals::project::user_track& track, const export_context& context)
+    {
+        return std::visit([&](const auto& _track_visit) {
+            using _track_type_t = std::decay_t<decltype(_track_visit)>;
+            xml_node* _track_node = xml_create_node(document, node, schema::track_element_name<_track_type_t>);
+            export_fields<Version, schema::track_accessor<_track_type_t>>(document, _track_node, _track_visit, context);
+            return _track_node;
+        },
+            track);
     }
 
-    for (xml_node* _scene_node : xml_get_nodes(xml_get_node(_liveset_node, "SceneNames"))) {
-        project::scene& _scene = proj.scene_names.emplace_back();
-        xml_get_value(_scene_node, "Value", _scene.value);
-        xml_get_node_and_value(_scene_node, "Annotation", _scene.annotation);
-        xml_get_node_and_value(_scene_node, "ColorIndex", _scene.color_index);
-        xml_get_node_and_value(_scene_node, "LomId", _scene.lom_id);
+    static constexpr std::string_view placeholder = "fmtals:tracks";
+};
+
+struct schema::sends_pre_binding {
+    template <fmtals::version Version>
+    static void import_node(const xml_node* node, fmtals::project& proj, const import_context&)
+    {
+        constexpr std::string_view _element = "SendPreBool";
+        proj.sends_pre.clear();
+        for (const xml_node* _send_pre_node = node->first_node(_element.data(), _element.size()); _send_pre_node; _send_pre_node = _send_pre_node->next_sibling(_element.data(), _element.size())) {
+            bool _send_pre;
+            xml_get_value(_send_pre_node, "Value", _send_pre);
+            proj.sends_pre.push_back(_send_pre);
+        }
+    }
 
-        xml_node* _clip_slots_list_wrapper = xml_get_node(_scene_node, "ClipSlotsListWrapper");
-        xml_get_value(_clip_slots_list_wrapper, "LomId", _scene.clip_slots_list_wrapper_lom_id);
+    template <fmtals::version Version>
+    static void export_node(xml_document& document, xml_node* node, const fmtals::project& proj, const export_context&)
+    {
+        for (const bool _send_pre : proj.sends_pre) {
+            xml_create_value(document, xml_create_node(document, node, "SendPreBool"), "Value", _send_pre);
+        }
+    }
+};
+
+/// @brief Reads whether a slot holds a clip and the color of that clip. The clip itself is copied
+/// by clip_slots_binding, which needs the track to store it
+struct schema::clip_slot_binding {
+    template <fmtals::version Version>
+    static void import_node(const xml_node* node, fmtals::project::clip_slot& slot, const import_context&)
+    {
+        const xml_node* _cursor = nullptr;
+        const xml_node* _clip_node = xml_get_node(node, "Value", _cursor)->first_node();
+        slot.has_clip = _clip_node && _clip_node->type() == cereal::rapidxml::node_element;
+        slot.clip_color.reset();
+        slot.clip_color_index.reset();
+        if (slot.has_clip) {
+            _cursor = nullptr;
+            if constexpr (Version >= fmtals::version::v_12_0_0) {
+                xml_get_value(xml_get_node(_clip_node, "Color", _cursor), "Value", slot.clip_color);
+            } else {
+                xml_get_value(xml_get_node(_clip_node, "ColorIndex", _cursor), "Value", slot.clip_color_index);
+            }
+        }
     }
 
-    xml_node* _transport_node = xml_get_node(_liveset_node, "Transport");
-    xml_get_node_and_value(_transport_node, "PhaseNudgeTempo", proj.transport_phase_nudge_tempo);
-    xml_get_node_and_value(_transport_node, "LoopOn", proj.transport_loop_on);
-    xml_get_node_and_value(_transport_node, "LoopStart", proj.transport_loop_start);
-    xml_get_node_and_value(_transport_node, "LoopLength", proj.transport_loop_length);
-    xml_get_node_and_value(_transport_node, "LoopIsSongStart", proj.transport_loop_is_song_start);
-    xml_get_node_and_value(_transport_node, "CurrentTime", proj.transport_current_time);
-    xml_get_node_and_value(_transport_node, "PunchIn", proj.transport_punch_in);
-    xml_get_node_and_value(_transport_node, "PunchOut", proj.transport_punch_out);
-    xml_get_node_and_value(_transport_node, "DrawMode", proj.transport_draw_mode);
-    if (ver < version::v_12_0_0) {
-        xml_get_node_and_value(_transport_node, "ComputerKeyboardIsEnabled", proj.transport_computer_keyboard_is_enabled.emplace());
+    template <fmtals::version Version>
+    static void export_node(xml_document& document, xml_node* node, const fmtals::project::clip_slot&, const export_context&)
+    {
+        xml_create_node(document, node, "Value");
+    }
+};
+
+/// @brief Binds the clip slots of a track. Clips are kept as the XML text found in the set and
+/// parsed again into the slot on export, with the color of the slot written in the format of the
+/// exported version
+struct schema::clip_slots_binding {
+    template <fmtals::version Version>
+    static void import_node(const xml_node* node, fmtals::project::editable_track& track, const import_context& context)
+    {
+        constexpr std::string_view _element = "ClipSlot";
+        std::size_t _count = 0;
+        for (const xml_node* _slot_node = node->first_node(_element.data(), _element.size()); _slot_node; _slot_node = _slot_node->next_sibling(_element.data(), _element.size())) {
+            ++_count;
+        }
+        track.clip_slots.resize(_count);
+        track.session_clips.clear();
+        std::size_t _slot_index = 0;
+        for (const xml_node* _slot_node = node->first_node(_element.data(), _element.size()); _slot_node; _slot_node = _slot_node->next_sibling(_element.data(), _element.size())) {
+            fmtals::project::clip_slot& _slot = track.clip_slots[_slot_index++];
+            import_fields<Version, schema::clip_slot_accessor>(_slot_node, _slot, context);
+            _slot.clip_index = 0;
+            if (_slot.has_clip) {
+                const xml_node* _slot_cursor = nullptr;
+                const xml_node* _value_cursor = nullptr;
+                const xml_node* _value_node = xml_get_node(xml_get_node(_slot_node, _element, _slot_cursor), "Value", _value_cursor);
+                _slot.clip_index = static_cast<std::uint32_t>(track.session_clips.size());
+                xml_print(track.session_clips.emplace_back(), _value_node->first_node());
+            }
+        }
     }
 
-    xml_node* _song_master_values_node = xml_get_node(_liveset_node, "SongMasterValues");
-    xml_node* _session_scroller_pos_node = xml_get_node(_song_master_values_node, "SessionScrollerPos");
-    xml_get_value(_session_scroller_pos_node, "X", proj.song_master_values_scroller_pos_x);
-    xml_get_value(_session_scroller_pos_node, "Y", proj.song_master_values_scroller_pos_y);
+    template <fmtals::version Version>
+    static void export_node(xml_document& document, xml_node* node, const fmtals::project::editable_track& track, const export_context& context)
+    {
+        for (const fmtals::project::clip_slot& _slot : track.clip_slots) {
+            xml_node* _slot_node = xml_create_node(document, node, "ClipSlot");
+            export_fields<Version, schema::clip_slot_accessor>(document, _slot_node, _slot, context);
+            if (!_slot.has_clip) {
+                continue;
+            }
+            if (_slot.clip_index >= track.session_clips.size()) {
+                throw std::runtime_error("Invalid session clip index");
+            }
+            const std::pmr::string& _clip = track.session_clips[_slot.clip_index];
+            xml_node* _value_node = _slot_node->first_node("ClipSlot")->first_node("Value");
+            xml_parse_children(document, _value_node, document.allocate_string(_clip.data(), _clip.size()), _clip.size());
+            if (xml_node* _clip_node = _value_node->first_node()) {
+                if constexpr (Version >= fmtals::version::v_12_0_0) {
+                    export_color(document, _clip_node, "Color", _slot.clip_color);
+                } else {
+                    export_color(document, _clip_node, "ColorIndex", _slot.clip_color_index);
+                }
+            }
+        }
+    }
 
-    xml_get_node_and_value(_liveset_node, "GlobalQuantisation", proj.global_quantisation);
-    xml_get_node_and_value(_liveset_node, "AutoQuantisation", proj.auto_quantisation);
+    /// @brief Replaces the Color or ColorIndex node of a clip with the color of its slot, so that
+    /// migrated colors are exported. The clip is left as it is when the slot holds no color
+    static void export_color(xml_document& document, xml_node* clip_node, const std::string_view name, const std::optional<std::uint32_t>& color)
+    {
+        if (!color) {
+            return;
+        }
+        xml_node* _color_node = clip_node->first_node("Color");
+        if (!_color_node) {
+            _color_node = clip_node->first_node("ColorIndex");
+        }
+        if (!_color_node) {
+            return;
+        }
+        _color_node->name(name.data(), name.size());
+        _color_node->remove_all_attributes();
+        xml_create_value(document, _color_node, "Value", color);
+    }
+};
+
+/// @brief Binds the descriptor of a plugin device to the info node of its plugin format. Audio
+/// Unit descriptors are not part of the project and leave both formats empty
+struct schema::plugin_desc_binding {
+    template <fmtals::version Version>
+    static void import_node(const xml_node* node, fmtals::project::plugin_device& device, const import_context& context)
+    {
+        import_plugin<Version, schema::vst2_plugin_accessor>(node->first_node("VstPluginInfo"), device.vst2, device.get_allocator(), context);
+        import_plugin<Version, schema::vst3_plugin_accessor>(node->first_node("Vst3PluginInfo"), device.vst3, device.get_allocator(), context);
+    }
 
-    xml_node* _grid_node = xml_get_node(_liveset_node, "Grid");
-    xml_get_node_and_value(_grid_node, "FixedNumerator", proj.grid_fixed_numerator);
-    xml_get_node_and_value(_grid_node, "FixedDenominator", proj.grid_fixed_denominator);
-    xml_get_node_and_value(_grid_node, "GridIntervalPixel", proj.grid_grid_interval_pixel);
-    xml_get_node_and_value(_grid_node, "Ntoles", proj.grid_ntoles);
-    xml_get_node_and_value(_grid_node, "SnapToGrid", proj.grid_snap_to_grid);
-    xml_get_node_and_value(_grid_node, "Fixed", proj.grid_fixed);
+    template <fmtals::version Version, typename Accessor, typename Plugin>
+    static void import_plugin(const xml_node* node, std::optional<Plugin>& plugin, const fmtals::project::allocator_type& allocator, const import_context& context)
+    {
+        if (!node) {
+            plugin.reset();
+            return;
+        }
+        if (!plugin || plugin->get_allocator() != allocator) {
+            plugin.emplace(allocator);
+        }
+        import_fields<Version, Accessor>(node, *plugin, context);
+    }
 
-    xml_node* _scale_info_node = xml_get_node(_liveset_node, "ScaleInformation");
-    xml_get_node_and_value(_scale_info_node, "RootNote", proj.scale_information_root_note);
-    xml_get_node_and_value(_scale_info_node, "Name", proj.scale_information_name);
+    template <fmtals::version Version>
+    static void export_node(xml_document& document, xml_node* node, const fmtals::project::plugin_device& device, const export_context& context)
+    {
+        if (device.vst2) {
+            export_fields<Version, schema::vst2_plugin_accessor>(document, xml_create_node(document, node, "VstPluginInfo"), *device.vst2, context);
+        }
+        if (device.vst3) {
+            export_fields<Version, schema::vst3_plugin_accessor>(document, xml_create_node(document, node, "Vst3PluginInfo"), *device.vst3, context);
+        }
+    }
+};
+
+struct schema::vst2_preset_binding {
+    template <fmtals::version Version>
+    static void import_node(const xml_node* node, fmtals::project::vst2_plugin& plugin, const import_context&)
+    {
+        const xml_node* _preset_node = node->first_node("VstPreset");
+        plugin.has_preset = _preset_node;
+        plugin.preset_id = 0;
+        plugin.buffer.clear();
+        if (_preset_node) {
+            xml_get_value(_preset_node, "Id", plugin.preset_id);
+            xml_get_text(_preset_node, "Buffer", plugin.buffer);
+        }
+    }
 
-    xml_get_node_and_value(_liveset_node, "SmpteFormat", proj.smpte_format);
+    template <fmtals::version Version>
+    static void export_node(xml_document& document, xml_node* node, const fmtals::project::vst2_plugin& plugin, const export_context&)
+    {
+        if (plugin.has_preset) {
+            xml_node* _preset_node = xml_create_node(document, node, "VstPreset");
+            xml_create_value(document, _preset_node, "Id", plugin.preset_id);
+            xml_create_text(document, _preset_node, "Buffer", plugin.buffer);
+        }
+    }
+};
+
+struct schema::vst3_preset_binding {
+    template <fmtals::version Version>
+    static void import_node(const xml_node* node, fmtals::project::vst3_plugin& plugin, const import_context&)
+    {
+        const xml_node* _preset_node = node->first_node("Vst3Preset");
+        plugin.has_preset = _preset_node;
+        plugin.preset_id = 0;
+        plugin.processor_state.clear();
+        plugin.controller_state.clear();
+        if (_preset_node) {
+            xml_get_value(_preset_node, "Id", plugin.preset_id);
+            xml_get_text(_preset_node, "ProcessorState", plugin.processor_state);
+            xml_get_text(_preset_node, "ControllerState", plugin.controller_state);
+        }
+    }
 
-    xml_node* _time_selection_node = xml_get_node(_liveset_node, "TimeSelection");
-    xml_get_node_and_value(_time_selection_node, "AnchorTime", proj.time_selection_anchor_time);
-    xml_get_node_and_value(_time_selection_node, "OtherTime", proj.time_selection_other_time);
+    template <fmtals::version Version>
+    static void export_node(xml_document& document, xml_node* node, const fmtals::project::vst3_plugin& plugin, const export_context&)
+    {
+        if (plugin.has_preset) {
+            xml_node* _preset_node = xml_create_node(document, node, "Vst3Preset");
+            xml_create_value(document, _preset_node, "Id", plugin.preset_id);
+            xml_create_text(document, _preset_node, "ProcessorState", plugin.processor_state);
+            xml_create_text(document, _preset_node, "ControllerState", plugin.controller_state);
+        }
+    }
+};
 
-    xml_node* _sequencer_navigator_node = xml_get_node(_liveset_node, "SequencerNavigator");
-    xml_node* _beat_time_helper_node = xml_get_node(_sequencer_navigator_node, "BeatTimeHelper");
-    xml_get_node_and_value(_beat_time_helper_node, "CurrentZoom", proj.sequencer_navigator_current_zoom);
+namespace fmtals {
 
-    xml_node* _scroller_pos_node = xml_get_node(_sequencer_navigator_node, "ScrollerPos");
-    xml_get_value(_scroller_pos_node, "X", proj.sequencer_navigator_scroller_pos_x);
-    xml_get_value(_scroller_pos_node, "Y", proj.sequencer_navigator_scroller_pos_y);
+void import_project(std::istream& stream, project& proj, version& ver)
+{
+    import_project(stream, proj, ver, import_options());
+}
 
-    xml_node* _client_size_node = xml_get_node(_sequencer_navigator_node, "ClientSize");
-    xml_get_value(_client_size_node, "X", proj.sequencer_navigator_client_size_x);
-    xml_get_value(_client_size_node, "Y", proj.sequencer_navigator_client_size_y);
+void import_project(std::istream& stream, project& proj, version& ver, const import_options& options)
+{
+    std::pmr::memory_resource* _resource = options.resource ? options.resource : std::pmr::get_default_resource();
+    xml_document _xml_doc;
+    const xml_resource_scope _resource_scope = xml_set_resource(_xml_doc, _resource);
+    std::pmr::string _xml_data(_resource);
+    gz_decompress(stream, _xml_data);
+    xml_parse(_xml_doc, _xml_data.data(), _xml_data.size());
 
-    if (ver < version::v_12_0_0) {
-        xml_get_node_and_value(_liveset_node, "ViewStateLaunchPanel", proj.view_state_launch_panel.emplace());
-        xml_get_node_and_value(_liveset_node, "ViewStateEnvelopePanel", proj.view_state_envelope_panel.emplace());
-        xml_get_node_and_value(_liveset_node, "ViewStateSamplePanel", proj.view_state_sample_panel.emplace());
+    const xml_node* _ableton_node = _xml_doc.first_node("Ableton");
+    if (!_ableton_node) {
+        throw std::runtime_error("Missing XML node: Ableton");
     }
-
-    if (ver < version::v_12_0_0) {
-        xml_node* _content_splitter_node = xml_get_node(_liveset_node, "ContentSplitterProperties");
-        xml_get_node_and_value(_content_splitter_node, "Open", proj.content_splitter_properties_open.emplace());
-        xml_get_node_and_value(_content_splitter_node, "Size", proj.content_splitter_properties_size.emplace());
-    }
-
-    xml_get_node_and_value(_liveset_node, "ViewStateFxSlotCount", proj.view_state_fx_slot_count);
-    xml_get_node_and_value(_liveset_node, "ViewStateSessionMixerHeight", proj.view_state_session_mixer_height);
-
-    xml_node* _locators_node = xml_get_node(_liveset_node, "Locators");
-    xml_node* _locators_inner_node = xml_get_node(_locators_node, "Locators");
-    // locators TODO
-    (void)_locators_inner_node;
-
-    xml_node* _detail_clip_keys_midi_node = xml_get_node(_liveset_node, "DetailClipKeyMidis");
-    // detail clip keys midi TODO
-    (void)_detail_clip_keys_midi_node;
-
-    xml_node* _tracks_list_wrapper_node = xml_get_node(_liveset_node, "TracksListWrapper");
-    xml_get_value(_tracks_list_wrapper_node, "LomId", proj.tracks_list_wrapper_lom_id);
-
-    xml_node* _visible_tracks_list_wrapper_node = xml_get_node(_liveset_node, "VisibleTracksListWrapper");
-    xml_get_value(_visible_tracks_list_wrapper_node, "LomId", proj.visible_tracks_list_wrapper_lom_id);
-
-    xml_node* _return_tracks_list_wrapper_node = xml_get_node(_liveset_node, "ReturnTracksListWrapper");
-    xml_get_value(_return_tracks_list_wrapper_node, "LomId", proj.return_tracks_list_wrapper_lom_id);
-
-    xml_node* _scenes_list_wrapper_node = xml_get_node(_liveset_node, "ScenesListWrapper");
-    xml_get_value(_scenes_list_wrapper_node, "LomId", proj.scenes_list_wrapper_lom_id);
-
-    xml_node* _cue_points_list_wrapper_node = xml_get_node(_liveset_node, "CuePointsListWrapper");
-    xml_get_value(_cue_points_list_wrapper_node, "LomId", proj.cue_points_list_wrapper_lom_id);
-
-    xml_get_node_and_value(_liveset_node, "ChooserBar", proj.chooser_bar);
-    xml_get_node_and_value(_liveset_node, "Annotation", proj.annotation);
-    xml_get_node_and_value(_liveset_node, "SoloOrPflSavedValue", proj.solo_or_pfl_saved_value);
-    xml_get_node_and_value(_liveset_node, "SoloInPlace", proj.solo_in_place);
-    xml_get_node_and_value(_liveset_node, "CrossfadeCurve", proj.crossfade_curve);
-    xml_get_node_and_value(_liveset_node, "LatencyCompensation", proj.latency_compensation);
-    xml_get_node_and_value(_liveset_node, "HighlightedTrackIndex", proj.highlighted_track_index);
-
-    xml_node* _groove_pool_node = xml_get_node(_liveset_node, "GroovePool");
-    xml_node* _grooves_node = xml_get_node(_groove_pool_node, "Grooves");
-    // grooves TODO
-    (void)_grooves_node;
-
-    xml_get_node_and_value(_liveset_node, "ArrangementOverdub", proj.arrangement_overdub);
-    xml_get_node_and_value(_liveset_node, "ColorSequenceIndex", proj.color_sequence_index);
-
-    xml_node* _acpf_player_and_group_tracks_node = xml_get_node(_liveset_node, "AutoColorPickerForPlayerAndGroupTracks");
-    xml_get_node_and_value(_acpf_player_and_group_tracks_node, "NextColorIndex", proj.auto_color_picker_for_player_and_group_tracks);
-
-    xml_node* _acpf_return_and_master_tracks_node = xml_get_node(_liveset_node, "AutoColorPickerForReturnAndMasterTracks");
-    xml_get_node_and_value(_acpf_return_and_master_tracks_node, "NextColorIndex", proj.auto_color_picker_for_return_and_master_tracks);
-
-    xml_get_node_and_value(_liveset_node, "ViewData", proj.view_data);
-    xml_get_node_and_value(_liveset_node, "UseWarperLegacyHiQMode", proj.use_warper_legacy_hiq_mode);
-
-    xml_node* _video_window_rect_node = xml_get_node(_liveset_node, "VideoWindowRect");
-    xml_get_value(_video_window_rect_node, "Top", proj.video_window_rect_top);
-    xml_get_value(_video_window_rect_node, "Left", proj.video_window_rect_left);
-    xml_get_value(_video_window_rect_node, "Bottom", proj.video_window_rect_bottom);
-    xml_get_value(_video_window_rect_node, "Right", proj.video_window_rect_right);
-
-    xml_get_node_and_value(_liveset_node, "ShowVideoWindow", proj.show_video_window);
-    xml_get_node_and_value(_liveset_node, "TrackHeaderWidth", proj.track_header_width);
-    xml_get_node_and_value(_liveset_node, "ViewStateArrangerHasDetail", proj.view_state_arranger_has_detail);
-    xml_get_node_and_value(_liveset_node, "ViewStateSessionHasDetail", proj.view_state_session_has_detail);
-    xml_get_node_and_value(_liveset_node, "ViewStateDetailIsSample", proj.view_state_detail_is_sample);
-
-    xml_node* _view_states_node = xml_get_node(_liveset_node, "ViewStates");
-    xml_get_node_and_value(_view_states_node, "SessionIO", proj.view_states_session_io);
-    xml_get_node_and_value(_view_states_node, "SessionSends", proj.view_states_session_sends);
-    xml_get_node_and_value(_view_states_node, "SessionReturns", proj.view_states_session_returns);
-    xml_get_node_and_value(_view_states_node, "SessionMixer", proj.view_states_session_mixer);
-    xml_get_node_and_value(_view_states_node, "SessionTrackDelay", proj.view_states_session_track_delay);
-    xml_get_node_and_value(_view_states_node, "SessionCrossFade", proj.view_states_session_cross_fade);
-    xml_get_node_and_value(_view_states_node, "SessionShowOverView", proj.view_states_session_show_over_view);
-    xml_get_node_and_value(_view_states_node, "ArrangerIO", proj.view_states_arranger_io);
-    xml_get_node_and_value(_view_states_node, "ArrangerReturns", proj.view_states_arranger_returns);
-    xml_get_node_and_value(_view_states_node, "ArrangerMixer", proj.view_states_arranger_mixer);
-    xml_get_node_and_value(_view_states_node, "ArrangerTrackDelay", proj.view_states_arranger_track_delay);
-    xml_get_node_and_value(_view_states_node, "ArrangerShowOverView", proj.view_states_arranger_show_over_view);
+    std::string _creator;
+    xml_get_value(_ableton_node, "Creator", _creator);
+    ver = detect_version(_creator);
+    import_context _context;
+    _context.jobs = options.jobs;
+    _context.resource = _resource;
+    visit_version(ver, [&](auto _version) {
+        import_fields<decltype(_version)::value, schema::project_accessor>(_ableton_node, proj, _context);
+    });
+
+    // not bound by the schema yet
+    proj.return_tracks.clear();
+    proj.project_master_track.id = 0;
+    proj.project_prehear_track.id = 0;
+    proj.transport_metronome_tick_duration.reset();
+    proj.in_key.reset();
+    proj.is_content_splitter_open.reset();
+    proj.is_expression_splitter_open.reset();
+    proj.locators.clear();
+    proj.groove_pool.clear();
 }
 
 void export_project(std::ostream& stream, const project& proj, const version& ver)
 {
+    export_project(stream, proj, ver, export_options());
+}
+
+void export_project(std::ostream& stream, const project& proj, const version& ver, const export_options& options)
+{
+    std::pmr::memory_resource* _resource = options.resource ? options.resource : std::pmr::get_default_resource();
     xml_document _xml_doc;
-    xml_node* _declaration_node = xml_create_node(_xml_doc, nullptr, std::string(), cereal::rapidxml::node_declaration);
+    const xml_resource_scope _resource_scope = xml_set_resource(_xml_doc, _resource);
+    xml_node* _declaration_node = xml_create_node(_xml_doc, nullptr, std::string_view(), cereal::rapidxml::node_declaration);
     xml_create_value(_xml_doc, _declaration_node, "version", std::string("1.0"));
     xml_create_value(_xml_doc, _declaration_node, "encoding", std::string("UTF-8"));
 
+    // tracks are independent subtrees, in parallel mode each one is built and printed in its own
+    // document and spliced in place of the placeholder so that the output is identical
+    const bool _parallel = parallel_jobs(options.jobs) > 1 && proj.tracks.size() > 1;
     xml_node* _ableton_node = xml_create_node(_xml_doc, nullptr, "Ableton");
-    xml_create_value(_xml_doc, _ableton_node, "MajorVersion", proj.major_version);
-    xml_create_value(_xml_doc, _ableton_node, "MinorVersion", proj.minor_version);
-    if (ver >= version::v_11_0_0) {
-        xml_create_value(_xml_doc, _ableton_node, "SchemaChangeCount", proj.schema_change_count.value());
+    export_context _context;
+    _context.track_placeholder = _parallel;
+    visit_version(ver, [&](auto _version) {
+        export_fields<decltype(_version)::value, schema::project_accessor>(_xml_doc, _ableton_node, proj, _context);
+    });
+    std::pmr::string _xml_data(_resource);
+    xml_print(_xml_data, &_xml_doc);
+    if (!_parallel) {
+        gz_compress(stream, _xml_data);
+        return;
     }
-    xml_create_value(_xml_doc, _ableton_node, "Creator", proj.creator);
-    xml_create_value(_xml_doc, _ableton_node, "Revision", proj.revision);
 
-    xml_node* _liveset_node = xml_create_node(_xml_doc, _ableton_node, "LiveSet");
-    xml_create_node_and_value(_xml_doc, _liveset_node, "OverwriteProtectionNumber", proj.overwrite_protection_number);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "LomId", proj.lom_id);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "LomIdView", proj.lom_id_view);
-
-    xml_node* _tracks_node = xml_create_node(_xml_doc, _liveset_node, "Tracks");
-    for (const project::user_track& _track : proj.tracks) {
+    // the placeholder line is the only comment of the document, attribute values escape '<'
+    const std::size_t _placeholder_offset = _xml_data.find("<!--");
+    const std::size_t _line_begin = _xml_data.find_last_not_of('\t', _placeholder_offset - 1) + 1;
+    const std::size_t _line_end = _xml_data.find('\n', _placeholder_offset) + 1;
+    const std::size_t _indent = _placeholder_offset - _line_begin;
+    // the documents and buffers of the tracks are allocated from every worker at once, through a
+    // synchronized pool when the resource of the call cannot be shared between threads
+    std::optional<std::pmr::synchronized_pool_resource> _synchronized_resource;
+    std::pmr::memory_resource* _tracks_resource = _resource;
+    if (!fmtals::is_thread_safe_resource(_resource)) {
+        _tracks_resource = &_synchronized_resource.emplace(_resource);
+    }
+    std::pmr::vector<std::pmr::string> _tracks_data(proj.tracks.size(), _tracks_resource);
+    visit_version(ver, [&](auto _version) {
+        parallel_for(
+            proj.tracks.size(), options.jobs, []() { return xml_document(); },
+            [&](xml_document& document, const std::size_t index) {
+                document.clear();
+                const xml_resource_scope _resource_scope = xml_set_resource(document, _tracks_resource);
+                const xml_node* _track_node = schema::tracks_binding::export_track<decltype(_version)::value>(document, nullptr, proj.tracks[index], export_context());
+                xml_print(_tracks_data[index], _track_node, _indent);
+            });
+    });
 
-        xml_node* _track_node = xml_create_node(_xml_doc, _tracks_node, "AudioTrack");
+    // compress
+    std::pmr::vector<std::string_view> _pieces(_resource);
+    _pieces.reserve(_tracks_data.size() + 2);
+    _pieces.emplace_back(_xml_data.data(), _line_begin);
+    for (const std::pmr::string& _track_data : _tracks_data) {
+        _pieces.emplace_back(_track_data);
+    }
+    _pieces.emplace_back(_xml_data.data() + _line_end, _xml_data.size() - _line_end);
+    std::size_t _piece_index = 0;
+    std::size_t _piece_offset = 0;
+    gz_compress(
+        stream, [&](char* chunk, const std::size_t size) {
+            std::size_t _n_read = 0;
+            while (_n_read < size && _piece_index < _pieces.size()) {
+                const std::size_t _count = std::min(size - _n_read, _pieces[_piece_index].size() - _piece_offset);
+                std::copy_n(_pieces[_piece_index].data() + _piece_offset, _count, chunk + _n_read);
+                _n_read += _count;
+                _piece_offset += _count;
+                if (_piece_offset == _pieces[_piece_index].size()) {
+                    ++_piece_index;
+                    _piece_offset = 0;
+                }
+            }
+            return _n_read;
+        },
+        _resource);
+}
 
+void adopt_project_allocator(project& proj)
+{
+    allocator_archive _archive { proj.get_allocator() };
+    serialize_settings(_archive, proj);
+    for (project::user_track& _track : proj.tracks) {
         std::visit([&](auto& _track_visit) {
             using _track_type_t = std::decay_t<decltype(_track_visit)>;
-
-            xml_create_value(_xml_doc, _track_node, "Id", _track_visit.id);
-            export_track_base(_xml_doc, _track_node, _track_visit, ver);
-            xml_create_node_and_value(_xml_doc, _track_node, "SavedPlayingSlot", _track_visit.saved_playing_slot);
-            xml_create_node_and_value(_xml_doc, _track_node, "SavedPlayingOffset", _track_visit.saved_playing_offset);
-            xml_create_node_and_value(_xml_doc, _track_node, "MidiFoldIn", _track_visit.midi_fold_in); // 9 only
-            xml_create_node_and_value(_xml_doc, _track_node, "MidiPrelisten", _track_visit.midi_prelisten); // 9 only
-            xml_create_node_and_value(_xml_doc, _track_node, "Freeze", _track_visit.freeze);
-            xml_create_node_and_value(_xml_doc, _track_node, "VelocityDetail", _track_visit.velocity_detail);
-            xml_create_node_and_value(_xml_doc, _track_node, "NeedArrangerRefreeze", _track_visit.need_arranger_refreeze);
-            xml_create_node_and_value(_xml_doc, _track_node, "PostProcessFreezeClips", _track_visit.post_process_freeze_clips);
-            xml_create_node_and_value(_xml_doc, _track_node, "MidiTargetPrefersFoldOrIsNotUniform", _track_visit.midi_target_prefers_fold_or_is_not_uniform);
-
-            // device chain
-            xml_node* _device_chain_node = xml_create_node(_xml_doc, _track_node, "DeviceChain");
-
-            xml_node* _automation_lanes_node = xml_create_node(_xml_doc, _device_chain_node, "AutomationLanes");
-            xml_node* _automation_lanes_child_node = xml_create_node(_xml_doc, _automation_lanes_node, "AutomationLanes");
-            for (const project::automation_lane _automation_lane : _track_visit.automation_lanes) {
-                xml_node* _automation_lane_node = xml_create_node(_xml_doc, _automation_lanes_child_node, "AutomationLane");
-                xml_create_node_and_value(_xml_doc, _automation_lane_node, "SelectedDevice", _automation_lane.selected_device);
-                xml_create_node_and_value(_xml_doc, _automation_lane_node, "SelectedEnvelope", _automation_lane.selected_envelope);
-                xml_create_node_and_value(_xml_doc, _automation_lane_node, "IsContentSelected", _automation_lane.is_content_selected);
-                xml_create_node_and_value(_xml_doc, _automation_lane_node, "LaneHeight", _automation_lane.lane_height);
-                xml_create_node_and_value(_xml_doc, _automation_lane_node, "FadeViewVisible", _automation_lane.fade_view_visible);
+            if (_track_visit.get_allocator() != _archive.allocator) {
+                _track_type_t _adopted_track(std::move(_track_visit), _archive.allocator);
+                _track.template emplace<_track_type_t>(std::move(_adopted_track));
             }
-            xml_create_node_and_value(_xml_doc, _automation_lanes_node, "PermanentLanesAreVisible", _track_visit.permanent_lanes_are_visible);
-
-            xml_node* _envelope_chooser_node = xml_create_node(_xml_doc, _device_chain_node, "EnvelopeChooser");
-            xml_create_node_and_value(_xml_doc, _envelope_chooser_node, "SelectedDevice", _track_visit.envelope_chooser_selected_device);
-            xml_create_node_and_value(_xml_doc, _envelope_chooser_node, "SelectedEnvelope", _track_visit.envelope_chooser_selected_envelope);
-
-            // // audio input routing
-            // xml_node* _audio_input_routing_node = xml_create_node(_xml_doc, _device_chain_node, "AudioInputRouting");
-            // {
-            //     xml_create_node(_xml_doc, _audio_input_routing_node, "Target", { { "Value", "AudioIn/External/M0" } });
-            //     xml_create_node(_xml_doc, _audio_input_routing_node, "UpperDisplayString", { { "Value", "Ext. In" } });
-            //     xml_create_node(_xml_doc, _audio_input_routing_node, "LowerDisplayString", { { "Value", "1" } });
-
-            //     // mpe settings
-            //     xml_node* _mpe_settings_node = xml_create_node(_xml_doc, _audio_input_routing_node, "MpeSettings");
-            //     {
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "ZoneType", { { "Value", "0" } });
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "FirstNoteChannel", { { "Value", "1" } });
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "LastNoteChannel", { { "Value", "15" } });
-            //     }
-            // }
-
-            // // midi input routing
-            // xml_node* _midi_input_routing_node = xml_create_node(_xml_doc, _device_chain_node, "MidiInputRouting");
-            // {
-            //     xml_create_node(_xml_doc, _midi_input_routing_node, "Target", { { "Value", "MidiIn/External.All/-1" } });
-            //     xml_create_node(_xml_doc, _midi_input_routing_node, "UpperDisplayString", { { "Value", "Ext: All Ins" } });
-            //     xml_create_node(_xml_doc, _midi_input_routing_node, "LowerDisplayString", { { "Value", "" } });
-
-            //     // mpe settings
-            //     xml_node* _mpe_settings_node = xml_create_node(_xml_doc, _midi_input_routing_node, "MpeSettings");
-            //     {
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "ZoneType", { { "Value", "0" } });
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "FirstNoteChannel", { { "Value", "1" } });
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "LastNoteChannel", { { "Value", "15" } });
-            //     }
-            // }
-
-            // // audio output routing
-            // xml_node* _audio_output_routing_node = xml_create_node(_xml_doc, _device_chain_node, "AudioOutputRouting");
-            // {
-            //     xml_create_node(_xml_doc, _audio_output_routing_node, "Target", { { "Value", "AudioOut/Main" } });
-            //     xml_create_node(_xml_doc, _audio_output_routing_node, "UpperDisplayString", { { "Value", "Main" } });
-            //     xml_create_node(_xml_doc, _audio_output_routing_node, "LowerDisplayString", { { "Value", "" } });
-
-            //     // mpe settings
-            //     xml_node* _mpe_settings_node = xml_create_node(_xml_doc, _audio_output_routing_node, "MpeSettings");
-            //     {
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "ZoneType", { { "Value", "0" } });
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "FirstNoteChannel", { { "Value", "1" } });
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "LastNoteChannel", { { "Value", "15" } });
-            //     }
-            // }
-
-            // // midi output routing
-            // xml_node* _midi_output_routing_node = xml_create_node(_xml_doc, _device_chain_node, "MidiOutputRouting");
-            // {
-            //     xml_create_node(_xml_doc, _midi_output_routing_node, "Target", { { "Value", "MidiOut/None" } });
-            //     xml_create_node(_xml_doc, _midi_output_routing_node, "UpperDisplayString", { { "Value", "None" } });
-            //     xml_create_node(_xml_doc, _midi_output_routing_node, "LowerDisplayString", { { "Value", "" } });
-
-            //     // mpe settings
-            //     xml_node* _mpe_settings_node = xml_create_node(_xml_doc, _midi_output_routing_node, "MpeSettings");
-            //     {
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "ZoneType", { { "Value", "0" } });
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "FirstNoteChannel", { { "Value", "1" } });
-            //         xml_create_node(_xml_doc, _mpe_settings_node, "LastNoteChannel", { { "Value", "15" } });
-            //     }
-            // }
-
-            // mixer
-            xml_node* _mixer_node = xml_create_node(_xml_doc, _device_chain_node, "Mixer");
         },
             _track);
+        std::visit([&](auto& _track_visit) { allocator_add_track(_archive, _track_visit); }, _track);
     }
-
-    // master/main track
-    xml_node* _master_track_node;
-    if (ver >= version::v_12_0_0) {
-        _master_track_node = xml_create_node(_xml_doc, _liveset_node, "MainTrack");
-    } else {
-        _master_track_node = xml_create_node(_xml_doc, _liveset_node, "MasterTrack");
+    for (project::return_track& _track : proj.return_tracks) {
+        allocator_add_track(_archive, _track);
     }
-    export_track_base(_xml_doc, _master_track_node, proj.project_master_track, ver);
-
-    // todo device chain
+    allocator_add_track(_archive, proj.project_master_track);
+    allocator_add_track(_archive, proj.project_prehear_track);
+    _archive(proj.scene_names);
+}
 
-    // prehear track
-    xml_node* _pre_hear_track_node = xml_create_node(_xml_doc, _liveset_node, "PreHearTrack");
-    export_track_base(_xml_doc, _pre_hear_track_node, proj.project_prehear_track, ver);
+void migrate_project(project& proj, const version& ver)
+{
+    const std::uint32_t _major = static_cast<std::uint32_t>(ver) / 100 - 100;
+    const std::uint32_t _minor = static_cast<std::uint32_t>(ver) / 10 % 10;
+    const std::uint32_t _patch = static_cast<std::uint32_t>(ver) % 10;
+    proj.creator = "Ableton Live " + std::to_string(_major) + "." + std::to_string(_minor) + "." + std::to_string(_patch);
+    proj.minor_version.replace(0, std::min(proj.minor_version.find('_'), proj.minor_version.size()), std::to_string(_major) + "." + std::to_string(_minor));
 
-    // sends pre
-    xml_node* _sends_pre_node = xml_create_node(_xml_doc, _liveset_node, "SendsPre");
-    for (const bool _send_pre : proj.sends_pre) {
-        xml_create_node_and_value(_xml_doc, _sends_pre_node, "SendPreBool", _send_pre);
+    if (ver >= version::v_11_0_0) {
+        if (!proj.schema_change_count) {
+            proj.schema_change_count.emplace("1", proj.get_allocator());
+        }
+    } else {
+        proj.schema_change_count.reset();
     }
 
-    xml_node* _scene_names_node = xml_create_node(_xml_doc, _liveset_node, "SceneNames");
-    for (const project::scene& _scene : proj.scene_names) {
-        xml_node* _scene_node = xml_create_node(_xml_doc, _scene_names_node, "Scene");
-        xml_create_value(_xml_doc, _scene_node, "Value", _scene.value);
-        xml_create_node_and_value(_xml_doc, _scene_node, "Annotation", _scene.annotation);
-        xml_create_node_and_value(_xml_doc, _scene_node, "ColorIndex", _scene.color_index);
-        xml_create_node_and_value(_xml_doc, _scene_node, "LomId", _scene.lom_id);
-
-        xml_node* _clip_slots_list_wrapper_node = xml_create_node(_xml_doc, _scene_node, "ClipSlotsListWrapper");
-        xml_create_value(_xml_doc, _clip_slots_list_wrapper_node, "LomId", _scene.clip_slots_list_wrapper_lom_id);
+    const auto _migrate_color = [&](std::optional<std::uint32_t>& color, std::optional<std::uint32_t>& color_index) {
+        if (ver >= version::v_12_0_0) {
+            color.emplace(color.value_or(color_index.value_or(0)));
+            color_index.reset();
+        } else {
+            color_index.emplace(color_index.value_or(color.value_or(0)));
+            color.reset();
+        }
+    };
+    const auto _migrate_track = [&](project::base_track& track) {
+        _migrate_color(track.color, track.color_index);
+        if (ver >= version::v_11_0_0) {
+            if (!track.memorized_first_clip_name) {
+                track.memorized_first_clip_name.emplace(track.get_allocator());
+            }
+        } else {
+            track.memorized_first_clip_name.reset();
+        }
+    };
+    for (project::user_track& _track : proj.tracks) {
+        std::visit([&](auto& _track_visit) {
+            using _track_type_t = std::decay_t<decltype(_track_visit)>;
+            _migrate_track(_track_visit);
+            if constexpr (std::is_same_v<_track_type_t, project::audio_track>) {
+                for (project::audio_clip& _audio_clip : _track_visit.events_audio_clips) {
+                    _migrate_color(_audio_clip.color, _audio_clip.color_index);
+                }
+            }
+            for (project::clip_slot& _clip_slot : _track_visit.clip_slots) {
+                if (_clip_slot.has_clip) {
+                    _migrate_color(_clip_slot.clip_color, _clip_slot.clip_color_index);
+                }
+            }
+        },
+            _track);
     }
-
-    xml_node* _transport_node = xml_create_node(_xml_doc, _liveset_node, "Transport");
-    xml_create_node_and_value(_xml_doc, _transport_node, "PhaseNudgeTempo", proj.transport_phase_nudge_tempo);
-    xml_create_node_and_value(_xml_doc, _transport_node, "LoopOn", proj.transport_loop_on);
-    xml_create_node_and_value(_xml_doc, _transport_node, "LoopStart", proj.transport_loop_start);
-    xml_create_node_and_value(_xml_doc, _transport_node, "LoopLength", proj.transport_loop_length);
-    xml_create_node_and_value(_xml_doc, _transport_node, "LoopIsSongStart", proj.transport_loop_is_song_start);
-    xml_create_node_and_value(_xml_doc, _transport_node, "CurrentTime", proj.transport_current_time);
-    xml_create_node_and_value(_xml_doc, _transport_node, "PunchIn", proj.transport_punch_in);
-    xml_create_node_and_value(_xml_doc, _transport_node, "PunchOut", proj.transport_punch_out);
-    xml_create_node_and_value(_xml_doc, _transport_node, "DrawMode", proj.transport_draw_mode);
-    if (ver < version::v_12_0_0) {
-        xml_create_node_and_value(_xml_doc, _transport_node, "ComputerKeyboardIsEnabled", proj.transport_computer_keyboard_is_enabled.value());
+    for (project::return_track& _return_track : proj.return_tracks) {
+        _migrate_track(_return_track);
     }
-
-    xml_node* _song_master_values_node = xml_create_node(_xml_doc, _liveset_node, "SongMasterValues");
-    xml_node* _session_scroller_pos_node = xml_create_node(_xml_doc, _song_master_values_node, "SessionScrollerPos");
-    xml_create_value(_xml_doc, _session_scroller_pos_node, "X", proj.song_master_values_scroller_pos_x);
-    xml_create_value(_xml_doc, _session_scroller_pos_node, "Y", proj.song_master_values_scroller_pos_y);
-
-    xml_create_node_and_value(_xml_doc, _liveset_node, "GlobalQuantisation", proj.global_quantisation);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "AutoQuantisation", proj.auto_quantisation);
-
-    xml_node* _grid_node = xml_create_node(_xml_doc, _liveset_node, "Grid");
-    xml_create_node_and_value(_xml_doc, _grid_node, "FixedNumerator", proj.grid_fixed_numerator);
-    xml_create_node_and_value(_xml_doc, _grid_node, "FixedDenominator", proj.grid_fixed_denominator);
-    xml_create_node_and_value(_xml_doc, _grid_node, "GridIntervalPixel", proj.grid_grid_interval_pixel);
-    xml_create_node_and_value(_xml_doc, _grid_node, "Ntoles", proj.grid_ntoles);
-    xml_create_node_and_value(_xml_doc, _grid_node, "SnapToGrid", proj.grid_snap_to_grid);
-    xml_create_node_and_value(_xml_doc, _grid_node, "Fixed", proj.grid_fixed);
-
-    xml_node* _scale_info_node = xml_create_node(_xml_doc, _liveset_node, "ScaleInformation");
-    xml_create_node_and_value(_xml_doc, _scale_info_node, "RootNote", proj.scale_information_root_note);
-    xml_create_node_and_value(_xml_doc, _scale_info_node, "Name", proj.scale_information_name);
-
-    xml_create_node_and_value(_xml_doc, _liveset_node, "SmpteFormat", proj.smpte_format);
-
-    xml_node* _time_selection_node = xml_create_node(_xml_doc, _liveset_node, "TimeSelection");
-    xml_create_node_and_value(_xml_doc, _time_selection_node, "AnchorTime", proj.time_selection_anchor_time);
-    xml_create_node_and_value(_xml_doc, _time_selection_node, "OtherTime", proj.time_selection_other_time);
-
-    xml_node* _sequencer_navigator_node = xml_create_node(_xml_doc, _liveset_node, "SequencerNavigator");
-    xml_node* _beat_time_helper_node = xml_create_node(_xml_doc, _sequencer_navigator_node, "BeatTimeHelper");
-    xml_create_node_and_value(_xml_doc, _beat_time_helper_node, "CurrentZoom", proj.sequencer_navigator_current_zoom);
-    xml_node* _scroller_pos_node = xml_create_node(_xml_doc, _sequencer_navigator_node, "ScrollerPos");
-    xml_create_value(_xml_doc, _scroller_pos_node, "X", proj.sequencer_navigator_scroller_pos_x);
-    xml_create_value(_xml_doc, _scroller_pos_node, "Y", proj.sequencer_navigator_scroller_pos_y);
-    xml_node* _client_size_node = xml_create_node(_xml_doc, _sequencer_navigator_node, "ClientSize");
-    xml_create_value(_xml_doc, _client_size_node, "X", proj.sequencer_navigator_client_size_x);
-    xml_create_value(_xml_doc, _client_size_node, "Y", proj.sequencer_navigator_client_size_y);
+    _migrate_track(proj.project_master_track);
+    _migrate_track(proj.project_prehear_track);
 
     if (ver < version::v_12_0_0) {
-        xml_create_node_and_value(_xml_doc, _liveset_node, "ViewStateLaunchPanel", proj.view_state_launch_panel.value());
-        xml_create_node_and_value(_xml_doc, _liveset_node, "ViewStateEnvelopePanel", proj.view_state_envelope_panel.value());
-        xml_create_node_and_value(_xml_doc, _liveset_node, "ViewStateSamplePanel", proj.view_state_sample_panel.value());
+        proj.transport_computer_keyboard_is_enabled.emplace(proj.transport_computer_keyboard_is_enabled.value_or(false));
+        proj.view_state_launch_panel.emplace(proj.view_state_launch_panel.value_or(false));
+        proj.view_state_envelope_panel.emplace(proj.view_state_envelope_panel.value_or(false));
+        proj.view_state_sample_panel.emplace(proj.view_state_sample_panel.value_or(false));
+        proj.content_splitter_properties_open.emplace(proj.content_splitter_properties_open.value_or(false));
+        proj.content_splitter_properties_size.emplace(proj.content_splitter_properties_size.value_or(0));
+    } else {
+        proj.transport_computer_keyboard_is_enabled.reset();
+        proj.view_state_launch_panel.reset();
+        proj.view_state_envelope_panel.reset();
+        proj.view_state_sample_panel.reset();
+        proj.content_splitter_properties_open.reset();
+        proj.content_splitter_properties_size.reset();
     }
-
-    if (ver < version::v_12_0_0) {
-        xml_node* _content_splitter_node = xml_create_node(_xml_doc, _liveset_node, "ContentSplitterProperties");
-        xml_create_node_and_value(_xml_doc, _content_splitter_node, "Open", proj.content_splitter_properties_open.value());
-        xml_create_node_and_value(_xml_doc, _content_splitter_node, "Size", proj.content_splitter_properties_size.value());
-    }
-
-    xml_create_node_and_value(_xml_doc, _liveset_node, "ViewStateFxSlotCount", proj.view_state_fx_slot_count);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "ViewStateSessionMixerHeight", proj.view_state_session_mixer_height);
-
-    xml_node* _locators_node = xml_create_node(_xml_doc, _liveset_node, "Locators");
-    xml_node* _locators_inner_node = xml_create_node(_xml_doc, _locators_node, "Locators");
-    // locators TODO
-    (void)_locators_inner_node;
-
-    xml_node* _detail_clip_keys_midi_node = xml_create_node(_xml_doc, _liveset_node, "DetailClipKeyMidis");
-    // detail clip keys midi TODO
-    (void)_detail_clip_keys_midi_node;
-
-    xml_node* _tracks_list_wrapper_node = xml_create_node(_xml_doc, _liveset_node, "TracksListWrapper");
-    xml_create_value(_xml_doc, _tracks_list_wrapper_node, "LomId", proj.tracks_list_wrapper_lom_id);
-
-    xml_node* _visible_tracks_list_wrapper_node = xml_create_node(_xml_doc, _liveset_node, "VisibleTracksListWrapper");
-    xml_create_value(_xml_doc, _visible_tracks_list_wrapper_node, "LomId", proj.visible_tracks_list_wrapper_lom_id);
-
-    xml_node* _return_tracks_list_wrapper_node = xml_create_node(_xml_doc, _liveset_node, "ReturnTracksListWrapper");
-    xml_create_value(_xml_doc, _return_tracks_list_wrapper_node, "LomId", proj.return_tracks_list_wrapper_lom_id);
-
-    xml_node* _scenes_list_wrapper_node = xml_create_node(_xml_doc, _liveset_node, "ScenesListWrapper");
-    xml_create_value(_xml_doc, _scenes_list_wrapper_node, "LomId", proj.scenes_list_wrapper_lom_id);
-
-    xml_node* _cue_points_list_wrapper_node = xml_create_node(_xml_doc, _liveset_node, "CuePointsListWrapper");
-    xml_create_value(_xml_doc, _cue_points_list_wrapper_node, "LomId", proj.cue_points_list_wrapper_lom_id);
-
-    xml_create_node_and_value(_xml_doc, _liveset_node, "ChooserBar", proj.chooser_bar);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "Annotation", proj.annotation);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "SoloOrPflSavedValue", proj.solo_or_pfl_saved_value);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "SoloInPlace", proj.solo_in_place);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "CrossfadeCurve", proj.crossfade_curve);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "LatencyCompensation", proj.latency_compensation);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "HighlightedTrackIndex", proj.highlighted_track_index);
-
-    xml_node* _groove_pool_node = xml_create_node(_xml_doc, _liveset_node, "GroovePool");
-    xml_node* _grooves_node = xml_create_node(_xml_doc, _groove_pool_node, "Grooves");
-    // grooves TODO
-    (void)_grooves_node;
-
-    xml_create_node_and_value(_xml_doc, _liveset_node, "ArrangementOverdub", proj.arrangement_overdub);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "ColorSequenceIndex", proj.color_sequence_index);
-
-    xml_node* _acpf_player_and_group_tracks_node = xml_create_node(_xml_doc, _liveset_node, "AutoColorPickerForPlayerAndGroupTracks");
-    xml_create_node_and_value(_xml_doc, _acpf_player_and_group_tracks_node, "NextColorIndex", proj.auto_color_picker_for_player_and_group_tracks);
-
-    xml_node* _acpf_return_and_master_tracks_node = xml_create_node(_xml_doc, _liveset_node, "AutoColorPickerForReturnAndMasterTracks");
-    xml_create_node_and_value(_xml_doc, _acpf_return_and_master_tracks_node, "NextColorIndex", proj.auto_color_picker_for_return_and_master_tracks);
-
-    xml_create_node_and_value(_xml_doc, _liveset_node, "ViewData", proj.view_data);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "UseWarperLegacyHiQMode", proj.use_warper_legacy_hiq_mode);
-
-    xml_node* _video_window_rect_node = xml_create_node(_xml_doc, _liveset_node, "VideoWindowRect");
-    xml_create_value(_xml_doc, _video_window_rect_node, "Top", proj.video_window_rect_top);
-    xml_create_value(_xml_doc, _video_window_rect_node, "Left", proj.video_window_rect_left);
-    xml_create_value(_xml_doc, _video_window_rect_node, "Bottom", proj.video_window_rect_bottom);
-    xml_create_value(_xml_doc, _video_window_rect_node, "Right", proj.video_window_rect_right);
-
-    xml_create_node_and_value(_xml_doc, _liveset_node, "ShowVideoWindow", proj.show_video_window);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "TrackHeaderWidth", proj.track_header_width);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "ViewStateArrangerHasDetail", proj.view_state_arranger_has_detail);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "ViewStateSessionHasDetail", proj.view_state_session_has_detail);
-    xml_create_node_and_value(_xml_doc, _liveset_node, "ViewStateDetailIsSample", proj.view_state_detail_is_sample);
-
-    xml_node* _view_states_node = xml_create_node(_xml_doc, _liveset_node, "ViewStates");
-    xml_create_node_and_value(_xml_doc, _view_states_node, "SessionIO", proj.view_states_session_io);
-    xml_create_node_and_value(_xml_doc, _view_states_node, "SessionSends", proj.view_states_session_sends);
-    xml_create_node_and_value(_xml_doc, _view_states_node, "SessionReturns", proj.view_states_session_returns);
-    xml_create_node_and_value(_xml_doc, _view_states_node, "SessionMixer", proj.view_states_session_mixer);
-    xml_create_node_and_value(_xml_doc, _view_states_node, "SessionTrackDelay", proj.view_states_session_track_delay);
-    xml_create_node_and_value(_xml_doc, _view_states_node, "SessionCrossFade", proj.view_states_session_cross_fade);
-    xml_create_node_and_value(_xml_doc, _view_states_node, "SessionShowOverView", proj.view_states_session_show_over_view);
-    xml_create_node_and_value(_xml_doc, _view_states_node, "ArrangerIO", proj.view_states_arranger_io);
-    xml_create_node_and_value(_xml_doc, _view_states_node, "ArrangerReturns", proj.view_states_arranger_returns);
-    xml_create_node_and_value(_xml_doc, _view_states_node, "ArrangerMixer", proj.view_states_arranger_mixer);
-    xml_create_node_and_value(_xml_doc, _view_states_node, "ArrangerTrackDelay", proj.view_states_arranger_track_delay);
-    xml_create_node_and_value(_xml_doc, _view_states_node, "ArrangerShowOverView", proj.view_states_arranger_show_over_view);
-
-    // compress
-    std::string _xml_data;
-    cereal::rapidxml::print(std::back_inserter(_xml_data), _xml_doc);
-    std::cout << _xml_data; // lol
-    gz_compress(stream, _xml_data);
 }
 }
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include <fmtals/lom.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <variant>
+
+static std::size_t lom_slot(const std::uint32_t id, const std::size_t mask)
+{
+    std::uint32_t _hash = id * 0x9E3779B1u;
+    _hash ^= _hash >> 16;
+    return _hash & mask;
+}
+
+static void lom_rehash(fmtals::lom_index& index, const std::size_t capacity)
+{
+    std::vector<std::uint32_t> _ids(capacity, 0);
+    std::vector<fmtals::lom_handle> _handles(capacity);
+    const std::size_t _mask = capacity - 1;
+    for (std::size_t _slot = 0; _slot < index.ids.size(); ++_slot) {
+        if (index.ids[_slot]) {
+            std::size_t _new_slot = lom_slot(index.ids[_slot], _mask);
+            while (_ids[_new_slot]) {
+                _new_slot = (_new_slot + 1) & _mask;
+            }
+            _ids[_new_slot] = index.ids[_slot];
+            _handles[_new_slot] = index.handles[_slot];
+        }
+    }
+    index.ids = std::move(_ids);
+    index.handles = std::move(_handles);
+}
+
+static void lom_reserve(fmtals::lom_index& index, const std::size_t count)
+{
+    std::size_t _capacity = 16;
+    while (_capacity < count * 2) {
+        _capacity *= 2;
+    }
+    if (_capacity > index.ids.size()) {
+        lom_rehash(index, _capacity);
+    }
+}
+
+static void lom_insert_track(fmtals::lom_index& index, const fmtals::project::base_track& track, const fmtals::lom_owner owner, const std::size_t track_index)
+{
+    const auto _insert = [&](const std::uint32_t id, const fmtals::lom_field field) {
+        if (id) {
+            fmtals::insert_lom_id(index, id, { owner, field, track_index });
+        }
+    };
+    _insert(track.lom_id, fmtals::lom_field::lom_id);
+    _insert(track.lom_id_view, fmtals::lom_field::lom_id_view);
+    _insert(track.devices_list_wrapper_lom_id, fmtals::lom_field::devices_list_wrapper);
+    _insert(track.clip_slots_list_wrapper_lom_id, fmtals::lom_field::clip_slots_list_wrapper);
+    _insert(track.mixer_lom_id, fmtals::lom_field::mixer);
+    _insert(track.mixer_lom_id_view, fmtals::lom_field::mixer_view);
+    _insert(track.tempo_lom_id, fmtals::lom_field::tempo);
+}
+
+namespace fmtals {
+
+void index_lom_ids(const project& proj, lom_index& index)
+{
+    std::size_t _estimate = 7 + 7 * (proj.tracks.size() + proj.return_tracks.size() + 2) + 2 * proj.scene_names.size();
+    for (const project::user_track& _track : proj.tracks) {
+        if (const project::audio_track* _audio_track = std::get_if<project::audio_track>(&_track)) {
+            _estimate += 2 * _audio_track->events_audio_clips.size();
+        }
+        std::visit([&](const project::editable_track& _editable_track) { _estimate += 1 + _editable_track.clip_slots.size(); }, _track);
+    }
+    index.ids.clear();
+    index.handles.clear();
+    index.count = 0;
+    index.max_id = 0;
+    index.duplicate_ids.clear();
+    lom_reserve(index, _estimate);
+
+    const auto _insert = [&](const std::uint32_t id, const lom_field field) {
+        if (id) {
+            insert_lom_id(index, id, { lom_owner::project, field });
+        }
+    };
+    _insert(proj.lom_id, lom_field::lom_id);
+    _insert(proj.lom_id_view, lom_field::lom_id_view);
+    _insert(proj.tracks_list_wrapper_lom_id, lom_field::tracks_list_wrapper);
+    _insert(proj.visible_tracks_list_wrapper_lom_id, lom_field::visible_tracks_list_wrapper);
+    _insert(proj.return_tracks_list_wrapper_lom_id, lom_field::return_tracks_list_wrapper);
+    _insert(proj.scenes_list_wrapper_lom_id, lom_field::scenes_list_wrapper);
+    _insert(proj.cue_points_list_wrapper_lom_id, lom_field::cue_points_list_wrapper);
+
+    for (std::size_t _track_index = 0; _track_index < proj.tracks.size(); ++_track_index) {
+        std::visit([&](const auto& _track_visit) {
+            using _track_type_t = std::decay_t<decltype(_track_visit)>;
+            lom_insert_track(index, _track_visit, lom_owner::track, _track_index);
+            if (_track_visit.main_sequencer_lom_id) {
+                insert_lom_id(index, _track_visit.main_sequencer_lom_id, { lom_owner::track, lom_field::main_sequencer, _track_index });
+            }
+            for (std::size_t _slot_index = 0; _slot_index < _track_visit.clip_slots.size(); ++_slot_index) {
+                if (_track_visit.clip_slots[_slot_index].lom_id) {
+                    insert_lom_id(index, _track_visit.clip_slots[_slot_index].lom_id, { lom_owner::clip_slot, lom_field::lom_id, _track_index, _slot_index });
+                }
+            }
+            if constexpr (std::is_same_v<_track_type_t, project::audio_track>) {
+                for (std::size_t _clip_index = 0; _clip_index < _track_visit.events_audio_clips.size(); ++_clip_index) {
+                    const project::audio_clip& _audio_clip = _track_visit.events_audio_clips[_clip_index];
+                    if (_audio_clip.lom_id) {
+                        insert_lom_id(index, _audio_clip.lom_id, { lom_owner::audio_clip, lom_field::lom_id, _track_index, _clip_index });
+                    }
+                    if (_audio_clip.lom_id_view) {
+                        insert_lom_id(index, _audio_clip.lom_id_view, { lom_owner::audio_clip, lom_field::lom_id_view, _track_index, _clip_index });
+                    }
+                }
+            }
+        },
+            proj.tracks[_track_index]);
+    }
+    for (std::size_t _track_index = 0; _track_index < proj.return_tracks.size(); ++_track_index) {
+        lom_insert_track(index, proj.return_tracks[_track_index], lom_owner::return_track, _track_index);
+    }
+    lom_insert_track(index, proj.project_master_track, lom_owner::master_track, lom_handle::npos);
+    lom_insert_track(index, proj.project_prehear_track, lom_owner::pre_hear_track, lom_handle::npos);
+
+    for (std::size_t _scene_index = 0; _scene_index < proj.scene_names.size(); ++_scene_index) {
+        const project::scene& _scene = proj.scene_names[_scene_index];
+        if (_scene.lom_id) {
+            insert_lom_id(index, _scene.lom_id, { lom_owner::scene, lom_field::lom_id, _scene_index });
+        }
+        if (_scene.clip_slots_list_wrapper_lom_id) {
+            insert_lom_id(index, _scene.clip_slots_list_wrapper_lom_id, { lom_owner::scene, lom_field::clip_slots_list_wrapper, _scene_index });
+        }
+    }
+}
+
+void import_project(std::istream& stream, project& proj, version& ver, lom_index& index)
+{
+    import_project(stream, proj, ver);
+    index_lom_ids(proj, index);
+}
+
+bool insert_lom_id(lom_index& index, const std::uint32_t id, const lom_handle& handle)
+{
+    if (!id) {
+        throw std::invalid_argument("LOM id 0 can not be indexed");
+    }
+    if ((index.count + 1) * 2 > index.ids.size()) {
+        lom_rehash(index, index.ids.empty() ? 16 : index.ids.size() * 2);
+    }
+    const std::size_t _mask = index.ids.size() - 1;
+    std::size_t _slot = lom_slot(id, _mask);
+    while (index.ids[_slot]) {
+        if (index.ids[_slot] == id) {
+            index.duplicate_ids.emplace_back(id);
+            return false;
+        }
+        _slot = (_slot + 1) & _mask;
+    }
+    index.ids[_slot] = id;
+    index.handles[_slot] = handle;
+    index.count++;
+    index.max_id = std::max(index.max_id, id);
+    return true;
+}
+
+const lom_handle* find_lom_id(const lom_index& index, const std::uint32_t id)
+{
+    if (!id || index.ids.empty()) {
+        return nullptr;
+    }
+    const std::size_t _mask = index.ids.size() - 1;
+    for (std::size_t _slot = lom_slot(id, _mask); index.ids[_slot]; _slot = (_slot + 1) & _mask) {
+        if (index.ids[_slot] == id) {
+            return &index.handles[_slot];
+        }
+    }
+    return nullptr;
+}
+
+std::uint32_t allocate_lom_id(lom_index& index, const lom_handle& handle)
+{
+    if (index.max_id == UINT32_MAX) {
+        throw std::runtime_error("No free LOM id left");
+    }
+    const std::uint32_t _id = index.max_id + 1;
+    insert_lom_id(index, _id, handle);
+    return _id;
+}
+
+void validate_lom_ids(const lom_index& index)
+{
+    if (index.duplicate_ids.empty()) {
+        return;
+    }
+    std::string _message = "Duplicate LOM ids:";
+    for (const std::uint32_t _id : index.duplicate_ids) {
+        _message += " " + std::to_string(_id);
+    }
+    throw std::runtime_error(_message);
+}
+
+}
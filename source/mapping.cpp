@@ -0,0 +1,88 @@
+#include "mapping.hpp"
+
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::shared_ptr<const char> map_file(const std::filesystem::path& path, std::size_t& size)
+{
+#ifdef _WIN32
+    const HANDLE _file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file: " + path.string());
+    }
+    LARGE_INTEGER _size;
+    if (!GetFileSizeEx(_file, &_size) || _size.QuadPart == 0) {
+        CloseHandle(_file);
+        throw std::runtime_error("Failed to map empty file: " + path.string());
+    }
+    const HANDLE _mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(_file);
+    if (!_mapping) {
+        throw std::runtime_error("Failed to map file: " + path.string());
+    }
+    const void* _data = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(_mapping);
+    if (!_data) {
+        throw std::runtime_error("Failed to map file: " + path.string());
+    }
+    size = static_cast<std::size_t>(_size.QuadPart);
+    return std::shared_ptr<const char>(static_cast<const char*>(_data), [](const char* data) { UnmapViewOfFile(data); });
+#else
+    const int _file = open(path.c_str(), O_RDONLY);
+    if (_file < 0) {
+        throw std::runtime_error("Failed to open file: " + path.string());
+    }
+    struct stat _status;
+    if (fstat(_file, &_status) != 0 || _status.st_size == 0) {
+        close(_file);
+        throw std::runtime_error("Failed to map empty file: " + path.string());
+    }
+    const std::size_t _size = static_cast<std::size_t>(_status.st_size);
+    void* _data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _file, 0);
+    close(_file);
+    if (_data == MAP_FAILED) {
+        throw std::runtime_error("Failed to map file: " + path.string());
+    }
+    size = _size;
+    return std::shared_ptr<const char>(static_cast<const char*>(_data), [_size](const char* data) { munmap(const_cast<char*>(data), _size); });
+#endif
+}
+
+void write_file_atomically(const std::filesystem::path& path, const std::function<void(std::ostream&)>& callback)
+{
+    thread_local std::mt19937_64 _generator(std::random_device {}());
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    std::filesystem::path _temporary_path = path;
+    _temporary_path += ".tmp" + std::to_string(_generator());
+    try {
+        {
+            std::ofstream _stream(_temporary_path, std::ios::binary);
+            callback(_stream);
+            _stream.flush();
+            if (!_stream) {
+                throw std::runtime_error("Failed to write to file: " + _temporary_path.string());
+            }
+        }
+        std::filesystem::rename(_temporary_path, path);
+    } catch (...) {
+        std::error_code _error;
+        std::filesystem::remove(_temporary_path, _error);
+        throw;
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <ostream>
+
+/// @brief Maps a file in memory read only, the mapping is released with the last copy of the
+/// pointer. Throws when the file cannot be opened or is empty
+/// @param path
+/// @param size
+std::shared_ptr<const char> map_file(const std::filesystem::path& path, std::size_t& size);
+
+/// @brief Writes a file through a uniquely named temporary in the same directory, renamed over the
+/// path once complete, so that readers, concurrent writers and interrupted writes never see a
+/// partial file. Creates the parent directories and throws when the file cannot be written
+/// @param path
+/// @param callback
+void write_file_atomically(const std::filesystem::path& path, const std::function<void(std::ostream&)>& callback);
@@ -0,0 +1,156 @@
+#include <fmtals/memory.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <variant>
+
+#include "serialize.hpp"
+
+/// @brief Represents an archive that walks the binary field lists of the project and adds the
+/// heap memory of every string and list to a counter. Lists of automation, clips, scenes and
+/// plugin devices are counted with everything they own in their own counter, the only list of
+/// strings being the session clips
+struct memory_archive {
+    fmtals::project_memory& usage;
+    std::size_t* counter;
+
+    template <typename... Values>
+    void operator()(Values&... values)
+    {
+        (add(values), ...);
+    }
+
+    void add(std::pmr::string& value)
+    {
+        static const std::size_t _inline_capacity = std::pmr::string().capacity();
+        if (value.capacity() > _inline_capacity) {
+            *counter += value.capacity() + 1;
+        }
+    }
+
+    void add(std::pmr::vector<bool>& value)
+    {
+        *counter += (value.capacity() + 7) / 8;
+    }
+
+    template <typename T>
+    void add(std::pmr::vector<T>& value)
+    {
+        std::size_t* _parent = counter;
+        if constexpr (std::is_same_v<T, fmtals::project::automation_lane> || std::is_same_v<T, fmtals::project::automation_envelope>) {
+            counter = &usage.automation;
+        } else if constexpr (std::is_same_v<T, fmtals::project::audio_clip> || std::is_same_v<T, std::pmr::string>) {
+            counter = &usage.clips;
+        } else if constexpr (std::is_same_v<T, fmtals::project::scene>) {
+            counter = &usage.scenes;
+        } else if constexpr (std::is_same_v<T, fmtals::project::plugin_device>) {
+            counter = &usage.plugins;
+        }
+        *counter += value.capacity() * sizeof(T);
+        for (T& _element : value) {
+            add(_element);
+        }
+        counter = _parent;
+    }
+
+    template <typename T>
+    void add(std::optional<T>& value)
+    {
+        if (value) {
+            add(*value);
+        }
+    }
+
+    template <typename T>
+    void add(T& value)
+    {
+        if constexpr (!std::is_arithmetic_v<T> && !std::is_enum_v<T> && !std::is_empty_v<T> && !std::is_same_v<T, fmtals::atom>) {
+            fmtals::serialize(*this, value);
+        }
+    }
+};
+
+template <typename T>
+static void memory_add_track(memory_archive& archive, T& track)
+{
+    fmtals::serialize_track_names(archive, track);
+    fmtals::serialize_track_header(archive, track);
+    fmtals::serialize(archive, static_cast<fmtals::project::device_chain&>(track));
+    if constexpr (std::is_same_v<T, fmtals::project::audio_track>) {
+        archive(track.events_audio_clips);
+    }
+}
+
+namespace fmtals {
+
+project_memory memory_usage(const project& proj)
+{
+    project& _proj = const_cast<project&>(proj);
+    project_memory _usage;
+    memory_archive _archive { _usage, &_usage.settings };
+    _usage.settings += sizeof(project);
+    serialize_settings(_archive, _proj);
+
+    _archive.counter = &_usage.tracks;
+    _usage.tracks += _proj.tracks.capacity() * sizeof(project::user_track) + _proj.return_tracks.capacity() * sizeof(project::return_track);
+    for (project::user_track& _track : _proj.tracks) {
+        std::visit([&](auto& _track_visit) { memory_add_track(_archive, _track_visit); }, _track);
+    }
+    for (project::return_track& _track : _proj.return_tracks) {
+        memory_add_track(_archive, _track);
+    }
+    memory_add_track(_archive, _proj.project_master_track);
+    memory_add_track(_archive, _proj.project_prehear_track);
+    _archive(_proj.scene_names);
+
+    _usage.total = _usage.settings + _usage.tracks + _usage.automation + _usage.clips + _usage.scenes + _usage.plugins;
+    return _usage;
+}
+
+void memory_counter::reset_peak()
+{
+    peak_bytes = bytes.load();
+}
+
+void* memory_counter::do_allocate(std::size_t size, std::size_t alignment)
+{
+    const std::size_t _bytes = bytes += size;
+    if (budget && _bytes > budget) {
+        bytes -= size;
+        throw std::runtime_error("Memory budget exceeded: " + std::to_string(size) + " bytes requested with " + std::to_string(_bytes - size) + " of " + std::to_string(budget) + " bytes in use");
+    }
+    void* _pointer;
+    try {
+        _pointer = upstream->allocate(size, alignment);
+    } catch (...) {
+        bytes -= size;
+        throw;
+    }
+    std::size_t _peak_bytes = peak_bytes.load();
+    while (_bytes > _peak_bytes && !peak_bytes.compare_exchange_weak(_peak_bytes, _bytes)) { }
+    return _pointer;
+}
+
+void memory_counter::do_deallocate(void* pointer, std::size_t size, std::size_t alignment)
+{
+    upstream->deallocate(pointer, size, alignment);
+    bytes -= size;
+}
+
+bool memory_counter::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+bool is_thread_safe_resource(const std::pmr::memory_resource* resource)
+{
+    if (const memory_counter* _counter = dynamic_cast<const memory_counter*>(resource)) {
+        return is_thread_safe_resource(_counter->upstream);
+    }
+    return resource == std::pmr::new_delete_resource() || dynamic_cast<const std::pmr::synchronized_pool_resource*>(resource);
+}
+
+}
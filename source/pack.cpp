@@ -0,0 +1,237 @@
+#include <fmtals/pack.hpp>
+
+#include <array>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <streambuf>
+
+#include <contrib/minizip/unzip.h>
+
+#include "parallel.hpp"
+
+// minizip reads the archive through these callbacks so that paths keep their encoding on every
+// platform, the file name passed to unzOpen2_64 is a pointer to a std::filesystem::path
+
+static voidpf ZCALLBACK pack_open(voidpf, const void* filename, int)
+{
+    std::ifstream* _stream = new std::ifstream(*static_cast<const std::filesystem::path*>(filename), std::ios::binary);
+    if (!*_stream) {
+        delete _stream;
+        return nullptr;
+    }
+    return _stream;
+}
+
+static uLong ZCALLBACK pack_read(voidpf, voidpf stream, void* buffer, uLong size)
+{
+    std::ifstream* _stream = static_cast<std::ifstream*>(stream);
+    _stream->read(static_cast<char*>(buffer), static_cast<std::streamsize>(size));
+    return static_cast<uLong>(_stream->gcount());
+}
+
+static uLong ZCALLBACK pack_write(voidpf, voidpf, const void*, uLong)
+{
+    return 0;
+}
+
+static ZPOS64_T ZCALLBACK pack_tell(voidpf, voidpf stream)
+{
+    return static_cast<ZPOS64_T>(static_cast<std::ifstream*>(stream)->tellg());
+}
+
+static long ZCALLBACK pack_seek(voidpf, voidpf stream, ZPOS64_T offset, int origin)
+{
+    std::ifstream* _stream = static_cast<std::ifstream*>(stream);
+    const std::ios::seekdir _direction = origin == ZLIB_FILEFUNC_SEEK_END ? std::ios::end : origin == ZLIB_FILEFUNC_SEEK_CUR ? std::ios::cur : std::ios::beg;
+    _stream->clear();
+    _stream->seekg(static_cast<std::streamoff>(offset), _direction);
+    return _stream->fail() ? -1 : 0;
+}
+
+static int ZCALLBACK pack_close(voidpf, voidpf stream)
+{
+    delete static_cast<std::ifstream*>(stream);
+    return 0;
+}
+
+static int ZCALLBACK pack_error(voidpf, voidpf stream)
+{
+    return static_cast<std::ifstream*>(stream)->bad() ? 1 : 0;
+}
+
+/// @brief Owns an archive handle. minizip handles are not thread safe so every thread opens its own
+struct pack_handle {
+    unzFile file = nullptr;
+
+    pack_handle(const std::filesystem::path& path)
+    {
+        zlib_filefunc64_def _functions = { pack_open, pack_read, pack_write, pack_tell, pack_seek, pack_close, pack_error, nullptr };
+        file = unzOpen2_64(&path, &_functions);
+        if (!file) {
+            throw std::runtime_error("Could not open Live Pack: " + path.u8string());
+        }
+    }
+
+    pack_handle(const pack_handle&) = delete;
+    pack_handle& operator=(const pack_handle&) = delete;
+
+    ~pack_handle()
+    {
+        unzClose(file);
+    }
+};
+
+/// @brief Reads the current member of an archive handle as a stream. Read errors end the stream
+/// and are reported by close
+struct pack_member_buffer : std::streambuf {
+    unzFile file;
+    std::array<char, 65536> buffer;
+    int error = UNZ_OK;
+
+    pack_member_buffer(unzFile handle, const fmtals::pack_member& member)
+        : file(handle)
+    {
+        unz64_file_pos _position = { member.directory_offset, member.file_number };
+        if (unzGoToFilePos64(file, &_position) != UNZ_OK || unzOpenCurrentFile(file) != UNZ_OK) {
+            throw std::runtime_error("Could not open Live Pack member: " + member.name);
+        }
+    }
+
+    pack_member_buffer(const pack_member_buffer&) = delete;
+    pack_member_buffer& operator=(const pack_member_buffer&) = delete;
+
+    ~pack_member_buffer()
+    {
+        if (file) {
+            unzCloseCurrentFile(file);
+        }
+    }
+
+    std::size_t read()
+    {
+        const int _count = unzReadCurrentFile(file, buffer.data(), static_cast<unsigned>(buffer.size()));
+        if (_count < 0) {
+            error = _count;
+        }
+        return _count > 0 ? static_cast<std::size_t>(_count) : 0;
+    }
+
+    int_type underflow() override
+    {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+        const std::size_t _count = read();
+        if (!_count) {
+            return traits_type::eof();
+        }
+        setg(buffer.data(), buffer.data(), buffer.data() + _count);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    void close(const fmtals::pack_member& member)
+    {
+        const int _close_error = unzCloseCurrentFile(file);
+        file = nullptr;
+        if (error != UNZ_OK || _close_error != UNZ_OK) {
+            throw std::runtime_error("Corrupted Live Pack member: " + member.name);
+        }
+    }
+};
+
+static bool pack_is_project(const std::string& name)
+{
+    return name.size() > 4 && name.compare(name.size() - 4, 4, ".als") == 0;
+}
+
+static void pack_import_member(unzFile file, const fmtals::pack_member& member, fmtals::project& proj, fmtals::version& ver)
+{
+    pack_member_buffer _buffer(file, member);
+    std::istream _stream(&_buffer);
+    try {
+        fmtals::import_project(_stream, proj, ver);
+    } catch (const std::exception& _exception) {
+        throw std::runtime_error(member.name + ": " + _exception.what());
+    }
+    _buffer.close(member);
+}
+
+namespace fmtals {
+
+void open_pack(const std::filesystem::path& path, pack& pk)
+{
+    pack_handle _handle(path);
+    pk.path = path;
+    pk.members.clear();
+    unz_global_info64 _global_info;
+    if (unzGetGlobalInfo64(_handle.file, &_global_info) != UNZ_OK) {
+        throw std::runtime_error("Invalid Live Pack central directory");
+    }
+    pk.members.reserve(static_cast<std::size_t>(_global_info.number_entry));
+    std::string _name;
+    for (int _result = unzGoToFirstFile(_handle.file); _result != UNZ_END_OF_LIST_OF_FILE; _result = unzGoToNextFile(_handle.file)) {
+        unz_file_info64 _info;
+        if (_result != UNZ_OK || unzGetCurrentFileInfo64(_handle.file, &_info, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK) {
+            throw std::runtime_error("Invalid Live Pack central directory");
+        }
+        _name.resize(_info.size_filename);
+        unzGetCurrentFileInfo64(_handle.file, nullptr, _name.data(), static_cast<uLong>(_name.size()), nullptr, 0, nullptr, 0);
+        if (!_name.empty() && _name.back() == '/') {
+            continue;
+        }
+        unz64_file_pos _position;
+        unzGetFilePos64(_handle.file, &_position);
+        pack_member& _member = pk.members.emplace_back();
+        _member.name = _name;
+        _member.size = _info.uncompressed_size;
+        _member.compressed_size = _info.compressed_size;
+        _member.crc = static_cast<std::uint32_t>(_info.crc);
+        _member.directory_offset = _position.pos_in_zip_directory;
+        _member.file_number = _position.num_of_file;
+    }
+}
+
+void read_pack_member(const pack& pk, const pack_member& member, const std::function<void(const char*, std::size_t)>& callback)
+{
+    pack_handle _handle(pk.path);
+    pack_member_buffer _buffer(_handle.file, member);
+    for (std::size_t _count = _buffer.read(); _count; _count = _buffer.read()) {
+        callback(_buffer.buffer.data(), _count);
+    }
+    _buffer.close(member);
+}
+
+void stream_pack_member(const pack& pk, const pack_member& member, const std::function<void(std::istream&)>& callback)
+{
+    pack_handle _handle(pk.path);
+    pack_member_buffer _buffer(_handle.file, member);
+    std::istream _stream(&_buffer);
+    callback(_stream);
+    _buffer.close(member);
+}
+
+void import_pack_member(const pack& pk, const pack_member& member, project& proj, version& ver)
+{
+    pack_handle _handle(pk.path);
+    pack_import_member(_handle.file, member, proj, ver);
+}
+
+void import_pack_projects(const pack& pk, std::vector<pack_project>& projects, const std::size_t jobs)
+{
+    std::vector<const pack_member*> _members;
+    for (const pack_member& _member : pk.members) {
+        if (pack_is_project(_member.name)) {
+            _members.emplace_back(&_member);
+        }
+    }
+    projects.resize(_members.size());
+    parallel_for(
+        _members.size(), jobs, [&]() { return pack_handle(pk.path); },
+        [&](pack_handle& handle, const std::size_t index) {
+            projects[index].name = _members[index]->name;
+            pack_import_member(handle.file, *_members[index], projects[index].proj, projects[index].ver);
+        });
+}
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Retrieves the number of workers to use for a job count where 0 means one per hardware thread
+/// @param jobs
+inline std::size_t parallel_jobs(const std::size_t jobs)
+{
+    return jobs ? jobs : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// @brief Calls a function for every index in [0, count) on up to jobs threads, the calling thread
+/// being one of them. Every thread creates its own state with init before its first index and
+/// passes it to each call. Once a call throws no new index is started and, after every worker has
+/// joined, the exception of the lowest failing index is rethrown so errors do not depend on timing
+/// @param count
+/// @param jobs
+/// @param init
+/// @param function
+template <typename Init, typename Function>
+void parallel_for(const std::size_t count, const std::size_t jobs, const Init& init, const Function& function)
+{
+    std::atomic<std::size_t> _next_index = 0;
+    std::exception_ptr _exception;
+    std::size_t _exception_index = count;
+    std::mutex _exception_mutex;
+    const auto _worker = [&]() {
+        std::size_t _index = _next_index++;
+        if (_index >= count) {
+            return;
+        }
+        try {
+            auto _state = init();
+            for (; _index < count; _index = _next_index++) {
+                function(_state, _index);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> _lock(_exception_mutex);
+            if (_index < _exception_index) {
+                _exception = std::current_exception();
+                _exception_index = _index;
+            }
+            _next_index = count;
+        }
+    };
+    std::vector<std::thread> _threads;
+    for (std::size_t _thread = 1; _thread < std::min(parallel_jobs(jobs), count); ++_thread) {
+        _threads.emplace_back(_worker);
+    }
+    _worker();
+    for (std::thread& _thread : _threads) {
+        _thread.join();
+    }
+    if (_exception) {
+        std::rethrow_exception(_exception);
+    }
+}
+
+/// @brief Calls a function for every index in [0, count) on up to jobs threads without per thread
+/// state, with the same error handling
+/// @param count
+/// @param jobs
+/// @param function
+template <typename Function>
+void parallel_for(const std::size_t count, const std::size_t jobs, const Function& function)
+{
+    parallel_for(count, jobs, []() { return 0; }, [&](int&, const std::size_t index) { function(index); });
+}
@@ -0,0 +1,79 @@
+#include <fmtals/plugin.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "simd.hpp"
+
+static constexpr std::size_t plugin_line_bytes = 40;
+
+static bool plugin_is_space(const char character)
+{
+    return character == ' ' || character == '\t' || character == '\n' || character == '\r';
+}
+
+static std::uint8_t plugin_nibble(const char character)
+{
+    if (character >= '0' && character <= '9') {
+        return static_cast<std::uint8_t>(character - '0');
+    } else if (character >= 'A' && character <= 'F') {
+        return static_cast<std::uint8_t>(character - 'A' + 10);
+    } else if (character >= 'a' && character <= 'f') {
+        return static_cast<std::uint8_t>(character - 'a' + 10);
+    }
+    throw std::runtime_error("Invalid plugin state character");
+}
+
+static void plugin_encode_bytes(const std::uint8_t* data, const std::size_t size, char* output)
+{
+    static constexpr char _digits[] = "0123456789ABCDEF";
+    const std::size_t _encoded = simd_encode_hex(data, size, output);
+    for (std::size_t _index = _encoded; _index < size; ++_index) {
+        output[_index * 2] = _digits[data[_index] >> 4];
+        output[_index * 2 + 1] = _digits[data[_index] & 0x0f];
+    }
+}
+
+namespace fmtals {
+
+void decode_plugin_state(const std::string_view text, std::vector<std::uint8_t>& state)
+{
+    state.resize(text.size() / 2);
+    std::uint8_t* _output = state.data();
+    const char* _text = text.data();
+    const char* const _end = _text + text.size();
+    while (_text != _end) {
+        const std::size_t _decoded = simd_decode_hex(_text, static_cast<std::size_t>(_end - _text), _output);
+        _text += _decoded;
+        _output += _decoded / 2;
+        if (_text == _end) {
+            break;
+        }
+        if (plugin_is_space(*_text)) {
+            ++_text;
+            continue;
+        }
+        if (_end - _text < 2) {
+            throw std::runtime_error("Odd number of plugin state digits");
+        }
+        const std::uint8_t _high = plugin_nibble(_text[0]);
+        *_output++ = static_cast<std::uint8_t>(_high << 4 | plugin_nibble(_text[1]));
+        _text += 2;
+    }
+    state.resize(static_cast<std::size_t>(_output - state.data()));
+}
+
+void encode_plugin_state(const std::uint8_t* data, const std::size_t size, std::pmr::string& text)
+{
+    const std::size_t _lines = (size + plugin_line_bytes - 1) / plugin_line_bytes;
+    text.resize(size * 2 + _lines);
+    char* _output = text.data();
+    for (std::size_t _offset = 0; _offset < size; _offset += plugin_line_bytes) {
+        const std::size_t _line_size = std::min(plugin_line_bytes, size - _offset);
+        *_output++ = '\n';
+        plugin_encode_bytes(data + _offset, _line_size, _output);
+        _output += _line_size * 2;
+    }
+}
+
+}
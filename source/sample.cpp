@@ -0,0 +1,153 @@
+#include <fmtals/sample.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+#include "scan.hpp"
+#include "xml.hpp"
+
+extern void gz_decompress(std::istream& gz_stream, const std::function<void(const char*, std::size_t)>& callback);
+
+static const xml_node* sample_get_node(const xml_node* node, const char* name)
+{
+    return node ? node->first_node(name) : nullptr;
+}
+
+static const char* sample_get_value(const xml_node* node, const char* name)
+{
+    const xml_node* _child = sample_get_node(node, name);
+    if (!_child || !_child->first_attribute("Value")) {
+        return nullptr;
+    }
+    return _child->first_attribute("Value")->value();
+}
+
+template <typename T>
+static std::optional<T> sample_get_integer(const xml_node* node, const char* name)
+{
+    const char* _value = sample_get_value(node, name);
+    if (!_value) {
+        return std::nullopt;
+    }
+    T _integer = 0;
+    const char* _end = _value + std::strlen(_value);
+    const std::from_chars_result _result = std::from_chars(_value, _end, _integer);
+    if (_result.ec != std::errc() || _result.ptr != _end) {
+        return std::nullopt;
+    }
+    return _integer;
+}
+
+static std::string sample_join_directories(const xml_node* node)
+{
+    std::string _path;
+    for (const xml_node* _element = node->first_node("RelativePathElement"); _element; _element = _element->next_sibling("RelativePathElement")) {
+        if (const cereal::rapidxml::xml_attribute<char>* _directory = _element->first_attribute("Dir")) {
+            if (!_path.empty()) {
+                _path += '/';
+            }
+            _path += _directory->value();
+        }
+    }
+    return _path;
+}
+
+static void sample_append_name(std::string& path, const char* name)
+{
+    if (name && *name) {
+        if (!path.empty()) {
+            path += '/';
+        }
+        path += name;
+    }
+}
+
+static void sample_read_fragment(char* fragment, const std::size_t size, std::vector<fmtals::sample_reference>& references)
+{
+    xml_document _document;
+    xml_parse(_document, fragment, size);
+    const xml_node* _file_ref = sample_get_node(_document.first_node("SampleRef"), "FileRef");
+    if (!_file_ref) {
+        return;
+    }
+    fmtals::sample_reference& _reference = references.emplace_back();
+    const char* _name = sample_get_value(_file_ref, "Name");
+    const char* _has_relative_path = sample_get_value(_file_ref, "HasRelativePath");
+    const xml_node* _relative_path_node = _file_ref->first_node("RelativePath");
+    if (const char* _relative_path = sample_get_value(_file_ref, "RelativePath")) {
+        _reference.relative_path = _relative_path;
+    } else if (_relative_path_node && !(_has_relative_path && std::strcmp(_has_relative_path, "false") == 0)) {
+        _reference.relative_path = sample_join_directories(_relative_path_node);
+        sample_append_name(_reference.relative_path, _name);
+    }
+    if (const char* _path = sample_get_value(_file_ref, "Path")) {
+        _reference.path = _path;
+    } else if (const xml_node* _path_hint_node = sample_get_node(sample_get_node(_file_ref, "SearchHint"), "PathHint")) {
+        _reference.path = sample_join_directories(_path_hint_node);
+        sample_append_name(_reference.path, _name);
+        const bool _has_drive = _reference.path.size() >= 2 && _reference.path[1] == ':';
+        if (!_reference.path.empty() && _reference.path.front() != '/' && !_has_drive) {
+            _reference.path.insert(_reference.path.begin(), '/');
+        }
+    }
+    _reference.relative_path_type = sample_get_integer<std::uint32_t>(_file_ref, "RelativePathType");
+    _reference.file_size = sample_get_integer<std::uint64_t>(_file_ref, "OriginalFileSize");
+    if (!_reference.file_size) {
+        _reference.file_size = sample_get_integer<std::uint64_t>(sample_get_node(_file_ref, "SearchHint"), "FileSize");
+    }
+    _reference.crc = sample_get_integer<std::uint32_t>(_file_ref, "OriginalCrc");
+    if (!_reference.crc) {
+        _reference.crc = sample_get_integer<std::uint32_t>(sample_get_node(_file_ref, "SearchHint"), "Crc");
+    }
+}
+
+void scan_fragments(std::istream& stream, const std::string_view open, const std::string_view close, const std::function<void(char*, std::size_t)>& callback)
+{
+    const std::boyer_moore_horspool_searcher _open_searcher(open.begin(), open.end());
+    const std::boyer_moore_horspool_searcher _close_searcher(close.begin(), close.end());
+    std::string _pending;
+    bool _inside = false;
+    gz_decompress(stream, [&](const char* chunk, const std::size_t size) {
+        _pending.append(chunk, size);
+        char* const _begin = _pending.data();
+        char* const _end = _begin + _pending.size();
+        char* _cursor = _begin;
+        while (true) {
+            if (!_inside) {
+                char* const _start = std::search(_cursor, _end, _open_searcher);
+                if (_start == _end) {
+                    // keep what could be the beginning of a tag split across chunks
+                    _cursor = std::max(_cursor, _end - std::min<std::ptrdiff_t>(_end - _begin, open.size() - 1));
+                    break;
+                }
+                _cursor = _start;
+                _inside = true;
+            }
+            char* const _stop = std::search(_cursor + open.size(), _end, _close_searcher);
+            if (_stop == _end) {
+                break;
+            }
+            char* const _fragment_end = _stop + close.size();
+            callback(_cursor, static_cast<std::size_t>(_fragment_end - _cursor));
+            _cursor = _fragment_end;
+            _inside = false;
+        }
+        _pending.erase(0, static_cast<std::size_t>(_cursor - _begin));
+    });
+}
+
+namespace fmtals {
+
+std::vector<sample_reference> scan_sample_references(std::istream& stream)
+{
+    std::vector<sample_reference> _references;
+    scan_fragments(stream, "<SampleRef>", "</SampleRef>", [&](char* fragment, const std::size_t size) {
+        sample_read_fragment(fragment, size, _references);
+    });
+    return _references;
+}
+
+}
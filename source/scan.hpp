@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string_view>
+
+/// @brief Inflates a set chunk by chunk and calls a function with every fragment of the document
+/// that starts with an open tag and ends with its close tag. Fragments are writable and can be
+/// parsed in place, the rest of the document is never kept
+/// @param stream
+/// @param open
+/// @param close
+/// @param callback
+void scan_fragments(std::istream& stream, const std::string_view open, const std::string_view close, const std::function<void(char*, std::size_t)>& callback);
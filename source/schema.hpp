@@ -0,0 +1,576 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+// Field descriptors shared by import_project and export_project. Tables are listed in the order
+// Ableton Live writes the XML, carry the range of versions each field exists in, and are iterated
+// with the version as a template parameter so that every version check is resolved at compile time.
+
+namespace schema {
+
+inline constexpr fmtals::version first_version = fmtals::version::v_9_0_0;
+inline constexpr fmtals::version last_version = static_cast<fmtals::version>(std::numeric_limits<std::uint32_t>::max());
+
+enum struct field_kind {
+    value,
+    node,
+    member,
+    list,
+    binding,
+};
+
+/// @brief Binds a member to an attribute of the current node when name is empty, or to an
+/// attribute of the child node called name otherwise
+template <typename Owner, typename T>
+struct value_field {
+    static constexpr field_kind kind = field_kind::value;
+    std::string_view name;
+    std::string_view attribute;
+    T Owner::*member;
+    fmtals::version since;
+    fmtals::version until;
+};
+
+/// @brief Groups fields of the same object under a child node
+template <typename Fields>
+struct node_field {
+    static constexpr field_kind kind = field_kind::node;
+    std::string_view name;
+    Fields fields;
+    fmtals::version since;
+    fmtals::version until;
+};
+
+/// @brief Binds a member object to a child node
+template <typename Owner, typename T, typename Fields>
+struct member_field {
+    static constexpr field_kind kind = field_kind::member;
+    std::string_view name;
+    T Owner::*member;
+    Fields fields;
+    fmtals::version since;
+    fmtals::version until;
+};
+
+/// @brief Binds a container member to the repeated element nodes of a child node
+template <typename Owner, typename Container, typename Fields>
+struct list_field {
+    static constexpr field_kind kind = field_kind::list;
+    std::string_view name;
+    std::string_view element;
+    Container Owner::*member;
+    Fields fields;
+    fmtals::version since;
+    fmtals::version until;
+};
+
+/// @brief Hands a child node to hand-written import and export functions
+template <typename Binding>
+struct binding_field {
+    static constexpr field_kind kind = field_kind::binding;
+    using binding_type = Binding;
+    std::string_view name;
+    fmtals::version since;
+    fmtals::version until;
+};
+
+template <typename... Fields>
+constexpr std::tuple<Fields...> fields(const Fields... fields)
+{
+    return std::tuple<Fields...>(fields...);
+}
+
+template <typename Owner, typename T>
+constexpr value_field<Owner, T> value(const std::string_view name, T Owner::*member, const fmtals::version since = first_version, const fmtals::version until = last_version)
+{
+    return { name, "Value", member, since, until };
+}
+
+template <typename Owner, typename T>
+constexpr value_field<Owner, T> attribute(const std::string_view attribute, T Owner::*member, const fmtals::version since = first_version, const fmtals::version until = last_version)
+{
+    return { std::string_view(), attribute, member, since, until };
+}
+
+template <typename Fields>
+constexpr node_field<Fields> node(const std::string_view name, const Fields fields, const fmtals::version since = first_version, const fmtals::version until = last_version)
+{
+    return { name, fields, since, until };
+}
+
+template <typename Owner, typename T, typename Fields>
+constexpr member_field<Owner, T, Fields> member(const std::string_view name, T Owner::*member, const Fields fields, const fmtals::version since = first_version, const fmtals::version until = last_version)
+{
+    return { name, member, fields, since, until };
+}
+
+template <typename Owner, typename Container, typename Fields>
+constexpr list_field<Owner, Container, Fields> list(const std::string_view name, const std::string_view element, Container Owner::*member, const Fields fields, const fmtals::version since = first_version, const fmtals::version until = last_version)
+{
+    return { name, element, member, fields, since, until };
+}
+
+template <typename Binding>
+constexpr binding_field<Binding> binding(const std::string_view name, const fmtals::version since = first_version, const fmtals::version until = last_version)
+{
+    return { name, since, until };
+}
+
+/// @brief Accessor for the fields of a nested descriptor. Tables are reached through accessor
+/// types rather than references so that nested descriptors stay usable in constant expressions
+template <typename Parent, std::size_t Index>
+struct nested {
+    static constexpr const auto& get()
+    {
+        return std::get<Index>(Parent::get()).fields;
+    }
+};
+
+using fmtals::project;
+using fmtals::version;
+
+// tracks
+
+inline constexpr auto automation_lane_fields = fields(
+    value("SelectedDevice", &project::automation_lane::selected_device),
+    value("SelectedEnvelope", &project::automation_lane::selected_envelope),
+    value("IsContentSelected", &project::automation_lane::is_content_selected),
+    value("LaneHeight", &project::automation_lane::lane_height),
+    value("FadeViewVisible", &project::automation_lane::fade_view_visible));
+
+struct clip_slot_binding;
+struct clip_slots_binding;
+
+inline constexpr auto clip_slot_fields = fields(
+    attribute("Id", &project::clip_slot::id),
+    value("LomId", &project::clip_slot::lom_id),
+    binding<clip_slot_binding>("ClipSlot"),
+    value("HasStop", &project::clip_slot::has_stop),
+    value("NeedRefreeze", &project::clip_slot::need_refreeze));
+
+inline constexpr auto main_sequencer_fields = fields(
+    node("MainSequencer", fields(
+        value("LomId", &project::editable_track::main_sequencer_lom_id),
+        binding<clip_slots_binding>("ClipSlotList"))));
+
+inline constexpr auto warp_marker_fields = fields(
+    attribute("SecTime", &project::warp_marker::sec_time),
+    attribute("BeatTime", &project::warp_marker::beat_time));
+
+inline constexpr auto audio_clip_fields = fields(
+    attribute("Time", &project::audio_clip::time),
+    value("LomId", &project::audio_clip::lom_id),
+    value("LomIdView", &project::audio_clip::lom_id_view),
+    value("CurrentStart", &project::audio_clip::current_start),
+    value("CurrentEnd", &project::audio_clip::current_end),
+    node("Loop", fields(
+        value("LoopStart", &project::audio_clip::loop_start),
+        value("LoopEnd", &project::audio_clip::loop_end),
+        value("StartRelative", &project::audio_clip::loop_start_relative),
+        value("LoopOn", &project::audio_clip::loop_on),
+        value("OutMarker", &project::audio_clip::loop_out_marker),
+        value("HiddenLoopStart", &project::audio_clip::hidden_loop_start),
+        value("HiddenLoopEnd", &project::audio_clip::hidden_loop_end))),
+    value("Name", &project::audio_clip::name),
+    value("Annotation", &project::audio_clip::annotation),
+    value("Color", &project::audio_clip::color, version::v_12_0_0),
+    value("ColorIndex", &project::audio_clip::color_index, first_version, version::v_12_0_0),
+    value("LaunchMode", &project::audio_clip::launch_mode),
+    value("LaunchQuantisation", &project::audio_clip::launch_quantisation),
+    node("ScrollerTimePreserver", fields(
+        value("LeftTime", &project::audio_clip::scroller_time_preserver_left_time),
+        value("RightTime", &project::audio_clip::scroller_time_preserver_right_time))),
+    node("TimeSelection", fields(
+        value("AnchorTime", &project::audio_clip::time_selection_anchor_time),
+        value("OtherTime", &project::audio_clip::time_selection_other_time))),
+    value("Legato", &project::audio_clip::legato),
+    value("Ram", &project::audio_clip::ram),
+    value("Disabled", &project::audio_clip::disabled),
+    value("VelocityAmount", &project::audio_clip::velocity_amount),
+    value("FollowTime", &project::audio_clip::follow_time, first_version, version::v_11_0_0),
+    value("FollowActionA", &project::audio_clip::follow_action_a, first_version, version::v_11_0_0),
+    value("FollowActionB", &project::audio_clip::follow_action_b, first_version, version::v_11_0_0),
+    value("FollowChanceA", &project::audio_clip::follow_chance_a, first_version, version::v_11_0_0),
+    value("FollowChanceB", &project::audio_clip::follow_chance_b, first_version, version::v_11_0_0),
+    node("FollowAction", fields(
+        value("FollowTime", &project::audio_clip::follow_time),
+        value("FollowActionA", &project::audio_clip::follow_action_a),
+        value("FollowActionB", &project::audio_clip::follow_action_b),
+        value("FollowChanceA", &project::audio_clip::follow_chance_a),
+        value("FollowChanceB", &project::audio_clip::follow_chance_b)),
+        version::v_11_0_0),
+    node("Grid", fields(
+        value("FixedNumerator", &project::audio_clip::grid_fixed_numerator),
+        value("FixedDenominator", &project::audio_clip::grid_fixed_denominator),
+        value("GridIntervalPixel", &project::audio_clip::grid_interval_pixel),
+        value("Ntoles", &project::audio_clip::grid_ntoles),
+        value("SnapToGrid", &project::audio_clip::grid_snap_to_grid),
+        value("Fixed", &project::audio_clip::grid_fixed))),
+    value("FreezeStart", &project::audio_clip::freeze_start),
+    value("FreezeEnd", &project::audio_clip::freeze_end),
+    value("IsWarped", &project::audio_clip::is_warped),
+    value("MarkersGenerated", &project::audio_clip::markers_generated),
+    value("IsSongTempoMaster", &project::audio_clip::is_song_tempo_master),
+    list("WarpMarkers", "WarpMarker", &project::audio_clip::warp_markers, warp_marker_fields));
+
+// the arrangement clips of an audio track follow its clip slots in the main sequencer
+inline constexpr auto audio_main_sequencer_fields = fields(
+    node("MainSequencer", fields(
+        value("LomId", &project::editable_track::main_sequencer_lom_id),
+        binding<clip_slots_binding>("ClipSlotList"),
+        node("Sample", fields(
+            node("ArrangerAutomation", fields(
+                list("Events", "AudioClip", &project::audio_track::events_audio_clips, audio_clip_fields))))))));
+
+inline constexpr auto automation_event_fields = fields(
+    attribute("Id", &project::automation_event::id, version::v_11_0_0),
+    attribute("Time", &project::automation_event::time),
+    attribute("Value", &project::automation_event::value));
+
+inline constexpr auto automation_envelope_fields = fields(
+    attribute("Id", &project::automation_envelope::id),
+    node("EnvelopeTarget", fields(
+        value("PointeeId", &project::automation_envelope::pointee_id))),
+    node("Automation", fields(
+        list("Events", "FloatEvent", &project::automation_envelope::events, automation_event_fields))));
+
+inline constexpr auto device_chain_fields = fields(
+    node("AutomationLanes", fields(
+        list("AutomationLanes", "AutomationLane", &project::device_chain::automation_lanes, automation_lane_fields),
+        value("PermanentLanesAreVisible", &project::device_chain::permanent_lanes_are_visible))),
+    node("EnvelopeChooser", fields(
+        value("SelectedDevice", &project::device_chain::envelope_chooser_selected_device),
+        value("SelectedEnvelope", &project::device_chain::envelope_chooser_selected_envelope))),
+    node("AudioInputRouting", fields(
+        value("Target", &project::device_chain::audio_input_routing_target),
+        value("UpperDisplayString", &project::device_chain::audio_input_routing_upper_display_string),
+        value("LowerDisplayString", &project::device_chain::audio_input_routing_lower_display_string))),
+    node("MidiInputRouting", fields(
+        value("Target", &project::device_chain::midi_input_routing_target),
+        value("UpperDisplayString", &project::device_chain::midi_input_routing_upper_display_string),
+        value("LowerDisplayString", &project::device_chain::midi_input_routing_lower_display_string))),
+    node("AudioOutputRouting", fields(
+        value("Target", &project::device_chain::audio_output_routing_target),
+        value("UpperDisplayString", &project::device_chain::audio_output_routing_upper_display_string),
+        value("LowerDisplayString", &project::device_chain::audio_output_routing_lower_display_string))),
+    node("MidiOutputRouting", fields(
+        value("Target", &project::device_chain::midi_output_routing_target),
+        value("UpperDisplayString", &project::device_chain::midi_output_routing_upper_display_string),
+        value("LowerDisplayString", &project::device_chain::midi_output_routing_lower_display_string))),
+    node("Mixer", fields(
+        value("LomId", &project::device_chain::mixer_lom_id),
+        value("LomIdView", &project::device_chain::mixer_lom_id_view),
+        value("IsExpanded", &project::device_chain::is_expanded),
+        node("Tempo", fields(
+            value("LomId", &project::device_chain::tempo_lom_id),
+            value("Manual", &project::device_chain::tempo),
+            node("AutomationTarget", fields(
+                attribute("Id", &project::device_chain::tempo_automation_target_id))))))));
+
+struct plugin_desc_binding;
+struct vst2_preset_binding;
+struct vst3_preset_binding;
+
+inline constexpr auto plugin_parameter_fields = fields(
+    attribute("Id", &project::plugin_parameter::id),
+    value("ParameterName", &project::plugin_parameter::name),
+    value("ParameterId", &project::plugin_parameter::parameter_id),
+    node("ParameterValue", fields(
+        value("Manual", &project::plugin_parameter::value))));
+
+inline constexpr auto vst2_plugin_fields = fields(
+    value("Path", &project::vst2_plugin::path),
+    value("PlugName", &project::vst2_plugin::plug_name),
+    value("UniqueId", &project::vst2_plugin::unique_id),
+    value("Inputs", &project::vst2_plugin::inputs),
+    value("Outputs", &project::vst2_plugin::outputs),
+    value("NumberOfParameters", &project::vst2_plugin::number_of_parameters),
+    value("NumberOfPrograms", &project::vst2_plugin::number_of_programs),
+    value("Flags", &project::vst2_plugin::flags),
+    binding<vst2_preset_binding>("Preset"));
+
+inline constexpr auto vst3_plugin_fields = fields(
+    binding<vst3_preset_binding>("Preset"),
+    value("Name", &project::vst3_plugin::name),
+    node("Uid", fields(
+        value("Fields.0", &project::vst3_plugin::uid_0),
+        value("Fields.1", &project::vst3_plugin::uid_1),
+        value("Fields.2", &project::vst3_plugin::uid_2),
+        value("Fields.3", &project::vst3_plugin::uid_3))));
+
+inline constexpr auto plugin_device_fields = fields(
+    attribute("Id", &project::plugin_device::id),
+    binding<plugin_desc_binding>("PluginDesc"),
+    list("ParameterList", "PluginFloatParameter", &project::plugin_device::parameters, plugin_parameter_fields));
+
+// the devices of a track follow its mixer and sequencers, only plugin devices are bound
+inline constexpr auto devices_fields = fields(
+    node("DeviceChain", fields(
+        list("Devices", "PluginDevice", &project::device_chain::plugin_devices, plugin_device_fields))));
+
+inline constexpr auto base_track_fields = fields(
+    value("LomId", &project::base_track::lom_id),
+    value("LomIdView", &project::base_track::lom_id_view),
+    value("EnvelopeModePreferred", &project::base_track::envelope_mode_preferred),
+    node("TrackDelay", fields(
+        value("Value", &project::base_track::track_delay_value),
+        value("IsValueSampleBased", &project::base_track::track_delay_is_value_sample_based))),
+    node("Name", fields(
+        value("EffectiveName", &project::base_track::effective_name),
+        value("UserName", &project::base_track::user_name),
+        value("Annotation", &project::base_track::annotation),
+        value("MemorizedFirstClipName", &project::base_track::memorized_first_clip_name, version::v_11_0_0))),
+    value("Color", &project::base_track::color, version::v_12_0_0),
+    value("ColorIndex", &project::base_track::color_index, first_version, version::v_12_0_0),
+    node("AutomationEnvelopes", fields(
+        list("Envelopes", "AutomationEnvelope", &project::base_track::automation_envelopes, automation_envelope_fields))),
+    value("TrackGroupId", &project::base_track::track_group_id),
+    value("TrackUnfolded", &project::base_track::track_unfolded),
+    node("DevicesListWrapper", fields(
+        attribute("LomId", &project::base_track::devices_list_wrapper_lom_id))),
+    node("ClipSlotsListWrapper", fields(
+        attribute("LomId", &project::base_track::clip_slots_list_wrapper_lom_id))),
+    value("ViewData", &project::base_track::view_data));
+
+inline constexpr auto editable_track_fields = fields(
+    value("SavedPlayingSlot", &project::editable_track::saved_playing_slot),
+    value("SavedPlayingOffset", &project::editable_track::saved_playing_offset),
+    value("MidiFoldIn", &project::editable_track::midi_fold_in),
+    value("MidiPrelisten", &project::editable_track::midi_prelisten),
+    value("Freeze", &project::editable_track::freeze),
+    value("VelocityDetail", &project::editable_track::velocity_detail),
+    value("NeedArrangerRefreeze", &project::editable_track::need_arranger_refreeze),
+    value("PostProcessFreezeClips", &project::editable_track::post_process_freeze_clips),
+    value("MidiTargetPrefersFoldOrIsNotUniform", &project::editable_track::midi_target_prefers_fold_or_is_not_uniform));
+
+inline constexpr auto user_track_fields = std::tuple_cat(
+    fields(attribute("Id", &project::base_track::id)),
+    base_track_fields,
+    editable_track_fields,
+    fields(node("DeviceChain", std::tuple_cat(device_chain_fields, devices_fields))));
+
+// MIDI tracks hold their session clip slots in the main sequencer of their device chain, audio
+// tracks their arrangement clips as well
+inline constexpr auto sequencer_track_fields = std::tuple_cat(
+    fields(attribute("Id", &project::base_track::id)),
+    base_track_fields,
+    editable_track_fields,
+    fields(node("DeviceChain", std::tuple_cat(device_chain_fields, main_sequencer_fields, devices_fields))));
+
+inline constexpr auto audio_track_fields = std::tuple_cat(
+    fields(attribute("Id", &project::base_track::id)),
+    base_track_fields,
+    editable_track_fields,
+    fields(node("DeviceChain", std::tuple_cat(device_chain_fields, audio_main_sequencer_fields, devices_fields))));
+
+inline constexpr auto master_track_fields = std::tuple_cat(
+    base_track_fields,
+    fields(node("DeviceChain", std::tuple_cat(device_chain_fields, devices_fields))));
+
+inline constexpr auto pre_hear_track_fields = std::tuple_cat(
+    base_track_fields,
+    fields(node("DeviceChain", device_chain_fields)));
+
+template <typename T>
+inline constexpr std::string_view track_element_name = std::string_view();
+template <>
+inline constexpr std::string_view track_element_name<project::audio_track> = "AudioTrack";
+template <>
+inline constexpr std::string_view track_element_name<project::midi_track> = "MidiTrack";
+template <>
+inline constexpr std::string_view track_element_name<project::group_track> = "GroupTrack";
+template <>
+inline constexpr std::string_view track_element_name<project::return_track> = "ReturnTrack";
+
+// liveset
+
+struct tracks_binding;
+struct sends_pre_binding;
+
+inline constexpr auto scene_fields = fields(
+    attribute("Value", &project::scene::value),
+    value("Annotation", &project::scene::annotation),
+    value("ColorIndex", &project::scene::color_index),
+    value("LomId", &project::scene::lom_id),
+    node("ClipSlotsListWrapper", fields(
+        attribute("LomId", &project::scene::clip_slots_list_wrapper_lom_id))));
+
+inline constexpr auto liveset_fields = fields(
+    value("OverwriteProtectionNumber", &project::overwrite_protection_number),
+    value("LomId", &project::lom_id),
+    value("LomIdView", &project::lom_id_view),
+    binding<tracks_binding>("Tracks"),
+    member("MainTrack", &project::project_master_track, master_track_fields, version::v_12_0_0),
+    member("MasterTrack", &project::project_master_track, master_track_fields, first_version, version::v_12_0_0),
+    member("PreHearTrack", &project::project_prehear_track, pre_hear_track_fields),
+    binding<sends_pre_binding>("SendsPre"),
+    list("SceneNames", "Scene", &project::scene_names, scene_fields),
+    node("Transport", fields(
+        value("PhaseNudgeTempo", &project::transport_phase_nudge_tempo),
+        value("LoopOn", &project::transport_loop_on),
+        value("LoopStart", &project::transport_loop_start),
+        value("LoopLength", &project::transport_loop_length),
+        value("LoopIsSongStart", &project::transport_loop_is_song_start),
+        value("CurrentTime", &project::transport_current_time),
+        value("PunchIn", &project::transport_punch_in),
+        value("PunchOut", &project::transport_punch_out),
+        value("DrawMode", &project::transport_draw_mode),
+        value("ComputerKeyboardIsEnabled", &project::transport_computer_keyboard_is_enabled, first_version, version::v_12_0_0))),
+    node("SongMasterValues", fields(
+        node("SessionScrollerPos", fields(
+            attribute("X", &project::song_master_values_scroller_pos_x),
+            attribute("Y", &project::song_master_values_scroller_pos_y))))),
+    value("GlobalQuantisation", &project::global_quantisation),
+    value("AutoQuantisation", &project::auto_quantisation),
+    node("Grid", fields(
+        value("FixedNumerator", &project::grid_fixed_numerator),
+        value("FixedDenominator", &project::grid_fixed_denominator),
+        value("GridIntervalPixel", &project::grid_grid_interval_pixel),
+        value("Ntoles", &project::grid_ntoles),
+        value("SnapToGrid", &project::grid_snap_to_grid),
+        value("Fixed", &project::grid_fixed))),
+    node("ScaleInformation", fields(
+        value("RootNote", &project::scale_information_root_note),
+        value("Name", &project::scale_information_name))),
+    value("SmpteFormat", &project::smpte_format),
+    node("TimeSelection", fields(
+        value("AnchorTime", &project::time_selection_anchor_time),
+        value("OtherTime", &project::time_selection_other_time))),
+    node("SequencerNavigator", fields(
+        node("BeatTimeHelper", fields(
+            value("CurrentZoom", &project::sequencer_navigator_current_zoom))),
+        node("ScrollerPos", fields(
+            attribute("X", &project::sequencer_navigator_scroller_pos_x),
+            attribute("Y", &project::sequencer_navigator_scroller_pos_y))),
+        node("ClientSize", fields(
+            attribute("X", &project::sequencer_navigator_client_size_x),
+            attribute("Y", &project::sequencer_navigator_client_size_y))))),
+    value("ViewStateLaunchPanel", &project::view_state_launch_panel, first_version, version::v_12_0_0),
+    value("ViewStateEnvelopePanel", &project::view_state_envelope_panel, first_version, version::v_12_0_0),
+    value("ViewStateSamplePanel", &project::view_state_sample_panel, first_version, version::v_12_0_0),
+    node("ContentSplitterProperties", fields(
+        value("Open", &project::content_splitter_properties_open),
+        value("Size", &project::content_splitter_properties_size)), first_version, version::v_12_0_0),
+    value("ViewStateFxSlotCount", &project::view_state_fx_slot_count),
+    value("ViewStateSessionMixerHeight", &project::view_state_session_mixer_height),
+    node("Locators", fields(
+        node("Locators", fields()))),
+    node("DetailClipKeyMidis", fields()),
+    node("TracksListWrapper", fields(
+        attribute("LomId", &project::tracks_list_wrapper_lom_id))),
+    node("VisibleTracksListWrapper", fields(
+        attribute("LomId", &project::visible_tracks_list_wrapper_lom_id))),
+    node("ReturnTracksListWrapper", fields(
+        attribute("LomId", &project::return_tracks_list_wrapper_lom_id))),
+    node("ScenesListWrapper", fields(
+        attribute("LomId", &project::scenes_list_wrapper_lom_id))),
+    node("CuePointsListWrapper", fields(
+        attribute("LomId", &project::cue_points_list_wrapper_lom_id))),
+    value("ChooserBar", &project::chooser_bar),
+    value("Annotation", &project::annotation),
+    value("SoloOrPflSavedValue", &project::solo_or_pfl_saved_value),
+    value("SoloInPlace", &project::solo_in_place),
+    value("CrossfadeCurve", &project::crossfade_curve),
+    value("LatencyCompensation", &project::latency_compensation),
+    value("HighlightedTrackIndex", &project::highlighted_track_index),
+    node("GroovePool", fields(
+        node("Grooves", fields()))),
+    value("ArrangementOverdub", &project::arrangement_overdub),
+    value("ColorSequenceIndex", &project::color_sequence_index),
+    node("AutoColorPickerForPlayerAndGroupTracks", fields(
+        value("NextColorIndex", &project::auto_color_picker_for_player_and_group_tracks))),
+    node("AutoColorPickerForReturnAndMasterTracks", fields(
+        value("NextColorIndex", &project::auto_color_picker_for_return_and_master_tracks))),
+    value("ViewData", &project::view_data),
+    value("UseWarperLegacyHiQMode", &project::use_warper_legacy_hiq_mode),
+    node("VideoWindowRect", fields(
+        attribute("Top", &project::video_window_rect_top),
+        attribute("Left", &project::video_window_rect_left),
+        attribute("Bottom", &project::video_window_rect_bottom),
+        attribute("Right", &project::video_window_rect_right))),
+    value("ShowVideoWindow", &project::show_video_window),
+    value("TrackHeaderWidth", &project::track_header_width),
+    value("ViewStateArrangerHasDetail", &project::view_state_arranger_has_detail),
+    value("ViewStateSessionHasDetail", &project::view_state_session_has_detail),
+    value("ViewStateDetailIsSample", &project::view_state_detail_is_sample),
+    node("ViewStates", fields(
+        value("SessionIO", &project::view_states_session_io),
+        value("SessionSends", &project::view_states_session_sends),
+        value("SessionReturns", &project::view_states_session_returns),
+        value("SessionMixer", &project::view_states_session_mixer),
+        value("SessionTrackDelay", &project::view_states_session_track_delay),
+        value("SessionCrossFade", &project::view_states_session_cross_fade),
+        value("SessionShowOverView", &project::view_states_session_show_over_view),
+        value("ArrangerIO", &project::view_states_arranger_io),
+        value("ArrangerReturns", &project::view_states_arranger_returns),
+        value("ArrangerMixer", &project::view_states_arranger_mixer),
+        value("ArrangerTrackDelay", &project::view_states_arranger_track_delay),
+        value("ArrangerShowOverView", &project::view_states_arranger_show_over_view))));
+
+inline constexpr auto project_fields = fields(
+    attribute("MajorVersion", &project::major_version),
+    attribute("MinorVersion", &project::minor_version),
+    attribute("SchemaChangeCount", &project::schema_change_count, version::v_11_0_0),
+    attribute("Creator", &project::creator),
+    attribute("Revision", &project::revision),
+    node("LiveSet", liveset_fields));
+
+struct user_track_accessor {
+    static constexpr const auto& get()
+    {
+        return user_track_fields;
+    }
+};
+
+struct sequencer_track_accessor {
+    static constexpr const auto& get()
+    {
+        return sequencer_track_fields;
+    }
+};
+
+struct audio_track_accessor {
+    static constexpr const auto& get()
+    {
+        return audio_track_fields;
+    }
+};
+
+template <typename Track>
+using track_accessor = std::conditional_t<std::is_same_v<Track, project::audio_track>, audio_track_accessor, std::conditional_t<std::is_same_v<Track, project::midi_track>, sequencer_track_accessor, user_track_accessor>>;
+
+struct clip_slot_accessor {
+    static constexpr const auto& get()
+    {
+        return clip_slot_fields;
+    }
+};
+
+struct vst2_plugin_accessor {
+    static constexpr const auto& get()
+    {
+        return vst2_plugin_fields;
+    }
+};
+
+struct vst3_plugin_accessor {
+    static constexpr const auto& get()
+    {
+        return vst3_plugin_fields;
+    }
+};
+
+struct project_accessor {
+    static constexpr const auto& get()
+    {
+        return project_fields;
+    }
+};
+
+}
@@ -0,0 +1,522 @@
+#include <fmtals/fmtals.hpp>
+#include <fmtals/sample.hpp>
+#include <fmtals/search.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
+
+#include "mapping.hpp"
+#include "parallel.hpp"
+#include "scan.hpp"
+#include "serialize.hpp"
+#include "xml.hpp"
+
+// file layout, in host byte order: the header, the sets sorted by path, the terms sorted by field
+// and text, the posting lists of the terms as ascending set indices and the strings
+
+struct search_header {
+    char magic[8];
+    std::uint32_t format;
+    std::uint32_t set_count;
+    std::uint64_t term_count;
+    std::uint64_t sets_offset;
+    std::uint64_t terms_offset;
+    std::uint64_t postings_offset;
+    std::uint64_t strings_offset;
+    std::uint64_t size;
+};
+
+struct search_set_record {
+    std::uint64_t path_offset;
+    std::uint64_t path_size;
+    std::int64_t last_write_time;
+    std::uint64_t size;
+    std::uint64_t hash;
+};
+
+struct search_term_record {
+    std::uint64_t text_offset;
+    std::uint32_t text_size;
+    std::uint32_t field;
+    std::uint64_t posting_offset;
+    std::uint64_t posting_count;
+};
+
+static constexpr char search_magic[8] = { 'F', 'M', 'T', 'A', 'L', 'S', 'I', 'X' };
+static constexpr std::uint32_t search_format = 1;
+
+/// @brief Represents a term extracted from a set
+struct search_term {
+    fmtals::search_field field;
+    std::string text;
+};
+
+// reading
+
+template <typename T>
+static T search_read(const fmtals::search_index& index, const std::uint64_t offset)
+{
+    T _value;
+    std::memcpy(&_value, index.data.get() + offset, sizeof(T));
+    return _value;
+}
+
+static search_header search_get_header(const fmtals::search_index& index)
+{
+    if (!index.data) {
+        throw std::runtime_error("Search index is not open");
+    }
+    return search_read<search_header>(index, 0);
+}
+
+static std::string_view search_get_string(const fmtals::search_index& index, const search_header& header, const std::uint64_t offset, const std::uint64_t size)
+{
+    if (offset > header.size - header.strings_offset || size > header.size - header.strings_offset - offset) {
+        throw std::runtime_error("Invalid string in search index: " + index.path.string());
+    }
+    return std::string_view(index.data.get() + header.strings_offset + offset, static_cast<std::size_t>(size));
+}
+
+static search_term_record search_get_term(const fmtals::search_index& index, const search_header& header, const std::uint64_t term_index)
+{
+    return search_read<search_term_record>(index, header.terms_offset + term_index * sizeof(search_term_record));
+}
+
+static bool search_term_less(const fmtals::search_index& index, const search_header& header, const search_term_record& record, const fmtals::search_field field, const std::string_view text)
+{
+    if (record.field != static_cast<std::uint32_t>(field)) {
+        return record.field < static_cast<std::uint32_t>(field);
+    }
+    return search_get_string(index, header, record.text_offset, record.text_size) < text;
+}
+
+/// @brief Finds the first term that is not less than a field and a text with a binary search
+static std::uint64_t search_lower_bound(const fmtals::search_index& index, const search_header& header, const fmtals::search_field field, const std::string_view text)
+{
+    std::uint64_t _first = 0;
+    std::uint64_t _count = header.term_count;
+    while (_count) {
+        const std::uint64_t _step = _count / 2;
+        if (search_term_less(index, header, search_get_term(index, header, _first + _step), field, text)) {
+            _first += _step + 1;
+            _count -= _step + 1;
+        } else {
+            _count = _step;
+        }
+    }
+    return _first;
+}
+
+static void search_append_postings(const fmtals::search_index& index, const search_header& header, const search_term_record& record, std::vector<std::size_t>& set_indices)
+{
+    const std::uint64_t _posting_count = (header.strings_offset - header.postings_offset) / sizeof(std::uint32_t);
+    if (record.posting_offset > _posting_count || record.posting_count > _posting_count - record.posting_offset) {
+        throw std::runtime_error("Invalid posting list in search index: " + index.path.string());
+    }
+    const char* _postings = index.data.get() + header.postings_offset + record.posting_offset * sizeof(std::uint32_t);
+    for (std::uint64_t _posting = 0; _posting < record.posting_count; ++_posting) {
+        std::uint32_t _set_index;
+        std::memcpy(&_set_index, _postings + _posting * sizeof(std::uint32_t), sizeof(std::uint32_t));
+        set_indices.push_back(_set_index);
+    }
+}
+
+// extraction
+
+static std::string search_version_string(const fmtals::version ver)
+{
+    const std::uint32_t _value = static_cast<std::uint32_t>(ver) % 10000;
+    return std::to_string(_value / 100) + '.' + std::to_string(_value / 10 % 10) + '.' + std::to_string(_value % 10);
+}
+
+static void search_add_term(std::vector<search_term>& terms, const fmtals::search_field field, const std::string_view text)
+{
+    if (!text.empty()) {
+        terms.push_back(search_term { field, std::string(text) });
+    }
+}
+
+static void search_add_track(std::vector<search_term>& terms, const fmtals::project::base_track& track)
+{
+    search_add_term(terms, fmtals::search_field::track, fmtals::atom_string(track.effective_name));
+    search_add_term(terms, fmtals::search_field::track, track.user_name);
+}
+
+/// @brief Reads the name of the plugin described by a PluginDesc fragment. VST2 plugins store it
+/// as PlugName, VST3 and Audio Unit plugins as Name
+static void search_read_plugin(char* fragment, const std::size_t size, std::vector<search_term>& terms)
+{
+    xml_document _document;
+    xml_parse(_document, fragment, size);
+    const xml_node* _desc = _document.first_node("PluginDesc");
+    if (!_desc) {
+        return;
+    }
+    static const std::pair<const char*, const char*> _infos[] = {
+        { "VstPluginInfo", "PlugName" },
+        { "Vst3PluginInfo", "Name" },
+        { "AuPluginInfo", "Name" },
+    };
+    for (const std::pair<const char*, const char*>& _info : _infos) {
+        const xml_node* _info_node = _desc->first_node(_info.first);
+        const xml_node* _name_node = _info_node ? _info_node->first_node(_info.second) : nullptr;
+        if (_name_node && _name_node->first_attribute("Value")) {
+            search_add_term(terms, fmtals::search_field::plugin, _name_node->first_attribute("Value")->value());
+        }
+    }
+}
+
+/// @brief Extracts the sorted and unique terms of a set from its compressed content. The content
+/// is inflated once for the project and once for every fragment scan
+static std::vector<search_term> search_extract_terms(const std::string& content, fmtals::project& proj)
+{
+    std::vector<search_term> _terms;
+    fmtals::version _ver;
+    {
+        std::istringstream _stream(content);
+        fmtals::import_project(_stream, proj, _ver);
+    }
+    search_add_term(_terms, fmtals::search_field::version, search_version_string(_ver));
+    search_add_term(_terms, fmtals::search_field::creator, proj.creator);
+    for (const fmtals::project::user_track& _track : proj.tracks) {
+        std::visit([&](const fmtals::project::base_track& _track_visit) { search_add_track(_terms, _track_visit); }, _track);
+    }
+    for (const fmtals::project::return_track& _track : proj.return_tracks) {
+        search_add_track(_terms, _track);
+    }
+    for (const fmtals::project::scene& _scene : proj.scene_names) {
+        search_add_term(_terms, fmtals::search_field::scene, _scene.value);
+    }
+    {
+        std::istringstream _stream(content);
+        for (const fmtals::sample_reference& _reference : fmtals::scan_sample_references(_stream)) {
+            const std::string& _path = _reference.path.empty() ? _reference.relative_path : _reference.path;
+            search_add_term(_terms, fmtals::search_field::sample, _path);
+            search_add_term(_terms, fmtals::search_field::sample_name, std::string_view(_path).substr(_path.find_last_of('/') + 1));
+        }
+    }
+    {
+        std::istringstream _stream(content);
+        scan_fragments(_stream, "<PluginDesc>", "</PluginDesc>", [&](char* fragment, const std::size_t size) {
+            search_read_plugin(fragment, size, _terms);
+        });
+    }
+    std::sort(_terms.begin(), _terms.end(), [](const search_term& lhs, const search_term& rhs) {
+        return std::tie(lhs.field, lhs.text) < std::tie(rhs.field, rhs.text);
+    });
+    _terms.erase(std::unique(_terms.begin(), _terms.end(), [](const search_term& lhs, const search_term& rhs) {
+        return lhs.field == rhs.field && lhs.text == rhs.text;
+    }),
+        _terms.end());
+    return _terms;
+}
+
+// writing
+
+/// @brief Represents a set of an update, either reused from the previous index or indexed again
+struct search_entry {
+    std::filesystem::path path;
+    std::string path_string;
+    std::int64_t last_write_time = 0;
+    std::uint64_t size = 0;
+    std::uint64_t hash = 0;
+    std::size_t previous_index = static_cast<std::size_t>(-1);
+    bool indexed = false;
+    bool touched = false;
+    std::optional<std::string> error;
+    std::vector<search_term> terms;
+};
+
+template <typename T>
+static void search_append(std::string& data, const T& value)
+{
+    data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/// @brief Retrieves the terms of every set of an index from its posting lists
+static std::vector<std::vector<search_term>> search_previous_terms(const fmtals::search_index& index)
+{
+    const search_header _header = search_get_header(index);
+    std::vector<std::vector<search_term>> _terms(_header.set_count);
+    std::vector<std::size_t> _set_indices;
+    for (std::uint64_t _term_index = 0; _term_index < _header.term_count; ++_term_index) {
+        const search_term_record _record = search_get_term(index, _header, _term_index);
+        const std::string_view _text = search_get_string(index, _header, _record.text_offset, _record.text_size);
+        _set_indices.clear();
+        search_append_postings(index, _header, _record, _set_indices);
+        for (const std::size_t _set_index : _set_indices) {
+            if (_set_index >= _terms.size()) {
+                throw std::runtime_error("Invalid posting list in search index: " + index.path.string());
+            }
+            _terms[_set_index].push_back(search_term { static_cast<fmtals::search_field>(_record.field), std::string(_text) });
+        }
+    }
+    return _terms;
+}
+
+static std::string search_write_data(const std::vector<search_entry>& entries)
+{
+    std::string _strings;
+    std::unordered_map<std::string, std::vector<std::uint32_t>> _postings;
+    std::uint32_t _set_index = 0;
+    for (const search_entry& _entry : entries) {
+        for (const search_term& _term : _entry.terms) {
+            std::string _key;
+            _key.reserve(1 + _term.text.size());
+            _key += static_cast<char>(_term.field);
+            _key += _term.text;
+            _postings[std::move(_key)].push_back(_set_index);
+        }
+        ++_set_index;
+    }
+    std::vector<const std::pair<const std::string, std::vector<std::uint32_t>>*> _sorted_postings;
+    _sorted_postings.reserve(_postings.size());
+    for (const std::pair<const std::string, std::vector<std::uint32_t>>& _posting : _postings) {
+        _sorted_postings.push_back(&_posting);
+    }
+    std::sort(_sorted_postings.begin(), _sorted_postings.end(), [](const auto* lhs, const auto* rhs) { return lhs->first < rhs->first; });
+
+    search_header _header {};
+    std::memcpy(_header.magic, search_magic, sizeof(search_magic));
+    _header.format = search_format;
+    _header.set_count = static_cast<std::uint32_t>(entries.size());
+    _header.term_count = _sorted_postings.size();
+    _header.sets_offset = sizeof(search_header);
+    _header.terms_offset = _header.sets_offset + entries.size() * sizeof(search_set_record);
+    std::uint64_t _posting_total = 0;
+    for (const auto* _posting : _sorted_postings) {
+        _posting_total += _posting->second.size();
+    }
+    _header.postings_offset = _header.terms_offset + _sorted_postings.size() * sizeof(search_term_record);
+    _header.strings_offset = _header.postings_offset + _posting_total * sizeof(std::uint32_t);
+
+    std::string _data;
+    _data.reserve(static_cast<std::size_t>(_header.strings_offset));
+    search_append(_data, _header);
+    for (const search_entry& _entry : entries) {
+        search_set_record _record {};
+        _record.path_offset = _strings.size();
+        _record.path_size = _entry.path_string.size();
+        _record.last_write_time = _entry.last_write_time;
+        _record.size = _entry.size;
+        _record.hash = _entry.hash;
+        _strings += _entry.path_string;
+        search_append(_data, _record);
+    }
+    std::uint64_t _posting_offset = 0;
+    for (const auto* _posting : _sorted_postings) {
+        search_term_record _record {};
+        _record.text_offset = _strings.size();
+        _record.text_size = static_cast<std::uint32_t>(_posting->first.size() - 1);
+        _record.field = static_cast<std::uint8_t>(_posting->first[0]);
+        _record.posting_offset = _posting_offset;
+        _record.posting_count = _posting->second.size();
+        _strings.append(_posting->first, 1, std::string::npos);
+        _posting_offset += _posting->second.size();
+        search_append(_data, _record);
+    }
+    for (const auto* _posting : _sorted_postings) {
+        _data.append(reinterpret_cast<const char*>(_posting->second.data()), _posting->second.size() * sizeof(std::uint32_t));
+    }
+    _data += _strings;
+    const std::uint64_t _size = _data.size();
+    std::memcpy(_data.data() + offsetof(search_header, size), &_size, sizeof(_size));
+    return _data;
+}
+
+namespace fmtals {
+
+search_update update_search_index(const std::filesystem::path& path, const std::vector<std::filesystem::path>& set_paths, const std::size_t jobs)
+{
+    search_update _update;
+    search_index _previous;
+    std::unordered_map<std::string, std::size_t> _previous_indices;
+    if (std::filesystem::exists(path)) {
+        // an index of another format is indexed again from scratch
+        try {
+            open_search_index(path, _previous);
+            for (std::size_t _set_index = 0; _set_index < search_set_count(_previous); ++_set_index) {
+                _previous_indices.emplace(std::string(get_search_set(_previous, _set_index).path), _set_index);
+            }
+        } catch (const std::runtime_error&) {
+            _previous = search_index();
+            _previous_indices.clear();
+        }
+    }
+
+    std::vector<search_entry> _entries(set_paths.size());
+    for (std::size_t _entry_index = 0; _entry_index < set_paths.size(); ++_entry_index) {
+        _entries[_entry_index].path = set_paths[_entry_index];
+        _entries[_entry_index].path_string = set_paths[_entry_index].u8string();
+    }
+    std::sort(_entries.begin(), _entries.end(), [](const search_entry& lhs, const search_entry& rhs) { return lhs.path_string < rhs.path_string; });
+    _entries.erase(std::unique(_entries.begin(), _entries.end(), [](const search_entry& lhs, const search_entry& rhs) { return lhs.path_string == rhs.path_string; }), _entries.end());
+
+    parallel_for(
+        _entries.size(), jobs, []() { return project(); },
+        [&](project& proj, const std::size_t index) {
+            search_entry& _entry = _entries[index];
+            try {
+                _entry.size = std::filesystem::file_size(_entry.path);
+                _entry.last_write_time = std::filesystem::last_write_time(_entry.path).time_since_epoch().count();
+                const std::unordered_map<std::string, std::size_t>::const_iterator _previous_index = _previous_indices.find(_entry.path_string);
+                const bool _has_previous = _previous_index != _previous_indices.end();
+                search_set _previous_set;
+                if (_has_previous) {
+                    _previous_set = get_search_set(_previous, _previous_index->second);
+                    if (_previous_set.last_write_time == _entry.last_write_time && _previous_set.size == _entry.size) {
+                        _entry.hash = _previous_set.hash;
+                        _entry.previous_index = _previous_index->second;
+                        return;
+                    }
+                }
+                std::ifstream _stream(_entry.path, std::ios::binary);
+                if (!_stream) {
+                    throw std::runtime_error("Could not read file");
+                }
+                const std::string _content((std::istreambuf_iterator<char>(_stream)), std::istreambuf_iterator<char>());
+                _entry.size = _content.size();
+                _entry.hash = hash_bytes(_content.data(), _content.size());
+                if (_has_previous && _previous_set.hash == _entry.hash && _previous_set.size == _entry.size) {
+                    _entry.previous_index = _previous_index->second;
+                    _entry.touched = true;
+                    return;
+                }
+                _entry.terms = search_extract_terms(_content, proj);
+                _entry.indexed = true;
+            } catch (const std::exception& _exception) {
+                _entry.error = _exception.what();
+            }
+        });
+
+    std::size_t _kept_count = 0;
+    bool _changed = !_previous.data;
+    for (const search_entry& _entry : _entries) {
+        if (_entry.error) {
+            _update.failed.emplace_back(_entry.path, *_entry.error);
+            continue;
+        }
+        _kept_count += _previous_indices.count(_entry.path_string);
+        _changed = _changed || _entry.indexed || _entry.touched;
+    }
+    _update.removed = _previous_indices.size() - _kept_count;
+    if (!_changed && !_update.removed) {
+        // the previous index already holds every set with its last write time
+        _update.reused = _kept_count;
+        return _update;
+    }
+    std::vector<std::vector<search_term>> _previous_terms;
+    for (search_entry& _entry : _entries) {
+        if (_entry.error) {
+            continue;
+        }
+        if (_entry.indexed) {
+            ++_update.indexed;
+        } else {
+            if (_previous_terms.empty()) {
+                _previous_terms = search_previous_terms(_previous);
+            }
+            _entry.terms = std::move(_previous_terms[_entry.previous_index]);
+            ++_update.reused;
+        }
+    }
+    _entries.erase(std::remove_if(_entries.begin(), _entries.end(), [](const search_entry& _entry) { return _entry.error.has_value(); }), _entries.end());
+
+    const std::string _data = search_write_data(_entries);
+    _previous = search_index();
+    // an interrupted update never leaves a partial index behind
+    write_file_atomically(path, [&](std::ostream& stream) {
+        stream.write(_data.data(), static_cast<std::streamsize>(_data.size()));
+    });
+    return _update;
+}
+
+void open_search_index(const std::filesystem::path& path, search_index& index)
+{
+    search_index _index;
+    _index.path = path;
+    _index.data = map_file(path, _index.size);
+    if (_index.size < sizeof(search_header)) {
+        throw std::runtime_error("Invalid search index: " + path.string());
+    }
+    const search_header _header = search_read<search_header>(_index, 0);
+    if (std::memcmp(_header.magic, search_magic, sizeof(search_magic)) != 0) {
+        throw std::runtime_error("Invalid search index: " + path.string());
+    }
+    if (_header.format != search_format) {
+        throw std::runtime_error("Unsupported search index format: " + std::to_string(_header.format));
+    }
+    const bool _valid = _header.size == _index.size
+        && _header.sets_offset == sizeof(search_header)
+        && _header.terms_offset == _header.sets_offset + static_cast<std::uint64_t>(_header.set_count) * sizeof(search_set_record)
+        && _header.term_count <= (_index.size - _header.terms_offset) / sizeof(search_term_record)
+        && _header.postings_offset == _header.terms_offset + _header.term_count * sizeof(search_term_record)
+        && _header.strings_offset >= _header.postings_offset
+        && _header.strings_offset <= _index.size
+        && (_header.strings_offset - _header.postings_offset) % sizeof(std::uint32_t) == 0;
+    if (!_valid) {
+        throw std::runtime_error("Invalid search index: " + path.string());
+    }
+    index = std::move(_index);
+}
+
+std::size_t search_set_count(const search_index& index)
+{
+    return search_get_header(index).set_count;
+}
+
+search_set get_search_set(const search_index& index, const std::size_t set_index)
+{
+    const search_header _header = search_get_header(index);
+    if (set_index >= _header.set_count) {
+        throw std::runtime_error("Invalid set index: " + std::to_string(set_index));
+    }
+    const search_set_record _record = search_read<search_set_record>(index, _header.sets_offset + set_index * sizeof(search_set_record));
+    search_set _set;
+    _set.path = search_get_string(index, _header, _record.path_offset, _record.path_size);
+    _set.last_write_time = _record.last_write_time;
+    _set.size = _record.size;
+    _set.hash = _record.hash;
+    return _set;
+}
+
+void find_search_sets(const search_index& index, const search_field field, const std::string_view term, std::vector<std::size_t>& set_indices)
+{
+    set_indices.clear();
+    const search_header _header = search_get_header(index);
+    const std::uint64_t _term_index = search_lower_bound(index, _header, field, term);
+    if (_term_index == _header.term_count) {
+        return;
+    }
+    const search_term_record _record = search_get_term(index, _header, _term_index);
+    if (_record.field == static_cast<std::uint32_t>(field) && search_get_string(index, _header, _record.text_offset, _record.text_size) == term) {
+        search_append_postings(index, _header, _record, set_indices);
+    }
+}
+
+void find_search_sets_by_prefix(const search_index& index, const search_field field, const std::string_view prefix, std::vector<std::size_t>& set_indices)
+{
+    set_indices.clear();
+    const search_header _header = search_get_header(index);
+    for (std::uint64_t _term_index = search_lower_bound(index, _header, field, prefix); _term_index < _header.term_count; ++_term_index) {
+        const search_term_record _record = search_get_term(index, _header, _term_index);
+        if (_record.field != static_cast<std::uint32_t>(field) || search_get_string(index, _header, _record.text_offset, _record.text_size).substr(0, prefix.size()) != prefix) {
+            break;
+        }
+        search_append_postings(index, _header, _record, set_indices);
+    }
+    std::sort(set_indices.begin(), set_indices.end());
+    set_indices.erase(std::unique(set_indices.begin(), set_indices.end()), set_indices.end());
+}
+
+}
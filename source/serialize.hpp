@@ -0,0 +1,284 @@
+#pragma once
+
+#include <fmtals/fmtals.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <streambuf>
+#include <string>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/optional.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+// Binary field lists for the project data structure. Tracks are split into names, header and
+// device chain so that each part can be hashed or stored on its own. The field lists that are not
+// cereal serialize functions take the object as a template parameter so that they also accept
+// const objects when writing.
+
+namespace fmtals {
+
+template <typename Archive>
+std::string save_minimal(const Archive&, const atom& value)
+{
+    return atom_string(value);
+}
+
+template <typename Archive>
+void load_minimal(const Archive&, atom& value, const std::string& str)
+{
+    value = make_atom(str);
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::warp_marker& marker)
+{
+    archive(marker.sec_time, marker.beat_time);
+}
+
+template <typename Archive, typename T>
+void serialize_clip_position(Archive& archive, T& clip)
+{
+    archive(clip.time, clip.current_start, clip.current_end);
+}
+
+template <typename Archive, typename T>
+void serialize_clip_content(Archive& archive, T& clip)
+{
+    archive(clip.lom_id, clip.lom_id_view, clip.warp_markers, clip.markers_generated);
+    archive(clip.loop_start, clip.loop_end, clip.loop_start_relative, clip.loop_on, clip.loop_out_marker, clip.hidden_loop_start, clip.hidden_loop_end);
+    archive(clip.name, clip.annotation, clip.color_index, clip.color, clip.launch_mode, clip.launch_quantisation);
+    archive(clip.scroller_time_preserver_left_time, clip.scroller_time_preserver_right_time, clip.time_selection_anchor_time, clip.time_selection_other_time);
+    archive(clip.legato, clip.ram, clip.disabled, clip.velocity_amount);
+    archive(clip.follow_time, clip.follow_action_a, clip.follow_action_b, clip.follow_chance_a, clip.follow_chance_b);
+    archive(clip.grid_fixed_numerator, clip.grid_fixed_denominator, clip.grid_interval_pixel, clip.grid_ntoles, clip.grid_snap_to_grid, clip.grid_fixed);
+    archive(clip.freeze_start, clip.freeze_end, clip.is_song_tempo_master, clip.is_warped);
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::audio_clip& clip)
+{
+    serialize_clip_position(archive, clip);
+    serialize_clip_content(archive, clip);
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::automation_lane& lane)
+{
+    archive(lane.selected_device, lane.selected_envelope, lane.is_content_selected, lane.lane_height, lane.fade_view_visible);
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::clip_slot& slot)
+{
+    archive(slot.id, slot.lom_id, slot.has_clip, slot.clip_index, slot.clip_color, slot.clip_color_index, slot.has_stop, slot.need_refreeze);
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::automation_event& event)
+{
+    archive(event.id, event.time, event.value);
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::automation_envelope& envelope)
+{
+    archive(envelope.id, envelope.pointee_id, envelope.events);
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::plugin_parameter& parameter)
+{
+    archive(parameter.id, parameter.name, parameter.parameter_id, parameter.value);
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::vst2_plugin& plugin)
+{
+    archive(plugin.path, plugin.plug_name, plugin.unique_id, plugin.inputs, plugin.outputs);
+    archive(plugin.number_of_parameters, plugin.number_of_programs, plugin.flags, plugin.has_preset, plugin.preset_id, plugin.buffer);
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::vst3_plugin& plugin)
+{
+    archive(plugin.has_preset, plugin.preset_id, plugin.processor_state, plugin.controller_state);
+    archive(plugin.name, plugin.uid_0, plugin.uid_1, plugin.uid_2, plugin.uid_3);
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::plugin_device& device)
+{
+    archive(device.id, device.vst2, device.vst3, device.parameters);
+}
+
+template <typename Archive, typename T>
+void serialize_device_chain_settings(Archive& archive, T& chain)
+{
+    archive(chain.permanent_lanes_are_visible, chain.envelope_chooser_selected_device, chain.envelope_chooser_selected_envelope);
+    archive(chain.audio_input_routing_target, chain.audio_input_routing_upper_display_string, chain.audio_input_routing_lower_display_string);
+    archive(chain.midi_input_routing_target, chain.midi_input_routing_upper_display_string, chain.midi_input_routing_lower_display_string);
+    archive(chain.audio_output_routing_target, chain.audio_output_routing_upper_display_string, chain.audio_output_routing_lower_display_string);
+    archive(chain.midi_output_routing_target, chain.midi_output_routing_upper_display_string, chain.midi_output_routing_lower_display_string);
+    archive(chain.mixer_lom_id, chain.mixer_lom_id_view, chain.is_expanded);
+    archive(chain.tempo_lom_id, chain.tempo, chain.tempo_automation_target_id);
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::device_chain& chain)
+{
+    archive(chain.automation_lanes);
+    serialize_device_chain_settings(archive, chain);
+    archive(chain.plugin_devices);
+}
+
+template <typename Archive, typename T>
+void serialize_track_names(Archive& archive, T& track)
+{
+    archive(track.effective_name, track.user_name, track.memorized_first_clip_name);
+}
+
+template <typename Archive, typename T>
+void serialize_track_header(Archive& archive, T& track)
+{
+    archive(track.id, track.lom_id, track.lom_id_view, track.envelope_mode_preferred, track.track_delay_value, track.track_delay_is_value_sample_based);
+    archive(track.annotation, track.color, track.color_index, track.automation_envelopes, track.track_group_id, track.track_unfolded);
+    archive(track.devices_list_wrapper_lom_id, track.clip_slots_list_wrapper_lom_id, track.view_data);
+    if constexpr (std::is_base_of_v<project::editable_track, T>) {
+        archive(track.saved_playing_slot, track.saved_playing_offset, track.midi_fold_in, track.midi_prelisten, track.freeze, track.velocity_detail);
+        archive(track.need_arranger_refreeze, track.post_process_freeze_clips, track.midi_target_prefers_fold_or_is_not_uniform);
+        archive(track.main_sequencer_lom_id, track.clip_slots, track.session_clips);
+    }
+}
+
+template <typename Archive>
+void serialize(Archive& archive, project::scene& scene)
+{
+    archive(scene.value, scene.annotation, scene.color_index, scene.lom_id, scene.clip_slots_list_wrapper_lom_id);
+}
+
+template <typename Archive, typename T>
+void serialize_settings(Archive& archive, T& proj)
+{
+    archive(proj.major_version, proj.minor_version, proj.creator, proj.revision, proj.schema_change_count);
+    archive(proj.overwrite_protection_number, proj.lom_id, proj.lom_id_view, proj.sends_pre);
+    archive(proj.transport_phase_nudge_tempo, proj.transport_loop_on, proj.transport_loop_start, proj.transport_loop_length, proj.transport_loop_is_song_start);
+    archive(proj.transport_current_time, proj.transport_punch_in, proj.transport_punch_out, proj.transport_metronome_tick_duration);
+    archive(proj.transport_draw_mode, proj.transport_computer_keyboard_is_enabled);
+    archive(proj.song_master_values_scroller_pos_x, proj.song_master_values_scroller_pos_y, proj.global_quantisation, proj.auto_quantisation);
+    archive(proj.grid_fixed_numerator, proj.grid_fixed_denominator, proj.grid_grid_interval_pixel, proj.grid_ntoles, proj.grid_snap_to_grid, proj.grid_fixed);
+    archive(proj.scale_information_root_note, proj.scale_information_name, proj.in_key, proj.smpte_format);
+    archive(proj.time_selection_anchor_time, proj.time_selection_other_time);
+    archive(proj.sequencer_navigator_current_zoom, proj.sequencer_navigator_scroller_pos_x, proj.sequencer_navigator_scroller_pos_y);
+    archive(proj.sequencer_navigator_client_size_x, proj.sequencer_navigator_client_size_y);
+    archive(proj.is_content_splitter_open, proj.is_expression_splitter_open);
+    archive(proj.view_state_launch_panel, proj.view_state_envelope_panel, proj.view_state_sample_panel);
+    archive(proj.content_splitter_properties_open, proj.content_splitter_properties_size);
+    archive(proj.view_state_fx_slot_count, proj.view_state_session_mixer_height, proj.locators);
+    archive(proj.tracks_list_wrapper_lom_id, proj.visible_tracks_list_wrapper_lom_id, proj.return_tracks_list_wrapper_lom_id);
+    archive(proj.scenes_list_wrapper_lom_id, proj.cue_points_list_wrapper_lom_id);
+    archive(proj.chooser_bar, proj.annotation, proj.solo_or_pfl_saved_value, proj.solo_in_place, proj.crossfade_curve, proj.latency_compensation);
+    archive(proj.highlighted_track_index, proj.groove_pool, proj.arrangement_overdub, proj.color_sequence_index);
+    archive(proj.auto_color_picker_for_player_and_group_tracks, proj.auto_color_picker_for_return_and_master_tracks);
+    archive(proj.view_data, proj.use_warper_legacy_hiq_mode);
+    archive(proj.video_window_rect_top, proj.video_window_rect_bottom, proj.video_window_rect_left, proj.video_window_rect_right);
+    archive(proj.show_video_window, proj.track_header_width);
+    archive(proj.view_state_arranger_has_detail, proj.view_state_session_has_detail, proj.view_state_detail_is_sample);
+    archive(proj.view_states_session_io, proj.view_states_session_sends, proj.view_states_session_returns, proj.view_states_session_mixer);
+    archive(proj.view_states_session_track_delay, proj.view_states_session_cross_fade, proj.view_states_session_show_over_view);
+    archive(proj.view_states_arranger_io, proj.view_states_arranger_returns, proj.view_states_arranger_mixer);
+    archive(proj.view_states_arranger_track_delay, proj.view_states_arranger_show_over_view);
+}
+
+}
+
+// hash
+
+/// @brief Folds one 8 byte word into a hash
+inline std::uint64_t hash_word(const std::uint64_t value, const std::uint64_t word)
+{
+    const std::uint64_t _value = (value ^ word) * 0x9e3779b97f4a7c15ull;
+    return _value ^ (_value >> 29);
+}
+
+/// @brief Stream buffer that hashes what is written to it 8 bytes at a time. Writes are gathered
+/// in a put area so that small fields cost a copy instead of a virtual call. The hash depends on
+/// the host byte order and is only meant to be compared in memory, call finish before reading it
+struct hash_streambuf : std::streambuf {
+    std::uint64_t value = 14695981039346656037ull;
+
+    hash_streambuf()
+    {
+        setp(_buffer, _buffer + sizeof(_buffer));
+    }
+
+    hash_streambuf(const hash_streambuf&) = delete;
+    hash_streambuf& operator=(const hash_streambuf&) = delete;
+
+    /// @brief Folds the pending bytes and the total size into the value
+    void finish()
+    {
+        const std::size_t _pending = static_cast<std::size_t>(pptr() - pbase());
+        fold(_pending);
+        if (_pending % 8) {
+            std::uint64_t _word = 0;
+            std::memcpy(&_word, _buffer + _pending - _pending % 8, _pending % 8);
+            value = hash_word(value, _word);
+        }
+        _size += _pending;
+        value = hash_word(value, _size);
+        setp(_buffer, _buffer + sizeof(_buffer));
+    }
+
+protected:
+    int_type overflow(int_type character) override
+    {
+        fold(sizeof(_buffer));
+        _size += sizeof(_buffer);
+        setp(_buffer, _buffer + sizeof(_buffer));
+        if (!traits_type::eq_int_type(character, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(character);
+            pbump(1);
+        }
+        return traits_type::not_eof(character);
+    }
+
+private:
+    alignas(8) char _buffer[4096];
+    std::uint64_t _size = 0;
+
+    void fold(const std::size_t size)
+    {
+        for (std::size_t _offset = 0; _offset + 8 <= size; _offset += 8) {
+            std::uint64_t _word;
+            std::memcpy(&_word, _buffer + _offset, 8);
+            value = hash_word(value, _word);
+        }
+    }
+};
+
+/// @brief Hashes a contiguous buffer with 64-bit FNV-1a. Unlike hash_streambuf the value does not
+/// depend on the host and can be stored
+inline std::uint64_t hash_bytes(const char* data, const std::size_t size)
+{
+    std::uint64_t _value = 14695981039346656037ull;
+    for (std::size_t _index = 0; _index < size; ++_index) {
+        _value = (_value ^ static_cast<unsigned char>(data[_index])) * 1099511628211ull;
+    }
+    return _value;
+}
+
+/// @brief Hashes everything the callback writes to the binary archive it receives
+template <typename Callback>
+std::uint64_t hash_archive(Callback&& callback)
+{
+    hash_streambuf _buffer;
+    std::ostream _stream(&_buffer);
+    {
+        cereal::BinaryOutputArchive _archive(_stream);
+        callback(_archive);
+    }
+    _buffer.finish();
+    return _buffer.value;
+}
@@ -0,0 +1,52 @@
+#include <fmtals/session.hpp>
+
+#include <algorithm>
+#include <variant>
+
+namespace fmtals {
+
+void index_session(const project& proj, session_matrix& matrix)
+{
+    matrix.track_count = proj.tracks.size();
+    matrix.scene_count = proj.scene_names.size();
+    matrix.slot_track_count = 0;
+    matrix.slots.assign(matrix.track_count * matrix.scene_count, session_slot());
+    matrix.clip_counts.assign(matrix.scene_count, 0);
+    for (std::size_t _track_index = 0; _track_index < matrix.track_count; ++_track_index) {
+        const project::editable_track& _track = std::visit([](const project::editable_track& _track_visit) -> const project::editable_track& { return _track_visit; }, proj.tracks[_track_index]);
+        if (_track.clip_slots.empty()) {
+            continue;
+        }
+        ++matrix.slot_track_count;
+        const std::size_t _slot_count = std::min(_track.clip_slots.size(), matrix.scene_count);
+        for (std::size_t _scene_index = 0; _scene_index < _slot_count; ++_scene_index) {
+            const project::clip_slot& _clip_slot = _track.clip_slots[_scene_index];
+            session_slot& _slot = matrix.slots[_scene_index * matrix.track_count + _track_index];
+            _slot.has_clip = _clip_slot.has_clip;
+            _slot.clip_index = _clip_slot.has_clip ? _clip_slot.clip_index : 0;
+            _slot.has_stop = _clip_slot.has_stop;
+            _slot.color = _clip_slot.clip_color.value_or(_clip_slot.clip_color_index.value_or(0));
+            matrix.clip_counts[_scene_index] += _clip_slot.has_clip;
+        }
+    }
+}
+
+const session_slot* find_session_slot(const session_matrix& matrix, const std::size_t track_index, const std::size_t scene_index)
+{
+    if (track_index >= matrix.track_count || scene_index >= matrix.scene_count) {
+        return nullptr;
+    }
+    return &matrix.slots[scene_index * matrix.track_count + track_index];
+}
+
+void find_full_scenes(const session_matrix& matrix, std::vector<std::size_t>& scene_indices)
+{
+    scene_indices.clear();
+    for (std::size_t _scene_index = 0; _scene_index < matrix.scene_count; ++_scene_index) {
+        if (matrix.slot_track_count && matrix.clip_counts[_scene_index] == matrix.slot_track_count) {
+            scene_indices.push_back(_scene_index);
+        }
+    }
+}
+
+}
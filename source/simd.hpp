@@ -0,0 +1,219 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Byte scanning helpers shared by the XML parser and printer, and the hex codec of plugin states.
+// The widest instruction set enabled at compile time is used, building with -mavx2 or /arch:AVX2
+// selects the AVX2 path and any x86-64 build has SSE2. FMTALS_NO_SIMD forces the scalar path on
+// every target.
+
+#if !defined(FMTALS_NO_SIMD) && defined(__AVX2__)
+#define FMTALS_SIMD_AVX2
+#include <immintrin.h>
+#elif !defined(FMTALS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define FMTALS_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/// @brief Retrieves the index of the lowest set bit of a non zero mask
+inline unsigned simd_first_bit(const std::uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long _index;
+    _BitScanForward(&_index, mask);
+    return static_cast<unsigned>(_index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+#if defined(FMTALS_SIMD_AVX2)
+static constexpr std::size_t simd_width = 32;
+using simd_block = __m256i;
+
+inline simd_block simd_load(const char* data)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+}
+
+template <char First, char... Chars>
+simd_block simd_equal(const simd_block block)
+{
+    const __m256i _matches = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(First));
+    if constexpr (sizeof...(Chars) != 0) {
+        return _mm256_or_si256(_matches, simd_equal<Chars...>(block));
+    } else {
+        return _matches;
+    }
+}
+
+template <char... Chars>
+std::uint32_t simd_match(const simd_block block)
+{
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(simd_equal<Chars...>(block)));
+}
+#elif defined(FMTALS_SIMD_SSE2)
+static constexpr std::size_t simd_width = 16;
+using simd_block = __m128i;
+
+inline simd_block simd_load(const char* data)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+template <char First, char... Chars>
+simd_block simd_equal(const simd_block block)
+{
+    const __m128i _matches = _mm_cmpeq_epi8(block, _mm_set1_epi8(First));
+    if constexpr (sizeof...(Chars) != 0) {
+        return _mm_or_si128(_matches, simd_equal<Chars...>(block));
+    } else {
+        return _matches;
+    }
+}
+
+template <char... Chars>
+std::uint32_t simd_match(const simd_block block)
+{
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(simd_equal<Chars...>(block)));
+}
+#else
+static constexpr std::size_t simd_width = 0;
+#endif
+
+template <char... Chars>
+constexpr bool simd_is_any(const char character)
+{
+    return ((character == Chars) || ...);
+}
+
+/// @brief Finds the first character of [begin, end) that is one of Chars, or end
+template <char... Chars>
+const char* simd_find(const char* begin, const char* end)
+{
+#if defined(FMTALS_SIMD_AVX2) || defined(FMTALS_SIMD_SSE2)
+    for (; static_cast<std::size_t>(end - begin) >= simd_width; begin += simd_width) {
+        const std::uint32_t _mask = simd_match<Chars...>(simd_load(begin));
+        if (_mask) {
+            return begin + simd_first_bit(_mask);
+        }
+    }
+#endif
+    for (; begin != end && !simd_is_any<Chars...>(*begin); ++begin) { }
+    return begin;
+}
+
+/// @brief Finds the first character of [begin, end) that is none of Chars, or end
+template <char... Chars>
+const char* simd_skip(const char* begin, const char* end)
+{
+#if defined(FMTALS_SIMD_AVX2) || defined(FMTALS_SIMD_SSE2)
+    constexpr std::uint32_t _all = simd_width == 32 ? 0xffffffffu : 0xffffu;
+    for (; static_cast<std::size_t>(end - begin) >= simd_width; begin += simd_width) {
+        const std::uint32_t _mask = simd_match<Chars...>(simd_load(begin)) ^ _all;
+        if (_mask) {
+            return begin + simd_first_bit(_mask);
+        }
+    }
+#endif
+    for (; begin != end && simd_is_any<Chars...>(*begin); ++begin) { }
+    return begin;
+}
+
+template <char... Chars>
+char* simd_find(char* begin, char* end)
+{
+    return const_cast<char*>(simd_find<Chars...>(static_cast<const char*>(begin), static_cast<const char*>(end)));
+}
+
+template <char... Chars>
+char* simd_skip(char* begin, char* end)
+{
+    return const_cast<char*>(simd_skip<Chars...>(static_cast<const char*>(begin), static_cast<const char*>(end)));
+}
+
+#if defined(FMTALS_SIMD_AVX2) || defined(FMTALS_SIMD_SSE2)
+/// @brief Converts 16 hex digits to their values. Returns false when one of them is not a digit
+inline bool simd_hex_nibbles(const __m128i digits, __m128i& nibbles)
+{
+    const __m128i _lower = _mm_or_si128(digits, _mm_set1_epi8(0x20));
+    const __m128i _decimal = _mm_and_si128(_mm_cmpgt_epi8(digits, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(digits, _mm_set1_epi8('9' + 1)));
+    const __m128i _letter = _mm_and_si128(_mm_cmpgt_epi8(_lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(_lower, _mm_set1_epi8('f' + 1)));
+    if (_mm_movemask_epi8(_mm_or_si128(_decimal, _letter)) != 0xffff) {
+        return false;
+    }
+    // the low 4 bits are 0 to 9 for decimal digits and 1 to 6 for letters in either case
+    nibbles = _mm_add_epi8(_mm_and_si128(digits, _mm_set1_epi8(0x0f)), _mm_and_si128(_letter, _mm_set1_epi8(9)));
+    return true;
+}
+
+/// @brief Joins the nibbles of 8 digit pairs, high nibble first, into the low byte of each 16 bit lane
+inline __m128i simd_hex_join(const __m128i nibbles)
+{
+    return _mm_and_si128(_mm_or_si128(_mm_slli_epi16(nibbles, 4), _mm_srli_epi16(nibbles, 8)), _mm_set1_epi16(0x00ff));
+}
+
+/// @brief Converts 16 values from 0 to 15 to upper case hex digits
+inline __m128i simd_hex_digits(const __m128i nibbles)
+{
+    const __m128i _letter = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), _mm_and_si128(_letter, _mm_set1_epi8('A' - '0' - 10)));
+}
+#endif
+
+/// @brief Decodes hex digits into bytes as long as the text holds only digits, in blocks of 32 and
+/// then 16 digits. Returns the number of digits decoded, always even, the rest of the text,
+/// starting at the first whitespace or invalid character of a block, is left to the caller. Both
+/// SIMD paths use SSE2 instructions
+inline std::size_t simd_decode_hex(const char* text, const std::size_t size, std::uint8_t* output)
+{
+    std::size_t _index = 0;
+#if defined(FMTALS_SIMD_AVX2) || defined(FMTALS_SIMD_SSE2)
+    __m128i _first;
+    __m128i _second;
+    for (; size - _index >= 32; _index += 32) {
+        if (!simd_hex_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + _index)), _first)
+            || !simd_hex_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + _index + 16)), _second)) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + _index / 2), _mm_packus_epi16(simd_hex_join(_first), simd_hex_join(_second)));
+    }
+    if (size - _index >= 16 && simd_hex_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + _index)), _first)) {
+        const __m128i _bytes = simd_hex_join(_first);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output + _index / 2), _mm_packus_epi16(_bytes, _bytes));
+        _index += 16;
+    }
+#else
+    static_cast<void>(text);
+    static_cast<void>(size);
+    static_cast<void>(output);
+#endif
+    return _index;
+}
+
+/// @brief Encodes bytes as upper case hex digits in blocks of 16 bytes. Returns the number of bytes
+/// encoded, the rest is left to the caller
+inline std::size_t simd_encode_hex(const std::uint8_t* data, const std::size_t size, char* output)
+{
+    std::size_t _index = 0;
+#if defined(FMTALS_SIMD_AVX2) || defined(FMTALS_SIMD_SSE2)
+    const __m128i _mask = _mm_set1_epi8(0x0f);
+    for (; size - _index >= 16; _index += 16) {
+        const __m128i _bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + _index));
+        const __m128i _high = _mm_and_si128(_mm_srli_epi16(_bytes, 4), _mask);
+        const __m128i _low = _mm_and_si128(_bytes, _mask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + _index * 2), simd_hex_digits(_mm_unpacklo_epi8(_high, _low)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + _index * 2 + 16), simd_hex_digits(_mm_unpackhi_epi8(_high, _low)));
+    }
+#else
+    static_cast<void>(data);
+    static_cast<void>(size);
+    static_cast<void>(output);
+#endif
+    return _index;
+}
@@ -0,0 +1,85 @@
+#include <fmtals/snapshot.hpp>
+
+#include <type_traits>
+#include <variant>
+
+template <typename T>
+static fmtals::project::device_chain& snapshot_get_device_chain(T& track)
+{
+    if constexpr (std::is_same_v<T, fmtals::project::user_track>) {
+        return std::visit([](auto& _track_visit) -> fmtals::project::device_chain& { return _track_visit; }, track);
+    } else {
+        return track;
+    }
+}
+
+template <typename T>
+static void snapshot_make_track(T& track, fmtals::snapshot_track<T>& node)
+{
+    fmtals::project::device_chain& _device_chain = snapshot_get_device_chain(track);
+    node.device_chain = std::make_shared<const fmtals::project::device_chain>(std::move(_device_chain));
+    _device_chain = fmtals::project::device_chain();
+    node.header = std::make_shared<const T>(std::move(track));
+}
+
+template <typename T>
+static void snapshot_load_track(const fmtals::snapshot_track<T>& node, T& track)
+{
+    track = *node.header;
+    snapshot_get_device_chain(track) = *node.device_chain;
+}
+
+namespace fmtals {
+
+void make_project_snapshot(project proj, project_snapshot& snapshot)
+{
+    snapshot.tracks.resize(proj.tracks.size());
+    for (std::size_t _index = 0; _index < proj.tracks.size(); ++_index) {
+        snapshot_make_track(proj.tracks[_index], snapshot.tracks[_index]);
+    }
+    snapshot.return_tracks.resize(proj.return_tracks.size());
+    for (std::size_t _index = 0; _index < proj.return_tracks.size(); ++_index) {
+        snapshot_make_track(proj.return_tracks[_index], snapshot.return_tracks[_index]);
+    }
+    snapshot_make_track(proj.project_master_track, snapshot.master_track);
+    snapshot_make_track(proj.project_prehear_track, snapshot.pre_hear_track);
+    snapshot.scenes.resize(proj.scene_names.size());
+    for (std::size_t _index = 0; _index < proj.scene_names.size(); ++_index) {
+        snapshot.scenes[_index] = std::make_shared<const project::scene>(std::move(proj.scene_names[_index]));
+    }
+    proj.tracks.clear();
+    proj.return_tracks.clear();
+    proj.project_master_track = project::master_track();
+    proj.project_prehear_track = project::pre_hear_track();
+    proj.scene_names.clear();
+    snapshot.settings = std::make_shared<const project>(std::move(proj));
+}
+
+void load_project_snapshot(const project_snapshot& snapshot, project& proj)
+{
+    proj = *snapshot.settings;
+    proj.tracks.resize(snapshot.tracks.size());
+    for (std::size_t _index = 0; _index < snapshot.tracks.size(); ++_index) {
+        snapshot_load_track(snapshot.tracks[_index], proj.tracks[_index]);
+    }
+    proj.return_tracks.resize(snapshot.return_tracks.size());
+    for (std::size_t _index = 0; _index < snapshot.return_tracks.size(); ++_index) {
+        snapshot_load_track(snapshot.return_tracks[_index], proj.return_tracks[_index]);
+    }
+    snapshot_load_track(snapshot.master_track, proj.project_master_track);
+    snapshot_load_track(snapshot.pre_hear_track, proj.project_prehear_track);
+    proj.scene_names.resize(snapshot.scenes.size());
+    for (std::size_t _index = 0; _index < snapshot.scenes.size(); ++_index) {
+        proj.scene_names[_index] = *snapshot.scenes[_index];
+    }
+    adopt_project_allocator(proj);
+}
+
+void export_project_snapshot(std::ostream& stream, const project_snapshot& snapshot, const version& ver)
+{
+    project _proj;
+    load_project_snapshot(snapshot, _proj);
+    export_project(stream, _proj, ver);
+}
+
+}
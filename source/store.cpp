@@ -0,0 +1,284 @@
+#include <fmtals/store.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <variant>
+
+#include <cereal/archives/portable_binary.hpp>
+
+#include "mapping.hpp"
+#include "serialize.hpp"
+
+// chunks
+
+struct store_track_entry {
+    std::uint64_t header;
+    std::uint64_t device_chain;
+};
+
+template <typename Archive>
+void serialize(Archive& archive, store_track_entry& entry)
+{
+    archive(entry.header, entry.device_chain);
+}
+
+struct store_manifest {
+    std::uint32_t format;
+    std::uint32_t ver;
+    std::uint64_t settings;
+    std::uint64_t scenes;
+    std::vector<store_track_entry> tracks;
+    std::vector<store_track_entry> return_tracks;
+    store_track_entry master_track;
+    store_track_entry pre_hear_track;
+};
+
+template <typename Archive>
+void serialize(Archive& archive, store_manifest& manifest)
+{
+    archive(manifest.format, manifest.ver, manifest.settings, manifest.scenes);
+    archive(manifest.tracks, manifest.return_tracks, manifest.master_track, manifest.pre_hear_track);
+}
+
+static constexpr std::uint32_t store_format = 3;
+
+static std::string store_hex(const std::uint64_t hash)
+{
+    char _buffer[17];
+    std::snprintf(_buffer, sizeof(_buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return std::string(_buffer, 16);
+}
+
+/// @brief Retrieves whether a name is a revision id as returned by store_project, 16 lower case
+/// hex digits, so that a revision never names a path outside of the revisions of the store
+static bool store_is_revision(const std::string& name)
+{
+    return name.size() == 16 && std::all_of(name.begin(), name.end(), [](const char _character) {
+        return (_character >= '0' && _character <= '9') || (_character >= 'a' && _character <= 'f');
+    });
+}
+
+static std::filesystem::path store_chunk_path(const std::filesystem::path& directory, const std::uint64_t hash)
+{
+    const std::string _hex = store_hex(hash);
+    return directory / "chunks" / _hex.substr(0, 2) / _hex;
+}
+
+/// @brief Writes a file named after the hash of its content unless it already exists. An existing
+/// file is read back and compared, a different content is a hash collision
+static void store_write_unique_file(const std::filesystem::path& path, const std::string& data)
+{
+    std::ifstream _existing(path, std::ios::binary);
+    if (!_existing) {
+        write_file_atomically(path, [&](std::ostream& stream) {
+            stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+        });
+        return;
+    }
+    std::string _buffer(std::min<std::size_t>(data.size() + 1, 65536), '\0');
+    std::size_t _offset = 0;
+    while (_existing) {
+        _existing.read(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+        const std::size_t _count = static_cast<std::size_t>(_existing.gcount());
+        if (_count > data.size() - _offset || data.compare(_offset, _count, _buffer, 0, _count) != 0) {
+            throw std::runtime_error("Hash collision in store for file: " + path.string());
+        }
+        _offset += _count;
+    }
+    if (_offset != data.size()) {
+        throw std::runtime_error("Hash collision in store for file: " + path.string());
+    }
+}
+
+template <typename Callback>
+static std::uint64_t store_write_chunk(const std::filesystem::path& directory, Callback&& callback)
+{
+    std::ostringstream _stream(std::ios::binary);
+    {
+        cereal::PortableBinaryOutputArchive _archive(_stream);
+        callback(_archive);
+    }
+    const std::string _data = _stream.str();
+    const std::uint64_t _hash = hash_bytes(_data.data(), _data.size());
+    store_write_unique_file(store_chunk_path(directory, _hash), _data);
+    return _hash;
+}
+
+template <typename Callback>
+static void store_read_chunk(const std::filesystem::path& directory, const std::uint64_t hash, Callback&& callback)
+{
+    const std::filesystem::path _path = store_chunk_path(directory, hash);
+    std::ifstream _stream(_path, std::ios::binary);
+    if (!_stream) {
+        throw std::runtime_error("Missing chunk in store: " + _path.string());
+    }
+    cereal::PortableBinaryInputArchive _archive(_stream);
+    callback(_archive);
+}
+
+// tracks
+
+template <typename Archive, typename T>
+static void store_serialize_track(Archive& archive, T& track)
+{
+    fmtals::serialize_track_names(archive, track);
+    fmtals::serialize_track_header(archive, track);
+    if constexpr (std::is_same_v<std::remove_const_t<T>, fmtals::project::audio_track>) {
+        archive(track.events_audio_clips);
+    }
+}
+
+template <std::size_t Index = 0>
+static void store_emplace_track(fmtals::project::user_track& track, const std::uint32_t index, const fmtals::project::allocator_type& allocator)
+{
+    if constexpr (Index < std::variant_size_v<fmtals::project::user_track>) {
+        if (index == Index) {
+            track.emplace<Index>(allocator);
+            return;
+        }
+        store_emplace_track<Index + 1>(track, index, allocator);
+    } else {
+        throw std::runtime_error("Invalid track type in store");
+    }
+}
+
+template <typename Chain, typename T>
+static Chain& store_get_device_chain(T& track)
+{
+    if constexpr (std::is_same_v<std::remove_const_t<T>, fmtals::project::user_track>) {
+        return std::visit([](auto& _track_visit) -> Chain& { return _track_visit; }, track);
+    } else {
+        return track;
+    }
+}
+
+template <typename T>
+static store_track_entry store_write_track(const std::filesystem::path& directory, const T& track)
+{
+    store_track_entry _entry;
+    _entry.header = store_write_chunk(directory, [&](auto& archive) {
+        if constexpr (std::is_same_v<T, fmtals::project::user_track>) {
+            archive(static_cast<std::uint32_t>(track.index()));
+            std::visit([&](const auto& _track_visit) { store_serialize_track(archive, _track_visit); }, track);
+        } else {
+            store_serialize_track(archive, track);
+        }
+    });
+    _entry.device_chain = store_write_chunk(directory, [&](auto& archive) {
+        archive(store_get_device_chain<const fmtals::project::device_chain>(track));
+    });
+    return _entry;
+}
+
+template <typename T>
+static void store_read_track(const std::filesystem::path& directory, const store_track_entry& entry, T& track, const fmtals::project::allocator_type& allocator)
+{
+    store_read_chunk(directory, entry.header, [&](auto& archive) {
+        if constexpr (std::is_same_v<T, fmtals::project::user_track>) {
+            std::uint32_t _index;
+            archive(_index);
+            store_emplace_track(track, _index, allocator);
+            std::visit([&](auto& _track_visit) { store_serialize_track(archive, _track_visit); }, track);
+        } else {
+            store_serialize_track(archive, track);
+        }
+    });
+    store_read_chunk(directory, entry.device_chain, [&](auto& archive) {
+        archive(store_get_device_chain<fmtals::project::device_chain>(track));
+    });
+}
+
+namespace fmtals {
+
+std::string store_project(const std::filesystem::path& directory, const project& proj, const version& ver)
+{
+    store_manifest _manifest;
+    _manifest.format = store_format;
+    _manifest.ver = static_cast<std::uint32_t>(ver);
+    _manifest.settings = store_write_chunk(directory, [&](auto& archive) { serialize_settings(archive, proj); });
+    _manifest.scenes = store_write_chunk(directory, [&](auto& archive) { archive(proj.scene_names); });
+    _manifest.tracks.reserve(proj.tracks.size());
+    for (const project::user_track& _track : proj.tracks) {
+        _manifest.tracks.emplace_back(store_write_track(directory, _track));
+    }
+    _manifest.return_tracks.reserve(proj.return_tracks.size());
+    for (const project::return_track& _track : proj.return_tracks) {
+        _manifest.return_tracks.emplace_back(store_write_track(directory, _track));
+    }
+    _manifest.master_track = store_write_track(directory, proj.project_master_track);
+    _manifest.pre_hear_track = store_write_track(directory, proj.project_prehear_track);
+
+    std::ostringstream _stream(std::ios::binary);
+    {
+        cereal::PortableBinaryOutputArchive _archive(_stream);
+        _archive(_manifest);
+    }
+    const std::string _data = _stream.str();
+    const std::string _revision = store_hex(hash_bytes(_data.data(), _data.size()));
+    store_write_unique_file(directory / "revisions" / _revision, _data);
+    return _revision;
+}
+
+void load_stored_project(const std::filesystem::path& directory, const std::string& revision, project& proj, version& ver)
+{
+    if (!store_is_revision(revision)) {
+        throw std::runtime_error("Invalid revision id: " + revision);
+    }
+    const std::filesystem::path _revision_path = directory / "revisions" / revision;
+    std::ifstream _stream(_revision_path, std::ios::binary);
+    if (!_stream) {
+        throw std::runtime_error("Missing revision in store: " + _revision_path.string());
+    }
+    store_manifest _manifest;
+    {
+        cereal::PortableBinaryInputArchive _archive(_stream);
+        _archive(_manifest);
+    }
+    if (_manifest.format != store_format) {
+        throw std::runtime_error("Unsupported store format: " + std::to_string(_manifest.format));
+    }
+    ver = static_cast<version>(_manifest.ver);
+    store_read_chunk(directory, _manifest.settings, [&](auto& archive) { serialize_settings(archive, proj); });
+    store_read_chunk(directory, _manifest.scenes, [&](auto& archive) { archive(proj.scene_names); });
+    proj.tracks.resize(_manifest.tracks.size());
+    for (std::size_t _index = 0; _index < _manifest.tracks.size(); ++_index) {
+        store_read_track(directory, _manifest.tracks[_index], proj.tracks[_index], proj.get_allocator());
+    }
+    proj.return_tracks.resize(_manifest.return_tracks.size());
+    for (std::size_t _index = 0; _index < _manifest.return_tracks.size(); ++_index) {
+        store_read_track(directory, _manifest.return_tracks[_index], proj.return_tracks[_index], proj.get_allocator());
+    }
+    store_read_track(directory, _manifest.master_track, proj.project_master_track, proj.get_allocator());
+    store_read_track(directory, _manifest.pre_hear_track, proj.project_prehear_track, proj.get_allocator());
+    adopt_project_allocator(proj);
+}
+
+void export_stored_project(std::ostream& stream, const std::filesystem::path& directory, const std::string& revision, const version& ver)
+{
+    project _proj;
+    version _stored_ver;
+    load_stored_project(directory, revision, _proj, _stored_ver);
+    export_project(stream, _proj, ver);
+}
+
+std::vector<std::string> list_stored_projects(const std::filesystem::path& directory)
+{
+    std::vector<std::string> _revisions;
+    const std::filesystem::path _revisions_path = directory / "revisions";
+    if (!std::filesystem::exists(_revisions_path)) {
+        return _revisions;
+    }
+    for (const std::filesystem::directory_entry& _entry : std::filesystem::directory_iterator(_revisions_path)) {
+        const std::string _name = _entry.path().filename().string();
+        if (_entry.is_regular_file() && store_is_revision(_name)) {
+            _revisions.emplace_back(_name);
+        }
+    }
+    std::sort(_revisions.begin(), _revisions.end());
+    return _revisions;
+}
+
+}
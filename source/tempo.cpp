@@ -0,0 +1,174 @@
+#include <fmtals/tempo.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+// Between two points of the tempo envelope the tempo is linear in beats, t(b) = t0 + k (b - b0).
+// The seconds elapsed over a segment are the integral of 60 / t(b), which gives
+// 60 / k ln(t(b) / t0), and its inverse b - b0 = t0 / k (exp(k s / 60) - 1). Segments where k is
+// zero fall back to the constant tempo formulas.
+
+static double tempo_check(const double tempo)
+{
+    if (!(tempo > 0)) {
+        throw std::runtime_error("Invalid tempo: " + std::to_string(tempo));
+    }
+    return tempo;
+}
+
+static double tempo_segment_seconds(const fmtals::tempo_segment& segment, const double beats)
+{
+    if (segment.slope == 0) {
+        return 60 * beats / segment.tempo;
+    }
+    return 60 / segment.slope * std::log1p(segment.slope * beats / segment.tempo);
+}
+
+static double tempo_segment_beats(const fmtals::tempo_segment& segment, const double seconds)
+{
+    if (segment.slope == 0) {
+        return seconds * segment.tempo / 60;
+    }
+    return segment.tempo / segment.slope * std::expm1(segment.slope * seconds / 60);
+}
+
+/// @brief Finds the segment containing a position, starting from a hint so that increasing
+/// positions are found without searching the whole map. Positions before the first segment use
+/// the first one
+template <typename Key>
+static std::size_t tempo_find(const fmtals::tempo_map& map, const double position, std::size_t hint, const Key& key)
+{
+    const auto _less = [&](const double value, const fmtals::tempo_segment& segment) {
+        return value < key(segment);
+    };
+    const auto _begin = map.segments.begin();
+    const auto _end = map.segments.end();
+    hint = std::min(hint, map.segments.size() - 1);
+    std::vector<fmtals::tempo_segment>::const_iterator _found;
+    if (position >= key(map.segments[hint])) {
+        if (hint + 1 == map.segments.size() || position < key(map.segments[hint + 1])) {
+            return hint;
+        }
+        _found = std::upper_bound(_begin + static_cast<std::ptrdiff_t>(hint) + 1, _end, position, _less);
+    } else {
+        _found = std::upper_bound(_begin, _begin + static_cast<std::ptrdiff_t>(hint), position, _less);
+    }
+    return _found == _begin ? 0 : static_cast<std::size_t>(_found - _begin) - 1;
+}
+
+static double tempo_to_seconds(const fmtals::tempo_map& map, const double beat, std::size_t& hint)
+{
+    if (map.segments.empty()) {
+        throw std::runtime_error("Empty tempo map");
+    }
+    hint = tempo_find(map, beat, hint, [](const fmtals::tempo_segment& segment) { return segment.beat; });
+    const fmtals::tempo_segment& _segment = map.segments[hint];
+    if (beat < _segment.beat) {
+        return _segment.second + 60 * (beat - _segment.beat) / _segment.tempo;
+    }
+    return _segment.second + tempo_segment_seconds(_segment, beat - _segment.beat);
+}
+
+static double tempo_to_beats(const fmtals::tempo_map& map, const double second, std::size_t& hint)
+{
+    if (map.segments.empty()) {
+        throw std::runtime_error("Empty tempo map");
+    }
+    hint = tempo_find(map, second, hint, [](const fmtals::tempo_segment& segment) { return segment.second; });
+    const fmtals::tempo_segment& _segment = map.segments[hint];
+    if (second < _segment.second) {
+        return _segment.beat + (second - _segment.second) * _segment.tempo / 60;
+    }
+    return _segment.beat + tempo_segment_beats(_segment, second - _segment.second);
+}
+
+namespace fmtals {
+
+void build_tempo_map(const project& proj, tempo_map& map)
+{
+    const project::master_track& _master_track = proj.project_master_track;
+    map.segments.clear();
+    const project::automation_envelope* _envelope = nullptr;
+    if (_master_track.tempo_automation_target_id) {
+        for (const project::automation_envelope& _candidate : _master_track.automation_envelopes) {
+            if (_candidate.pointee_id == _master_track.tempo_automation_target_id && !_candidate.events.empty()) {
+                _envelope = &_candidate;
+                break;
+            }
+        }
+    }
+    if (!_envelope) {
+        map.segments.push_back({ 0, 0, tempo_check(_master_track.tempo), 0 });
+        return;
+    }
+
+    // events of equal time are kept in order, they make a step in the tempo
+    std::vector<project::automation_event> _events(_envelope->events.begin(), _envelope->events.end());
+    std::stable_sort(_events.begin(), _events.end(), [](const project::automation_event& lhs, const project::automation_event& rhs) {
+        return lhs.time < rhs.time;
+    });
+    map.segments.reserve(_events.size() + 1);
+    for (std::size_t _index = 0; _index < _events.size(); ++_index) {
+        tempo_segment _segment;
+        _segment.beat = _events[_index].time;
+        _segment.tempo = tempo_check(_events[_index].value);
+        if (_index + 1 < _events.size() && _events[_index + 1].time > _segment.beat) {
+            _segment.slope = (tempo_check(_events[_index + 1].value) - _segment.tempo) / (_events[_index + 1].time - _segment.beat);
+        }
+        map.segments.push_back(_segment);
+    }
+
+    // seconds are counted from beat 0 and accumulated outwards from it. The first event of Live
+    // envelopes lies so far before beat 0 that converting positions from there would lose
+    // precision, so the segment containing beat 0 is split there
+    std::size_t _origin = tempo_find(map, 0, 0, [](const tempo_segment& segment) { return segment.beat; });
+    if (map.segments[_origin].beat < 0) {
+        tempo_segment _split = map.segments[_origin];
+        _split.tempo = tempo_check(_split.tempo - _split.slope * _split.beat);
+        _split.beat = 0;
+        map.segments.insert(map.segments.begin() + static_cast<std::ptrdiff_t>(++_origin), _split);
+    }
+    map.segments[_origin].second = 60 * map.segments[_origin].beat / map.segments[_origin].tempo;
+    for (std::size_t _index = _origin + 1; _index < map.segments.size(); ++_index) {
+        const tempo_segment& _previous = map.segments[_index - 1];
+        map.segments[_index].second = _previous.second + tempo_segment_seconds(_previous, map.segments[_index].beat - _previous.beat);
+    }
+    for (std::size_t _index = _origin; _index > 0; --_index) {
+        tempo_segment& _segment = map.segments[_index - 1];
+        _segment.second = map.segments[_index].second - tempo_segment_seconds(_segment, map.segments[_index].beat - _segment.beat);
+    }
+}
+
+double beats_to_seconds(const tempo_map& map, const double beat)
+{
+    std::size_t _hint = map.segments.size() / 2;
+    return tempo_to_seconds(map, beat, _hint);
+}
+
+double seconds_to_beats(const tempo_map& map, const double second)
+{
+    std::size_t _hint = map.segments.size() / 2;
+    return tempo_to_beats(map, second, _hint);
+}
+
+void beats_to_seconds(const tempo_map& map, const std::vector<double>& beats, std::vector<double>& seconds)
+{
+    seconds.resize(beats.size());
+    std::size_t _hint = 0;
+    for (std::size_t _index = 0; _index < beats.size(); ++_index) {
+        seconds[_index] = tempo_to_seconds(map, beats[_index], _hint);
+    }
+}
+
+void seconds_to_beats(const tempo_map& map, const std::vector<double>& seconds, std::vector<double>& beats)
+{
+    beats.resize(seconds.size());
+    std::size_t _hint = 0;
+    for (std::size_t _index = 0; _index < seconds.size(); ++_index) {
+        beats[_index] = tempo_to_beats(map, seconds[_index], _hint);
+    }
+}
+
+}
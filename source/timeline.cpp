@@ -0,0 +1,176 @@
+#include <fmtals/timeline.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <variant>
+
+// The sorted clips are read as a complete binary tree in the manner of cgranges. A clip at
+// position i lies at the level of the number of trailing one bits of i, the children of a clip
+// of level k are at i - 2^(k-1) and i + 2^(k-1) and the root is at 2^max_level - 1. Positions past
+// the last clip are missing nodes, their subtree end is taken from the rightmost existing subtree.
+
+static void timeline_interval(const fmtals::project::audio_clip& audio_clip, fmtals::timeline_clip& clip)
+{
+    clip.start = static_cast<double>(audio_clip.time);
+    clip.end = clip.start + std::max(0.0, static_cast<double>(audio_clip.current_end) - static_cast<double>(audio_clip.current_start));
+}
+
+/// @brief Recomputes the subtree ends of the clips whose subtree contains a position in
+/// [first, last), from the leaves to the root
+static void timeline_augment(fmtals::timeline_index& index, const std::size_t first, const std::size_t last)
+{
+    const std::size_t _count = index.clips.size();
+    index.max_ends.resize(_count);
+    index.max_level = 0;
+    if (!_count) {
+        return;
+    }
+    for (std::size_t _index = first + (first & 1); _index < last; _index += 2) {
+        index.max_ends[_index] = index.clips[_index].end;
+    }
+    std::size_t _last_index = (_count - 1) & ~std::size_t(1);
+    double _last_end = index.max_ends[_last_index];
+    std::size_t _level = 1;
+    for (; (std::size_t(1) << _level) <= _count; ++_level) {
+        const std::size_t _half = std::size_t(1) << (_level - 1);
+        const std::size_t _width = 2 * _half - 1;
+        const std::size_t _step = 4 * _half;
+        std::size_t _index = _width;
+        if (first > 2 * _width) {
+            _index += (first - 2 * _width + _step - 1) / _step * _step;
+        }
+        for (; _index < _count && _index < last + _width; _index += _step) {
+            const double _left_end = index.max_ends[_index - _half];
+            const double _right_end = _index + _half < _count ? index.max_ends[_index + _half] : _last_end;
+            index.max_ends[_index] = std::max({ index.clips[_index].end, _left_end, _right_end });
+        }
+        _last_index = (_last_index >> _level & 1) ? _last_index - _half : _last_index + _half;
+        if (_last_index < _count && index.max_ends[_last_index] > _last_end) {
+            _last_end = index.max_ends[_last_index];
+        }
+    }
+    index.max_level = _level - 1;
+}
+
+namespace fmtals {
+
+void index_timeline(const project& proj, timeline_index& index)
+{
+    index.clips.clear();
+    index.track_offsets.clear();
+    index.track_offsets.reserve(proj.tracks.size() + 1);
+    for (std::size_t _track_index = 0; _track_index < proj.tracks.size(); ++_track_index) {
+        index.track_offsets.push_back(index.clips.size());
+        if (const project::audio_track* _audio_track = std::get_if<project::audio_track>(&proj.tracks[_track_index])) {
+            for (std::size_t _clip_index = 0; _clip_index < _audio_track->events_audio_clips.size(); ++_clip_index) {
+                timeline_clip _clip;
+                timeline_interval(_audio_track->events_audio_clips[_clip_index], _clip);
+                _clip.track_index = _track_index;
+                _clip.clip_index = _clip_index;
+                index.clips.push_back(_clip);
+            }
+        }
+    }
+    index.track_offsets.push_back(index.clips.size());
+
+    std::stable_sort(index.clips.begin(), index.clips.end(), [](const timeline_clip& lhs, const timeline_clip& rhs) {
+        return lhs.start < rhs.start;
+    });
+    index.positions.resize(index.clips.size());
+    for (std::size_t _position = 0; _position < index.clips.size(); ++_position) {
+        const timeline_clip& _clip = index.clips[_position];
+        index.positions[index.track_offsets[_clip.track_index] + _clip.clip_index] = _position;
+    }
+    timeline_augment(index, 0, index.clips.size());
+}
+
+void move_timeline_clip(timeline_index& index, const project& proj, const std::size_t track_index, const std::size_t clip_index)
+{
+    if (track_index + 1 >= index.track_offsets.size() || clip_index >= index.track_offsets[track_index + 1] - index.track_offsets[track_index]) {
+        throw std::runtime_error("Clip not indexed in timeline");
+    }
+    const project::audio_track* _audio_track = track_index < proj.tracks.size() ? std::get_if<project::audio_track>(&proj.tracks[track_index]) : nullptr;
+    if (!_audio_track || clip_index >= _audio_track->events_audio_clips.size()) {
+        throw std::runtime_error("Clip not found in project");
+    }
+    const std::size_t _position = index.positions[index.track_offsets[track_index] + clip_index];
+    timeline_clip _moved = index.clips[_position];
+    timeline_interval(_audio_track->events_audio_clips[clip_index], _moved);
+
+    // the clips between the previous and the new position shift by one to make room
+    const auto _less = [](const double start, const timeline_clip& clip) {
+        return start < clip.start;
+    };
+    const auto _begin = index.clips.begin();
+    std::size_t _first;
+    std::size_t _last;
+    if (_position + 1 < index.clips.size() && index.clips[_position + 1].start <= _moved.start) {
+        const std::size_t _new_position = static_cast<std::size_t>(std::upper_bound(_begin + static_cast<std::ptrdiff_t>(_position) + 1, index.clips.end(), _moved.start, _less) - _begin) - 1;
+        std::rotate(_begin + static_cast<std::ptrdiff_t>(_position), _begin + static_cast<std::ptrdiff_t>(_position) + 1, _begin + static_cast<std::ptrdiff_t>(_new_position) + 1);
+        index.clips[_new_position] = _moved;
+        _first = _position;
+        _last = _new_position + 1;
+    } else {
+        const std::size_t _new_position = static_cast<std::size_t>(std::upper_bound(_begin, _begin + static_cast<std::ptrdiff_t>(_position), _moved.start, _less) - _begin);
+        std::rotate(_begin + static_cast<std::ptrdiff_t>(_new_position), _begin + static_cast<std::ptrdiff_t>(_position), _begin + static_cast<std::ptrdiff_t>(_position) + 1);
+        index.clips[_new_position] = _moved;
+        _first = _new_position;
+        _last = _position + 1;
+    }
+    for (std::size_t _shifted = _first; _shifted < _last; ++_shifted) {
+        const timeline_clip& _clip = index.clips[_shifted];
+        index.positions[index.track_offsets[_clip.track_index] + _clip.clip_index] = _shifted;
+    }
+    timeline_augment(index, _first, _last);
+}
+
+void find_timeline_clips(const timeline_index& index, const double time, std::vector<timeline_clip>& clips)
+{
+    find_timeline_clips(index, time, std::nextafter(time, std::numeric_limits<double>::infinity()), clips);
+}
+
+void find_timeline_clips(const timeline_index& index, const double start, const double end, std::vector<timeline_clip>& clips)
+{
+    struct timeline_frame {
+        std::size_t position;
+        std::size_t level;
+        bool left_done;
+    };
+    clips.clear();
+    const std::size_t _count = index.clips.size();
+    if (!_count) {
+        return;
+    }
+    std::array<timeline_frame, 2 * std::numeric_limits<std::size_t>::digits> _stack;
+    std::size_t _size = 0;
+    _stack[_size++] = { (std::size_t(1) << index.max_level) - 1, index.max_level, false };
+    while (_size) {
+        const timeline_frame _frame = _stack[--_size];
+        if (_frame.level <= 3) {
+            // small subtrees are scanned in order
+            const std::size_t _first = _frame.position >> _frame.level << _frame.level;
+            const std::size_t _last = std::min(_count, _first + (std::size_t(2) << _frame.level) - 1);
+            for (std::size_t _position = _first; _position < _last && index.clips[_position].start < end; ++_position) {
+                if (start < index.clips[_position].end) {
+                    clips.push_back(index.clips[_position]);
+                }
+            }
+        } else if (!_frame.left_done) {
+            const std::size_t _left = _frame.position - (std::size_t(1) << (_frame.level - 1));
+            _stack[_size++] = { _frame.position, _frame.level, true };
+            if (_left >= _count || index.max_ends[_left] > start) {
+                _stack[_size++] = { _left, _frame.level - 1, false };
+            }
+        } else if (_frame.position < _count && index.clips[_frame.position].start < end) {
+            if (start < index.clips[_frame.position].end) {
+                clips.push_back(index.clips[_frame.position]);
+            }
+            _stack[_size++] = { _frame.position + (std::size_t(1) << (_frame.level - 1)), _frame.level - 1, false };
+        }
+    }
+}
+
+}
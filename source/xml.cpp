@@ -0,0 +1,562 @@
+#include "xml.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "simd.hpp"
+
+// The parser works on [text, end) and finds markup with SIMD compares of 16 or 32 bytes at a time.
+// Names, values and indentation of Live sets are mostly shorter than a block, so every scan first
+// tests one block worth of characters through a lookup table like rapidxml does and only switches
+// to block compares for long runs such as plugin buffers. Names and values are written back into
+// the text: entities shrink in place and a zero terminator follows every string once the
+// character it replaces has been consumed, like rapidxml does.
+
+[[noreturn]] static void xml_parse_error(const char* what)
+{
+    throw std::runtime_error(std::string("Invalid XML: ") + what);
+}
+
+/// @brief Represents a set of characters as a lookup table
+template <char... Chars>
+struct xml_class {
+    static constexpr struct table {
+        bool members[256] = {};
+        constexpr table()
+        {
+            ((members[static_cast<unsigned char>(Chars)] = true), ...);
+        }
+    } lookup {};
+
+    static bool contains(const char character)
+    {
+        return lookup.members[static_cast<unsigned char>(character)];
+    }
+};
+
+/// @brief Finds the first character of [text, end) that is one of Chars, or end
+template <char... Chars, typename Char>
+static Char* xml_find(Char* text, Char* const end)
+{
+    for (Char* const _scalar_end = text + std::min<std::size_t>(simd_width, static_cast<std::size_t>(end - text)); text != _scalar_end; ++text) {
+        if (xml_class<Chars...>::contains(*text)) {
+            return text;
+        }
+    }
+    return simd_find<Chars...>(text, end);
+}
+
+/// @brief Finds the first character of [text, end) that is none of Chars, or end
+template <char... Chars>
+static char* xml_skip(char* text, char* const end)
+{
+    for (char* const _scalar_end = text + std::min<std::size_t>(simd_width, static_cast<std::size_t>(end - text)); text != _scalar_end; ++text) {
+        if (!xml_class<Chars...>::contains(*text)) {
+            return text;
+        }
+    }
+    return simd_skip<Chars...>(text, end);
+}
+
+static char* xml_next_boundary(char* const end, char* text)
+{
+    return xml_find<'<', '>', '"', '\'', '=', '/', '&', ' ', '\t', '\n', '\r'>(text, end);
+}
+
+static char* xml_skip_whitespace(char* const end, char* text)
+{
+    return xml_skip<' ', '\t', '\n', '\r'>(text, end);
+}
+
+/// @brief Finds the end of a construct such as "-->" or "?>" and moves past it
+static char* xml_skip_past(char* text, char* end, const char* terminator)
+{
+    const std::size_t _size = std::strlen(terminator);
+    for (text = static_cast<char*>(std::memchr(text, terminator[0], static_cast<std::size_t>(end - text))); text; text = static_cast<char*>(std::memchr(text + 1, terminator[0], static_cast<std::size_t>(end - text - 1)))) {
+        if (static_cast<std::size_t>(end - text) >= _size && std::memcmp(text, terminator, _size) == 0) {
+            return text + _size;
+        }
+    }
+    xml_parse_error("unexpected end of data");
+}
+
+/// @brief Writes a code point as UTF-8
+static char* xml_write_code_point(char* output, const unsigned long code)
+{
+    if (code < 0x80) {
+        *output++ = static_cast<char>(code);
+    } else if (code < 0x800) {
+        *output++ = static_cast<char>(0xc0 | (code >> 6));
+        *output++ = static_cast<char>(0x80 | (code & 0x3f));
+    } else if (code < 0x10000) {
+        *output++ = static_cast<char>(0xe0 | (code >> 12));
+        *output++ = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        *output++ = static_cast<char>(0x80 | (code & 0x3f));
+    } else if (code < 0x110000) {
+        *output++ = static_cast<char>(0xf0 | (code >> 18));
+        *output++ = static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+        *output++ = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        *output++ = static_cast<char>(0x80 | (code & 0x3f));
+    } else {
+        xml_parse_error("invalid numeric character entity");
+    }
+    return output;
+}
+
+/// @brief Decodes the entity starting at text into output. Unknown entities are copied verbatim
+static void xml_decode_entity(char*& text, char* end, char*& output)
+{
+    const std::size_t _available = static_cast<std::size_t>(end - text);
+    const auto _matches = [&](const char* entity) {
+        const std::size_t _size = std::strlen(entity);
+        return _available >= _size && std::memcmp(text, entity, _size) == 0 ? _size : 0;
+    };
+    static constexpr struct {
+        const char* entity;
+        char character;
+    } _entities[] = { { "&amp;", '&' }, { "&apos;", '\'' }, { "&quot;", '"' }, { "&lt;", '<' }, { "&gt;", '>' } };
+    for (const auto& _entity : _entities) {
+        if (const std::size_t _size = _matches(_entity.entity)) {
+            *output++ = _entity.character;
+            text += _size;
+            return;
+        }
+    }
+    if (_available >= 2 && text[1] == '#') {
+        const bool _hexadecimal = _available >= 3 && text[2] == 'x';
+        char* _digit = text + (_hexadecimal ? 3 : 2);
+        unsigned long _code = 0;
+        for (; _digit != end; ++_digit) {
+            const char _character = *_digit;
+            unsigned _value;
+            if (_character >= '0' && _character <= '9') {
+                _value = static_cast<unsigned>(_character - '0');
+            } else if (_hexadecimal && _character >= 'a' && _character <= 'f') {
+                _value = static_cast<unsigned>(_character - 'a' + 10);
+            } else if (_hexadecimal && _character >= 'A' && _character <= 'F') {
+                _value = static_cast<unsigned>(_character - 'A' + 10);
+            } else {
+                break;
+            }
+            _code = _code * (_hexadecimal ? 16 : 10) + _value;
+            if (_code >= 0x110000) {
+                xml_parse_error("invalid numeric character entity");
+            }
+        }
+        if (_digit == end || *_digit != ';') {
+            xml_parse_error("expected ;");
+        }
+        output = xml_write_code_point(output, _code);
+        text = _digit + 1;
+        return;
+    }
+    *output++ = *text++;
+}
+
+/// @brief Decodes text up to the first Stop character in place. Runs without entities are moved
+/// in bulk. Returns the end of the decoded string, text is left on the Stop character
+template <char Stop>
+static char* xml_decode(char* const end, char*& text)
+{
+    text = xml_find<Stop, '&'>(text, end);
+    if (text != end && *text == Stop) {
+        return text;
+    }
+    char* _output = text;
+    while (text != end && *text == '&') {
+        xml_decode_entity(text, end, _output);
+        char* const _next = xml_find<Stop, '&'>(text, end);
+        std::memmove(_output, text, static_cast<std::size_t>(_next - text));
+        _output += _next - text;
+        text = _next;
+    }
+    if (text == end) {
+        xml_parse_error("unexpected end of data");
+    }
+    return _output;
+}
+
+static xml_node* xml_parse_node(xml_document& document, char* const end, char*& text);
+
+/// @brief Parses text content up to the next tag. text is left on the '<', which may have been
+/// overwritten by the zero terminator
+static void xml_parse_data(xml_document& document, char* const end, xml_node* node, char* contents_start, char*& text)
+{
+    text = contents_start;
+    char* const _value_end = xml_decode<'<'>(end, text);
+    xml_node* _data_node = document.allocate_node(cereal::rapidxml::node_data);
+    _data_node->value(contents_start, static_cast<std::size_t>(_value_end - contents_start));
+    node->append_node(_data_node);
+    if (*node->value() == '\0') {
+        node->value(contents_start, static_cast<std::size_t>(_value_end - contents_start));
+    }
+    *_value_end = '\0';
+}
+
+static void xml_parse_contents(xml_document& document, char* const end, xml_node* node, char*& text)
+{
+    while (true) {
+        char* const _contents_start = text;
+        text = xml_skip_whitespace(end, text);
+        if (text == end) {
+            xml_parse_error("unexpected end of data");
+        }
+        if (*text != '<') {
+            xml_parse_data(document, end, node, _contents_start, text);
+        }
+        if (end - text >= 2 && text[1] == '/') {
+            text = xml_skip_whitespace(end, xml_next_boundary(end, text + 2));
+            if (text == end || *text != '>') {
+                xml_parse_error("expected >");
+            }
+            ++text;
+            return;
+        }
+        ++text;
+        if (xml_node* _child = xml_parse_node(document, end, text)) {
+            node->append_node(_child);
+        }
+    }
+}
+
+template <char Quote>
+static xml_attribute* xml_parse_attribute_value(xml_document& document, char* const end, char* name, std::size_t name_size, char*& text)
+{
+    char* const _value = text;
+    char* const _value_end = xml_decode<Quote>(end, text);
+    ++text;
+    // sizes are set explicitly, rapidxml measures zero sized strings that are not terminated yet
+    xml_attribute* _attribute = document.allocate_attribute();
+    _attribute->name(name, name_size);
+    _attribute->value(_value, static_cast<std::size_t>(_value_end - _value));
+    *_value_end = '\0';
+    return _attribute;
+}
+
+static xml_node* xml_parse_element(xml_document& document, char* const end, char*& text)
+{
+    char* const _name = text;
+    text = xml_next_boundary(end, text);
+    if (text == _name || (text != end && *text != '/' && *text != '>' && !simd_is_any<' ', '\t', '\n', '\r'>(*text))) {
+        xml_parse_error("expected element name");
+    }
+    xml_node* _element = document.allocate_node(cereal::rapidxml::node_element);
+    _element->name(_name, static_cast<std::size_t>(text - _name));
+    while (true) {
+        text = xml_skip_whitespace(end, text);
+        if (text == end) {
+            xml_parse_error("unexpected end of data");
+        }
+        if (*text == '/') {
+            if (end - text < 2 || text[1] != '>') {
+                xml_parse_error("expected >");
+            }
+            text += 2;
+            break;
+        }
+        if (*text == '>') {
+            ++text;
+            xml_parse_contents(document, end, _element, text);
+            break;
+        }
+        char* const _attribute_name = text;
+        text = xml_next_boundary(end, text);
+        char* const _attribute_name_end = text;
+        if (_attribute_name_end == _attribute_name) {
+            xml_parse_error("expected attribute name");
+        }
+        text = xml_skip_whitespace(end, text);
+        if (text == end || *text != '=') {
+            xml_parse_error("expected =");
+        }
+        text = xml_skip_whitespace(end, text + 1);
+        if (text == end || (*text != '"' && *text != '\'')) {
+            xml_parse_error("expected ' or \"");
+        }
+        const std::size_t _attribute_name_size = static_cast<std::size_t>(_attribute_name_end - _attribute_name);
+        xml_attribute* _attribute = *text++ == '"'
+            ? xml_parse_attribute_value<'"'>(document, end, _attribute_name, _attribute_name_size, text)
+            : xml_parse_attribute_value<'\''>(document, end, _attribute_name, _attribute_name_size, text);
+        *_attribute_name_end = '\0';
+        _element->append_attribute(_attribute);
+    }
+    _name[_element->name_size()] = '\0';
+    return _element;
+}
+
+/// @brief Parses the node following a '<'. Returns nullptr for the constructs that rapidxml skips
+/// without flags: declarations, processing instructions, comments and doctypes
+static xml_node* xml_parse_node(xml_document& document, char* const end, char*& text)
+{
+    const std::size_t _available = static_cast<std::size_t>(end - text);
+    if (_available >= 1 && text[0] == '?') {
+        text = xml_skip_past(text + 1, end, "?>");
+        return nullptr;
+    }
+    if (_available >= 1 && text[0] == '!') {
+        if (_available >= 3 && text[1] == '-' && text[2] == '-') {
+            text = xml_skip_past(text + 3, end, "-->");
+            return nullptr;
+        }
+        if (_available >= 8 && std::memcmp(text, "![CDATA[", 8) == 0) {
+            char* const _value = text + 8;
+            text = xml_skip_past(_value, end, "]]>");
+            xml_node* _cdata_node = document.allocate_node(cereal::rapidxml::node_cdata);
+            _cdata_node->value(_value, static_cast<std::size_t>(text - 3 - _value));
+            text[-3] = '\0';
+            return _cdata_node;
+        }
+        // doctype and other declarations, brackets of an internal subset are balanced
+        std::size_t _depth = 0;
+        for (++text; text != end; ++text) {
+            if (*text == '[') {
+                ++_depth;
+            } else if (*text == ']' && _depth) {
+                --_depth;
+            } else if (*text == '>' && !_depth) {
+                ++text;
+                return nullptr;
+            }
+        }
+        xml_parse_error("unexpected end of data");
+    }
+    return xml_parse_element(document, end, text);
+}
+
+void xml_parse(xml_document& document, char* text, const std::size_t size)
+{
+    document.remove_all_nodes();
+    document.remove_all_attributes();
+    xml_parse_children(document, &document, text, size);
+}
+
+void xml_parse_children(xml_document& document, xml_node* node, char* text, const std::size_t size)
+{
+    char* const _end = text + size;
+    if (size >= 3 && static_cast<unsigned char>(text[0]) == 0xef && static_cast<unsigned char>(text[1]) == 0xbb && static_cast<unsigned char>(text[2]) == 0xbf) {
+        text += 3;
+    }
+    while (true) {
+        text = xml_skip_whitespace(_end, text);
+        if (text == _end) {
+            break;
+        }
+        if (*text != '<') {
+            xml_parse_error("expected <");
+        }
+        ++text;
+        if (xml_node* _node = xml_parse_node(document, _end, text)) {
+            node->append_node(_node);
+        }
+    }
+}
+
+/// @brief Represents the output of the printer. Text is written at a cursor into a string that
+/// grows geometrically, the string is trimmed to the printed size once printing is done
+struct xml_printer {
+    std::pmr::string& output;
+    std::size_t size;
+
+    xml_printer(std::pmr::string& text)
+        : output(text)
+        , size(text.size())
+    {
+    }
+
+    xml_printer(const xml_printer&) = delete;
+    xml_printer& operator=(const xml_printer&) = delete;
+
+    ~xml_printer()
+    {
+        output.resize(size);
+    }
+
+    char* reserve(const std::size_t count)
+    {
+        if (size + count > output.size()) {
+            output.resize(std::max(output.size() * 2, size + count + 4096));
+        }
+        return output.data() + size;
+    }
+
+    void write(const char* data, const std::size_t count)
+    {
+        std::memcpy(reserve(count), data, count);
+        size += count;
+    }
+
+    void write(const std::string_view text)
+    {
+        write(text.data(), text.size());
+    }
+
+    void fill(const char character, const std::size_t count)
+    {
+        std::memset(reserve(count), character, count);
+        size += count;
+    }
+};
+
+/// @brief Prints a value with its markup characters escaped. Runs without markup characters are
+/// found with SIMD scans and copied in bulk
+static void xml_print_escaped(xml_printer& printer, const char* text, const std::size_t size)
+{
+    const char* const _end = text + size;
+    while (true) {
+        const char* const _next = xml_find<'<', '>', '&', '"', '\''>(text, _end);
+        printer.write(text, static_cast<std::size_t>(_next - text));
+        if (_next == _end) {
+            return;
+        }
+        switch (*_next) {
+        case '<':
+            printer.write("&lt;");
+            break;
+        case '>':
+            printer.write("&gt;");
+            break;
+        case '&':
+            printer.write("&amp;");
+            break;
+        case '"':
+            printer.write("&quot;");
+            break;
+        default:
+            printer.write("&apos;");
+            break;
+        }
+        text = _next + 1;
+    }
+}
+
+static void xml_print_attributes(xml_printer& printer, const xml_node* node)
+{
+    for (const xml_attribute* _attribute = node->first_attribute(); _attribute; _attribute = _attribute->next_attribute()) {
+        char* _output = printer.reserve(_attribute->name_size() + 3);
+        *_output++ = ' ';
+        std::memcpy(_output, _attribute->name(), _attribute->name_size());
+        _output += _attribute->name_size();
+        *_output++ = '=';
+        *_output++ = '"';
+        printer.size += _attribute->name_size() + 3;
+        xml_print_escaped(printer, _attribute->value(), _attribute->value_size());
+        printer.write("\"");
+    }
+}
+
+static void xml_print_node(xml_printer& printer, const xml_node* node, const std::size_t indent)
+{
+    switch (node->type()) {
+    case cereal::rapidxml::node_document:
+        for (const xml_node* _child = node->first_node(); _child; _child = _child->next_sibling()) {
+            xml_print_node(printer, _child, indent);
+        }
+        return;
+    case cereal::rapidxml::node_element: {
+        printer.fill('\t', indent);
+        printer.write("<");
+        printer.write(node->name(), node->name_size());
+        xml_print_attributes(printer, node);
+        const xml_node* _child = node->first_node();
+        if (!_child && !node->value_size()) {
+            printer.write(" />\n");
+            return;
+        }
+        printer.write(">");
+        if (!_child) {
+            xml_print_escaped(printer, node->value(), node->value_size());
+        } else if (!_child->next_sibling() && _child->type() == cereal::rapidxml::node_data) {
+            xml_print_escaped(printer, _child->value(), _child->value_size());
+        } else {
+            printer.write("\n");
+            for (; _child; _child = _child->next_sibling()) {
+                xml_print_node(printer, _child, indent + 1);
+            }
+            printer.fill('\t', indent);
+        }
+        printer.write("</");
+        printer.write(node->name(), node->name_size());
+        printer.write(">\n");
+        return;
+    }
+    case cereal::rapidxml::node_data:
+        printer.fill('\t', indent);
+        xml_print_escaped(printer, node->value(), node->value_size());
+        break;
+    case cereal::rapidxml::node_cdata:
+        printer.fill('\t', indent);
+        printer.write("<![CDATA[");
+        printer.write(node->value(), node->value_size());
+        printer.write("]]>");
+        break;
+    case cereal::rapidxml::node_declaration:
+        printer.fill('\t', indent);
+        printer.write("<?xml");
+        xml_print_attributes(printer, node);
+        printer.write("?>");
+        break;
+    case cereal::rapidxml::node_comment:
+        printer.fill('\t', indent);
+        printer.write("<!--");
+        printer.write(node->value(), node->value_size());
+        printer.write("-->");
+        break;
+    default:
+        throw std::runtime_error("Unsupported XML node type");
+    }
+    printer.write("\n");
+}
+
+void xml_print(std::pmr::string& text, const xml_node* node, const std::size_t indent)
+{
+    xml_printer _printer(text);
+    xml_print_node(_printer, node, indent);
+}
+
+// rapidxml pools call plain functions without context, the resource is taken from the calling
+// thread and stored in front of each block so that it is released where it was allocated.
+
+static thread_local std::pmr::memory_resource* xml_resource = nullptr;
+
+struct xml_block {
+    std::pmr::memory_resource* resource;
+    std::size_t size;
+};
+
+static constexpr std::size_t xml_block_offset = (sizeof(xml_block) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+static void* xml_allocate_block(const std::size_t size)
+{
+    std::pmr::memory_resource* _resource = xml_resource ? xml_resource : std::pmr::get_default_resource();
+    void* _block = _resource->allocate(xml_block_offset + size, alignof(std::max_align_t));
+    new (_block) xml_block { _resource, size };
+    return static_cast<char*>(_block) + xml_block_offset;
+}
+
+static void xml_free_block(void* pointer)
+{
+    xml_block* _block = reinterpret_cast<xml_block*>(static_cast<char*>(pointer) - xml_block_offset);
+    _block->resource->deallocate(_block, xml_block_offset + _block->size, alignof(std::max_align_t));
+}
+
+xml_resource_scope::xml_resource_scope(std::pmr::memory_resource* resource)
+    : previous(xml_resource)
+{
+    xml_resource = resource;
+}
+
+xml_resource_scope::~xml_resource_scope()
+{
+    xml_resource = previous;
+}
+
+xml_resource_scope xml_set_resource(xml_document& document, std::pmr::memory_resource* resource)
+{
+    document.set_allocator(xml_allocate_block, xml_free_block);
+    return xml_resource_scope(resource);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+#include <cereal/macros.hpp>
+#include <cereal/external/rapidxml/rapidxml.hpp>
+
+using xml_document = cereal::rapidxml::xml_document<char>;
+using xml_node = cereal::rapidxml::xml_node<char>;
+using xml_attribute = cereal::rapidxml::xml_attribute<char>;
+
+/// @brief Parses a text in place into a document, with the same result as parse<0> of rapidxml:
+/// declarations, comments and doctypes are skipped, entities are decoded and names and values are
+/// zero terminated inside the text. Long runs of text are scanned with SIMD compares. The text
+/// must stay alive as long as the document
+/// @param document
+/// @param text
+/// @param size
+void xml_parse(xml_document& document, char* text, const std::size_t size);
+
+/// @brief Parses a text in place like xml_parse and appends the nodes found to a node of a
+/// document instead of replacing the content of the document. The nodes are allocated from the
+/// document and the text must stay alive as long as the document
+/// @param document
+/// @param node
+/// @param text
+/// @param size
+void xml_parse_children(xml_document& document, xml_node* node, char* text, const std::size_t size);
+
+/// @brief Prints a node and its children at the end of a text with the formatting of Live: one
+/// element per line indented with tabs, childless elements closed with " />" and attribute values
+/// quoted with '"'. Runs of characters that need no escaping are copied in bulk
+/// @param text
+/// @param node
+/// @param indent
+void xml_print(std::pmr::string& text, const xml_node* node, const std::size_t indent = 0);
+
+/// @brief Restores the memory resource that pool blocks were allocated from on a thread before
+/// xml_set_resource when it goes out of scope
+struct xml_resource_scope {
+    std::pmr::memory_resource* previous;
+
+    explicit xml_resource_scope(std::pmr::memory_resource* resource);
+    xml_resource_scope(const xml_resource_scope&) = delete;
+    xml_resource_scope& operator=(const xml_resource_scope&) = delete;
+    ~xml_resource_scope();
+};
+
+/// @brief Allocates the pool blocks of a document from a memory resource, nullptr meaning the
+/// default resource, for as long as the returned scope lives. Blocks are allocated from the
+/// resource of the innermost scope alive on the calling thread, so a document used on another
+/// thread is set up again there, and they are released to the resource they come from. Must be
+/// called before the document allocates or after it is cleared
+/// @param document
+/// @param resource
+[[nodiscard]] xml_resource_scope xml_set_resource(xml_document& document, std::pmr::memory_resource* resource);
@@ -0,0 +1,90 @@
+#include <fmtals/atom.hpp>
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+TEST(atom, equal_strings_share_an_atom)
+{
+    const std::size_t _count = fmtals::atom_count();
+    const fmtals::atom _first = fmtals::make_atom("fmtals atom test");
+    const fmtals::atom _second = fmtals::make_atom(std::string("fmtals atom ") + "test");
+    const fmtals::atom _other = fmtals::make_atom("fmtals atom test other");
+    EXPECT_EQ(_first, _second);
+    EXPECT_NE(_first, _other);
+    EXPECT_EQ(fmtals::atom_string(_first), "fmtals atom test");
+    EXPECT_EQ(&fmtals::atom_string(_first), &fmtals::atom_string(_second));
+    EXPECT_EQ(static_cast<const std::string&>(_other), "fmtals atom test other");
+    EXPECT_EQ(fmtals::atom_count(), _count + 2);
+
+    // the empty string is the default atom and is not counted
+    EXPECT_EQ(fmtals::make_atom(""), fmtals::atom());
+    EXPECT_EQ(fmtals::make_atom("").index, 0u);
+    EXPECT_EQ(fmtals::atom_string(fmtals::atom()), "");
+    EXPECT_EQ(fmtals::atom_count(), _count + 2);
+}
+
+TEST(atom, string_leaves_the_table_with_its_last_atom)
+{
+    const std::size_t _count = fmtals::atom_count();
+    {
+        fmtals::atom _atom = fmtals::make_atom("fmtals atom release");
+        EXPECT_EQ(fmtals::atom_count(), _count + 1);
+        fmtals::atom _copy = _atom;
+        fmtals::atom _moved = std::move(_atom);
+        EXPECT_EQ(_atom, fmtals::atom());
+        fmtals::atom _assigned;
+        _assigned = _copy;
+        _copy = fmtals::atom();
+        _moved = fmtals::atom();
+        EXPECT_EQ(fmtals::atom_count(), _count + 1);
+        EXPECT_EQ(fmtals::atom_string(_assigned), "fmtals atom release");
+    }
+    EXPECT_EQ(fmtals::atom_count(), _count);
+
+    // a released string is interned again from scratch
+    const fmtals::atom _atom = fmtals::make_atom("fmtals atom release");
+    EXPECT_EQ(fmtals::atom_string(_atom), "fmtals atom release");
+    EXPECT_EQ(fmtals::atom_count(), _count + 1);
+}
+
+TEST(atom, projects_release_their_strings)
+{
+    const std::size_t _count = fmtals::atom_count();
+    {
+        fmtals::project _proj = make_test_project(6, 1);
+        fmtals::project _copy = _proj;
+        EXPECT_GT(fmtals::atom_count(), _count);
+        _proj = fmtals::project();
+        fmtals::project _imported;
+        import_test_set(export_test_set(_copy), _imported);
+    }
+    EXPECT_EQ(fmtals::atom_count(), _count);
+}
+
+TEST(atom, concurrent_interning_and_release)
+{
+    const std::size_t _count = fmtals::atom_count();
+    std::vector<std::thread> _threads;
+    for (int _thread = 0; _thread < 4; ++_thread) {
+        _threads.emplace_back([]() {
+            for (int _round = 0; _round < 2000; ++_round) {
+                const fmtals::atom _atom = fmtals::make_atom("fmtals atom shared " + std::to_string(_round % 7));
+                const fmtals::atom _copy = _atom;
+                if (fmtals::atom_string(_copy) != "fmtals atom shared " + std::to_string(_round % 7)) {
+                    ADD_FAILURE() << "Wrong string for round " << _round;
+                    return;
+                }
+            }
+        });
+    }
+    for (std::thread& _thread : _threads) {
+        _thread.join();
+    }
+    EXPECT_EQ(fmtals::atom_count(), _count);
+}
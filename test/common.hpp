@@ -0,0 +1,105 @@
+#pragma once
+
+#include <fmtals/atom.hpp>
+#include <fmtals/fmtals.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+/// @brief Builds a project with alternating audio and MIDI tracks, each with two automation
+/// lanes, and scenes, migrated so that it can be exported for a version
+/// @param track_count
+/// @param scene_count
+/// @param ver
+inline fmtals::project make_test_project(const std::size_t track_count, const std::size_t scene_count, const fmtals::version ver = fmtals::version::v_12_0_0)
+{
+    fmtals::project _proj;
+    for (std::size_t _index = 0; _index < track_count; ++_index) {
+        if (_index % 2 == 0) {
+            fmtals::project::audio_track _track;
+            _track.id = static_cast<std::uint32_t>(_index);
+            _track.effective_name = fmtals::make_atom("Audio " + std::to_string(_index));
+            _track.automation_lanes.resize(2);
+            _proj.tracks.emplace_back(std::move(_track));
+        } else {
+            fmtals::project::midi_track _track;
+            _track.id = static_cast<std::uint32_t>(_index);
+            _track.effective_name = fmtals::make_atom("MIDI " + std::to_string(_index));
+            _track.automation_lanes.resize(2);
+            _proj.tracks.emplace_back(std::move(_track));
+        }
+    }
+    _proj.scene_names.resize(scene_count);
+    for (std::size_t _index = 0; _index < scene_count; ++_index) {
+        _proj.scene_names[_index].value = "Scene " + std::to_string(_index);
+    }
+    fmtals::migrate_project(_proj, ver);
+    return _proj;
+}
+
+/// @brief Exports a project to the compressed bytes of a set
+/// @param proj
+/// @param ver
+inline std::string export_test_set(const fmtals::project& proj, const fmtals::version ver = fmtals::version::v_12_0_0)
+{
+    std::stringstream _stream;
+    fmtals::export_project(_stream, proj, ver);
+    return _stream.str();
+}
+
+/// @brief Imports the compressed bytes of a set into a project
+/// @param set
+/// @param proj
+inline fmtals::version import_test_set(const std::string& set, fmtals::project& proj)
+{
+    std::stringstream _stream(set);
+    fmtals::version _ver;
+    fmtals::import_project(_stream, proj, _ver);
+    return _ver;
+}
+
+/// @brief Represents a memory resource that counts the allocations made through it
+struct counting_resource : std::pmr::memory_resource {
+    std::size_t allocations = 0;
+
+protected:
+    void* do_allocate(std::size_t size, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* pointer, std::size_t size, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(pointer, size, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/// @brief Retrieves a temporary directory of its own for the running test, named after the test
+/// and the process so that concurrent runs of the suite never share it
+inline std::filesystem::path get_test_directory()
+{
+    const testing::TestInfo* _info = testing::UnitTest::GetInstance()->current_test_info();
+#ifdef _WIN32
+    const int _process_id = _getpid();
+#else
+    const int _process_id = static_cast<int>(getpid());
+#endif
+    return std::filesystem::temp_directory_path() / ("fmtals_test_" + std::string(_info->test_suite_name()) + "_" + _info->name() + "_" + std::to_string(_process_id));
+}
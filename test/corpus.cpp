@@ -0,0 +1,154 @@
+#include <fmtals/corpus.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+static std::vector<std::uint32_t> get_uint32_column(const fmtals::corpus_dataset& dataset, const fmtals::corpus_table table, const std::string_view name)
+{
+    const fmtals::corpus_column _column = fmtals::find_corpus_column(dataset, table, name);
+    EXPECT_EQ(_column.row_count, fmtals::corpus_row_count(dataset, table));
+    const std::uint32_t* _data = static_cast<const std::uint32_t*>(_column.data);
+    return std::vector<std::uint32_t>(_data, _data + _column.row_count);
+}
+
+static std::vector<std::string> get_string_column(const fmtals::corpus_dataset& dataset, const fmtals::corpus_table table, const std::string_view name)
+{
+    std::vector<std::string> _strings;
+    for (const std::uint32_t _code : get_uint32_column(dataset, table, name)) {
+        _strings.emplace_back(fmtals::get_corpus_string(dataset, _code));
+    }
+    return _strings;
+}
+
+struct corpus : testing::Test {
+    std::filesystem::path directory = get_test_directory();
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+};
+
+TEST_F(corpus, append_rebases_ids)
+{
+    const std::vector<fmtals::project> _projects { make_test_project(2, 1), make_test_project(3, 2), make_test_project(4, 3) };
+    const std::vector<std::string> _names { "a.als", "b.als", "c.als" };
+    fmtals::corpus_builder _first;
+    fmtals::add_corpus_project(_first, _projects[0], fmtals::version::v_12_0_0, _names[0]);
+    fmtals::add_corpus_project(_first, _projects[1], fmtals::version::v_12_0_0, _names[1]);
+    fmtals::append_corpus_dataset(directory, _first);
+
+    fmtals::corpus_dataset _dataset;
+    fmtals::open_corpus_dataset(directory, _dataset);
+    EXPECT_EQ(fmtals::corpus_row_count(_dataset, fmtals::corpus_table::project), 2u);
+    const std::size_t _first_track_count = fmtals::corpus_row_count(_dataset, fmtals::corpus_table::track);
+    const std::uint32_t _first_string_code = get_uint32_column(_dataset, fmtals::corpus_table::track, "effective_name")[0];
+    _dataset = fmtals::corpus_dataset();
+
+    fmtals::corpus_builder _second;
+    fmtals::add_corpus_project(_second, _projects[2], fmtals::version::v_12_0_0, _names[2]);
+    fmtals::append_corpus_dataset(directory, _second);
+    fmtals::open_corpus_dataset(directory, _dataset);
+
+    EXPECT_EQ(get_string_column(_dataset, fmtals::corpus_table::project, "name"), _names);
+    const std::vector<std::uint32_t> _track_project_ids = get_uint32_column(_dataset, fmtals::corpus_table::track, "project_id");
+    const std::vector<std::string> _track_names = get_string_column(_dataset, fmtals::corpus_table::track, "effective_name");
+    const std::vector<std::uint32_t> _track_indices = get_uint32_column(_dataset, fmtals::corpus_table::track, "index");
+    std::vector<std::size_t> _track_counts(3);
+    for (std::size_t _row = 0; _row < _track_project_ids.size(); ++_row) {
+        ASSERT_LT(_track_project_ids[_row], 3u);
+        ASSERT_TRUE(_row == 0 || _track_project_ids[_row] >= _track_project_ids[_row - 1]);
+        const fmtals::project& _proj = _projects[_track_project_ids[_row]];
+        if (_track_indices[_row] < _proj.tracks.size()) {
+            ++_track_counts[_track_project_ids[_row]];
+            EXPECT_EQ(_track_names[_row], fmtals::atom_string(std::visit([](const fmtals::project::editable_track& _track_visit) -> const fmtals::project::editable_track& { return _track_visit; }, _proj.tracks[_track_indices[_row]]).effective_name));
+        }
+    }
+    EXPECT_EQ(_track_counts, (std::vector<std::size_t> { 2, 3, 4 }));
+    EXPECT_EQ(static_cast<std::size_t>(std::count(_track_project_ids.begin(), _track_project_ids.end(), 2u)), _track_project_ids.size() - _first_track_count);
+
+    // Lanes point to a track of their own project, the lanes of the second append included
+    const std::vector<std::uint32_t> _lane_project_ids = get_uint32_column(_dataset, fmtals::corpus_table::automation_lane, "project_id");
+    const std::vector<std::uint32_t> _lane_track_ids = get_uint32_column(_dataset, fmtals::corpus_table::automation_lane, "track_id");
+    std::size_t _second_lane_count = 0;
+    for (std::size_t _row = 0; _row < _lane_track_ids.size(); ++_row) {
+        ASSERT_LT(_lane_track_ids[_row], _track_project_ids.size());
+        EXPECT_EQ(_track_project_ids[_lane_track_ids[_row]], _lane_project_ids[_row]);
+        if (_lane_project_ids[_row] == 2) {
+            EXPECT_GE(_lane_track_ids[_row], _first_track_count);
+            ++_second_lane_count;
+        }
+    }
+    EXPECT_GE(_second_lane_count, 8u);
+
+    EXPECT_EQ(get_uint32_column(_dataset, fmtals::corpus_table::scene, "project_id"), (std::vector<std::uint32_t> { 0, 1, 1, 2, 2, 2 }));
+    EXPECT_EQ(get_string_column(_dataset, fmtals::corpus_table::scene, "name"), (std::vector<std::string> { "Scene 0", "Scene 0", "Scene 1", "Scene 0", "Scene 1", "Scene 2" }));
+
+    // Strings of the second append already in the dictionary keep their code
+    const std::vector<std::uint32_t> _track_name_codes = get_uint32_column(_dataset, fmtals::corpus_table::track, "effective_name");
+    EXPECT_EQ(_track_name_codes[0], _first_string_code);
+    EXPECT_EQ(_track_name_codes[_first_track_count], _first_string_code);
+    const std::vector<std::uint32_t> _scene_name_codes = get_uint32_column(_dataset, fmtals::corpus_table::scene, "name");
+    EXPECT_EQ(_scene_name_codes[3], _scene_name_codes[0]);
+    EXPECT_EQ(_scene_name_codes[4], _scene_name_codes[2]);
+}
+
+TEST_F(corpus, audio_clips_of_imported_sets)
+{
+    fmtals::project _proj = make_test_project(3, 1);
+    for (const std::size_t _track_index : { 0, 2 }) {
+        fmtals::project::audio_track& _track = std::get<fmtals::project::audio_track>(_proj.tracks[_track_index]);
+        _track.events_audio_clips.resize(_track_index + 1);
+        for (std::size_t _clip_index = 0; _clip_index <= _track_index; ++_clip_index) {
+            _track.events_audio_clips[_clip_index].time = 4.5 * static_cast<double>(_clip_index);
+            _track.events_audio_clips[_clip_index].name = "Clip " + std::to_string(_clip_index);
+            _track.events_audio_clips[_clip_index].color = 5;
+        }
+    }
+    fmtals::project _imported;
+    const fmtals::version _ver = import_test_set(export_test_set(_proj), _imported);
+    fmtals::corpus_builder _builder;
+    fmtals::add_corpus_project(_builder, make_test_project(2, 1), _ver, "empty.als");
+    fmtals::add_corpus_project(_builder, _imported, _ver, "clips.als");
+    fmtals::append_corpus_dataset(directory, _builder);
+
+    fmtals::corpus_dataset _dataset;
+    fmtals::open_corpus_dataset(directory, _dataset);
+    ASSERT_EQ(fmtals::corpus_row_count(_dataset, fmtals::corpus_table::audio_clip), 4u);
+    EXPECT_EQ(get_uint32_column(_dataset, fmtals::corpus_table::audio_clip, "project_id"), (std::vector<std::uint32_t> { 1, 1, 1, 1 }));
+    EXPECT_EQ(get_uint32_column(_dataset, fmtals::corpus_table::audio_clip, "index"), (std::vector<std::uint32_t> { 0, 0, 1, 2 }));
+    EXPECT_EQ(get_string_column(_dataset, fmtals::corpus_table::audio_clip, "name"), (std::vector<std::string> { "Clip 0", "Clip 0", "Clip 1", "Clip 2" }));
+    const fmtals::corpus_column _times = fmtals::find_corpus_column(_dataset, fmtals::corpus_table::audio_clip, "time");
+    ASSERT_EQ(_times.type, fmtals::corpus_type::float32);
+    EXPECT_EQ(static_cast<const float*>(_times.data)[3], 9.0f);
+    const std::vector<std::uint32_t> _track_indices = get_uint32_column(_dataset, fmtals::corpus_table::track, "index");
+    const std::vector<std::uint32_t> _track_project_ids = get_uint32_column(_dataset, fmtals::corpus_table::track, "project_id");
+    std::vector<std::uint32_t> _clip_tracks;
+    for (const std::uint32_t _track_id : get_uint32_column(_dataset, fmtals::corpus_table::audio_clip, "track_id")) {
+        ASSERT_LT(_track_id, _track_indices.size());
+        EXPECT_EQ(_track_project_ids[_track_id], 1u);
+        _clip_tracks.push_back(_track_indices[_track_id]);
+    }
+    EXPECT_EQ(_clip_tracks, (std::vector<std::uint32_t> { 0, 2, 2, 2 }));
+}
+
+TEST_F(corpus, open_rejects_a_missing_dataset)
+{
+    fmtals::corpus_dataset _dataset;
+    EXPECT_THROW(fmtals::open_corpus_dataset(directory, _dataset), std::runtime_error);
+}
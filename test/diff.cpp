@@ -0,0 +1,165 @@
+#include <fmtals/diff.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+using change_tuple = std::tuple<fmtals::change_scope, fmtals::change_type, std::size_t, std::size_t, std::size_t, std::size_t>;
+
+static constexpr std::size_t npos = fmtals::change::npos;
+
+static std::vector<change_tuple> diff_test_projects(const fmtals::project& from, const fmtals::project& to)
+{
+    std::vector<change_tuple> _changes;
+    for (const fmtals::change& _change : fmtals::diff(from, to)) {
+        _changes.emplace_back(_change.scope, _change.type, _change.old_index, _change.new_index, _change.old_child_index, _change.new_child_index);
+    }
+    return _changes;
+}
+
+static fmtals::project::editable_track& get_editable_track(fmtals::project::user_track& track)
+{
+    return std::visit([](fmtals::project::editable_track& _track_visit) -> fmtals::project::editable_track& { return _track_visit; }, track);
+}
+
+/// @brief Reorders the tracks of a project, the new track at each position being the old track at
+/// the index given for it
+static void reorder_test_tracks(fmtals::project& proj, const std::vector<std::size_t>& order)
+{
+    fmtals::project::allocator_type _allocator = proj.get_allocator();
+    std::pmr::vector<fmtals::project::user_track> _tracks(_allocator);
+    for (const std::size_t _index : order) {
+        _tracks.emplace_back(proj.tracks[_index]);
+    }
+    proj.tracks = std::move(_tracks);
+}
+
+TEST(diff, identical_projects_have_no_changes)
+{
+    const fmtals::project _proj = make_test_project(6, 3);
+    EXPECT_TRUE(fmtals::diff(_proj, _proj).empty());
+    EXPECT_TRUE(fmtals::diff(_proj, make_test_project(6, 3)).empty());
+}
+
+TEST(diff, track_rename)
+{
+    const fmtals::project _from = make_test_project(4, 2);
+    fmtals::project _to = _from;
+    get_editable_track(_to.tracks[2]).effective_name = fmtals::make_atom("Renamed");
+    EXPECT_EQ(diff_test_projects(_from, _to), (std::vector<change_tuple> { { fmtals::change_scope::track, fmtals::change_type::renamed, 2, 2, npos, npos } }));
+
+    // the memorized first clip name follows the clips and is not a change of its own
+    _to = _from;
+    get_editable_track(_to.tracks[1]).memorized_first_clip_name = "Clip";
+    EXPECT_TRUE(diff_test_projects(_from, _to).empty());
+}
+
+TEST(diff, moves_follow_the_longest_increasing_subsequence)
+{
+    const fmtals::project _from = make_test_project(6, 1);
+
+    // the track taken out of order is the only move, the others keep their relative order
+    fmtals::project _to = _from;
+    reorder_test_tracks(_to, { 1, 2, 3, 4, 5, 0 });
+    EXPECT_EQ(diff_test_projects(_from, _to), (std::vector<change_tuple> { { fmtals::change_scope::track, fmtals::change_type::moved, 0, 5, npos, npos } }));
+
+    _to = _from;
+    reorder_test_tracks(_to, { 5, 0, 1, 2, 3, 4 });
+    EXPECT_EQ(diff_test_projects(_from, _to), (std::vector<change_tuple> { { fmtals::change_scope::track, fmtals::change_type::moved, 5, 0, npos, npos } }));
+
+    // two swapped pairs move one track each
+    _to = _from;
+    reorder_test_tracks(_to, { 1, 0, 2, 3, 5, 4 });
+    const std::vector<change_tuple> _changes = diff_test_projects(_from, _to);
+    ASSERT_EQ(_changes.size(), 2u);
+    for (const change_tuple& _change : _changes) {
+        EXPECT_EQ(std::get<1>(_change), fmtals::change_type::moved);
+        EXPECT_EQ(_to.tracks[std::get<3>(_change)].index(), _from.tracks[std::get<2>(_change)].index());
+    }
+
+    // removed and added tracks do not count as moves of the others, a moved track also reports
+    // its own changes
+    _to = _from;
+    reorder_test_tracks(_to, { 0, 4, 1, 2, 5 });
+    get_editable_track(_to.tracks[1]).effective_name = fmtals::make_atom("Moved");
+    get_editable_track(_to.tracks.emplace_back(_from.tracks[0])).id = 99;
+    EXPECT_EQ(diff_test_projects(_from, _to),
+        (std::vector<change_tuple> {
+            { fmtals::change_scope::track, fmtals::change_type::removed, 3, npos, npos, npos },
+            { fmtals::change_scope::track, fmtals::change_type::added, npos, 5, npos, npos },
+            { fmtals::change_scope::track, fmtals::change_type::moved, 4, 1, npos, npos },
+            { fmtals::change_scope::track, fmtals::change_type::renamed, 4, 1, npos, npos },
+        }));
+}
+
+TEST(diff, clips_match_by_hash_then_content)
+{
+    fmtals::project _from = make_test_project(2, 1);
+    std::pmr::vector<fmtals::project::audio_clip>& _from_clips = std::get<fmtals::project::audio_track>(_from.tracks[0]).events_audio_clips;
+    _from_clips.resize(4);
+    for (std::size_t _clip = 0; _clip < _from_clips.size(); ++_clip) {
+        _from_clips[_clip].time = 4.0 * static_cast<double>(_clip);
+        _from_clips[_clip].name = "Clip " + std::to_string(_clip);
+    }
+
+    // identical clips match wherever they are stored
+    fmtals::project _to = _from;
+    std::pmr::vector<fmtals::project::audio_clip>& _to_clips = std::get<fmtals::project::audio_track>(_to.tracks[0]).events_audio_clips;
+    std::swap(_to_clips[0], _to_clips[3]);
+    EXPECT_TRUE(diff_test_projects(_from, _to).empty());
+
+    // a clip at another time keeps its content, a renamed clip at the same time does not
+    _to_clips = _from_clips;
+    _to_clips[1].time = 20.0;
+    _to_clips[2].name = "Renamed";
+    EXPECT_EQ(diff_test_projects(_from, _to),
+        (std::vector<change_tuple> {
+            { fmtals::change_scope::track, fmtals::change_type::clip_moved, 0, 0, 1, 1 },
+            { fmtals::change_scope::track, fmtals::change_type::clip_modified, 0, 0, 2, 2 },
+        }));
+
+    // content matches take precedence over pairing in order, the surplus of new clips is added
+    _to_clips = _from_clips;
+    _to_clips.erase(_to_clips.begin());
+    _to_clips[0].time = 30.0;
+    _to_clips.emplace_back().name = "New";
+    _to_clips.emplace_back().name = "Newer";
+    EXPECT_EQ(diff_test_projects(_from, _to),
+        (std::vector<change_tuple> {
+            { fmtals::change_scope::track, fmtals::change_type::clip_moved, 0, 0, 1, 0 },
+            { fmtals::change_scope::track, fmtals::change_type::clip_modified, 0, 0, 0, 3 },
+            { fmtals::change_scope::track, fmtals::change_type::clip_added, 0, 0, npos, 4 },
+        }));
+}
+
+TEST(diff, digests_give_the_same_changes)
+{
+    const fmtals::project _from = make_test_project(6, 3);
+    fmtals::project _to = _from;
+    reorder_test_tracks(_to, { 2, 0, 1, 3, 4, 5 });
+    get_editable_track(_to.tracks[4]).effective_name = fmtals::make_atom("Renamed");
+    _to.scene_names[1].value = "Renamed";
+    const fmtals::project_digest _from_digest = fmtals::digest_project(_from);
+    const fmtals::project_digest _to_digest = fmtals::digest_project(_to);
+    EXPECT_EQ(_from_digest.tracks[2].subtree, _to_digest.tracks[0].subtree);
+    EXPECT_NE(_from_digest.tracks[4].names, _to_digest.tracks[4].names);
+    EXPECT_EQ(_from_digest.tracks[4].header, _to_digest.tracks[4].header);
+    EXPECT_EQ(_from_digest.scenes[0], _to_digest.scenes[0]);
+    EXPECT_NE(_from_digest.scenes[1], _to_digest.scenes[1]);
+
+    const std::vector<fmtals::change> _changes = fmtals::diff(_from, _from_digest, _to, _to_digest);
+    const std::vector<change_tuple> _expected = diff_test_projects(_from, _to);
+    ASSERT_EQ(_changes.size(), _expected.size());
+    for (std::size_t _index = 0; _index < _changes.size(); ++_index) {
+        EXPECT_EQ(change_tuple(_changes[_index].scope, _changes[_index].type, _changes[_index].old_index, _changes[_index].new_index, _changes[_index].old_child_index, _changes[_index].new_child_index), _expected[_index]);
+    }
+    EXPECT_THROW(fmtals::diff(_from, _from_digest, make_test_project(6, 2), _to_digest), std::runtime_error);
+    EXPECT_THROW(fmtals::diff(_from, _from_digest, make_test_project(5, 3), _to_digest), std::runtime_error);
+}
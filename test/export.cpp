@@ -0,0 +1,32 @@
+#include <fmtals/fmtals.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+static std::string export_test_set(const fmtals::project& proj, const fmtals::version ver, const std::size_t jobs)
+{
+    std::stringstream _stream;
+    fmtals::export_project(_stream, proj, ver, fmtals::export_options { jobs });
+    return _stream.str();
+}
+
+TEST(export, jobs_do_not_change_the_set)
+{
+    for (const fmtals::version _ver : { fmtals::version::v_9_7_7, fmtals::version::v_11_0_0, fmtals::version::v_12_0_0 }) {
+        for (const std::size_t _track_count : { 0, 1, 2, 137 }) {
+            const fmtals::project _proj = make_test_project(_track_count, 3, _ver);
+            const std::string _set = export_test_set(_proj, _ver, 1);
+            EXPECT_EQ(export_test_set(_proj, _ver), _set) << _track_count << " tracks";
+            EXPECT_EQ(export_test_set(_proj, _ver, 4), _set) << _track_count << " tracks";
+            EXPECT_EQ(export_test_set(_proj, _ver, 16), _set) << _track_count << " tracks";
+
+            fmtals::project _imported;
+            import_test_set(_set, _imported);
+            EXPECT_EQ(_imported.tracks.size(), _track_count);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+#include <fmtals/diff.hpp>
+
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+extern void gz_decompress(std::istream& gz_stream, const std::function<void(const char*, std::size_t)>& callback);
+extern void gz_compress(std::ostream& gz_stream, std::istream& data_stream);
+
+static fmtals::version import_test_set(const std::string& set, fmtals::project& proj, const std::size_t jobs)
+{
+    std::stringstream _stream(set);
+    fmtals::version _ver;
+    fmtals::import_project(_stream, proj, _ver, fmtals::import_options { jobs });
+    return _ver;
+}
+
+/// @brief Renames the first node with children and a name inside some tracks of a set, so that importing each
+/// of these tracks fails on its own missing node
+/// @param set
+/// @param nodes the track indices with the names of their node to rename
+static std::string break_test_tracks(const std::string& set, const std::vector<std::pair<std::size_t, std::string>>& nodes)
+{
+    std::stringstream _set_stream(set);
+    std::string _text;
+    gz_decompress(_set_stream, [&](const char* chunk, const std::size_t size) {
+        _text.append(chunk, size);
+    });
+    std::vector<std::size_t> _track_positions;
+    const std::size_t _tracks_end = _text.find("</Tracks>");
+    for (std::size_t _position = _text.find("<Tracks>"); _position < _tracks_end; ++_position) {
+        if (_text.compare(_position, 12, "<AudioTrack ") == 0 || _text.compare(_position, 11, "<MidiTrack ") == 0) {
+            _track_positions.push_back(_position);
+        }
+    }
+    for (const std::pair<std::size_t, std::string>& _node : nodes) {
+        const std::size_t _position = _text.find("<" + _node.second + ">", _track_positions.at(_node.first));
+        _text.insert(_position + 1 + _node.second.size(), "Broken");
+        _text.insert(_text.find("</" + _node.second + ">", _position) + 2 + _node.second.size(), "Broken");
+    }
+    std::stringstream _text_stream(_text);
+    std::stringstream _broken_stream;
+    gz_compress(_broken_stream, _text_stream);
+    return _broken_stream.str();
+}
+
+/// @brief Retrieves the message of the error thrown when importing a set
+static std::string get_import_error(const std::string& set, const std::size_t jobs)
+{
+    fmtals::project _proj;
+    try {
+        import_test_set(set, _proj, jobs);
+    } catch (const std::runtime_error& _error) {
+        return _error.what();
+    }
+    return std::string();
+}
+
+TEST(import, reimport_reuses_capacity)
+{
+    const std::string _set = export_test_set(make_test_project(40, 8));
+    counting_resource _resource;
+    fmtals::project _proj(&_resource);
+    import_test_set(_set, _proj);
+    const std::size_t _first_allocations = _resource.allocations;
+    _resource.allocations = 0;
+    import_test_set(_set, _proj);
+    EXPECT_GT(_first_allocations, 0u);
+    EXPECT_EQ(_resource.allocations, 0u);
+    EXPECT_EQ(_proj.tracks.size(), 40u);
+    EXPECT_EQ(_proj.scene_names.size(), 8u);
+}
+
+TEST(import, reimport_replaces_previous_content)
+{
+    const std::string _large_set = export_test_set(make_test_project(12, 6));
+    const std::string _small_set = export_test_set(make_test_project(3, 2, fmtals::version::v_11_0_0), fmtals::version::v_11_0_0);
+    fmtals::project _reused;
+    import_test_set(_large_set, _reused);
+    const fmtals::version _ver = import_test_set(_small_set, _reused);
+    fmtals::project _fresh;
+    import_test_set(_small_set, _fresh);
+    EXPECT_EQ(_ver, fmtals::version::v_11_0_0);
+    EXPECT_EQ(_reused.tracks.size(), 3u);
+    EXPECT_TRUE(fmtals::diff(_fresh, _reused).empty());
+}
+
+TEST(import, jobs_do_not_change_the_project)
+{
+    for (const fmtals::version _ver : { fmtals::version::v_9_7_7, fmtals::version::v_11_0_0, fmtals::version::v_12_0_0 }) {
+        fmtals::project _proj = make_test_project(37, 4, _ver);
+        std::get<fmtals::project::audio_track>(_proj.tracks[4]).events_audio_clips.resize(3);
+        fmtals::migrate_project(_proj, _ver);
+        const std::string _set = export_test_set(_proj, _ver);
+        fmtals::project _serial;
+        EXPECT_EQ(import_test_set(_set, _serial, 1), _ver);
+        for (const std::size_t _jobs : { 2, 4, 0 }) {
+            fmtals::project _parallel;
+            EXPECT_EQ(import_test_set(_set, _parallel, _jobs), _ver);
+            EXPECT_TRUE(fmtals::diff(_serial, _parallel).empty()) << _jobs << " jobs";
+            EXPECT_EQ(export_test_set(_parallel, _ver), _set) << _jobs << " jobs";
+        }
+    }
+}
+
+TEST(import, jobs_rethrow_the_error_of_the_first_failing_track)
+{
+    const std::string _set = export_test_set(make_test_project(37, 2));
+    const std::string _broken_set = break_test_tracks(_set, { { 30, "AutomationEnvelopes" }, { 7, "TrackDelay" }, { 21, "DeviceChain" }, { 8, "Name" } });
+    for (const std::size_t _jobs : { 1, 2, 4, 0 }) {
+        for (int _run = 0; _run < 10; ++_run) {
+            EXPECT_EQ(get_import_error(_broken_set, _jobs), "Missing XML node: TrackDelay") << _jobs << " jobs";
+        }
+    }
+    EXPECT_EQ(get_import_error(break_test_tracks(_set, { { 36, "AutomationEnvelopes" }, { 21, "DeviceChain" } }), 4), "Missing XML node: DeviceChain");
+    EXPECT_EQ(get_import_error(break_test_tracks(_set, { { 36, "AutomationEnvelopes" } }), 4), "Missing XML node: AutomationEnvelopes");
+    EXPECT_TRUE(get_import_error(_set, 4).empty());
+}
@@ -0,0 +1,143 @@
+#include <fmtals/lom.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+static void expect_lom_handle(const fmtals::lom_index& index, const std::uint32_t id, const fmtals::lom_owner owner, const fmtals::lom_field field, const std::size_t handle_index = fmtals::lom_handle::npos, const std::size_t child_index = fmtals::lom_handle::npos)
+{
+    const fmtals::lom_handle* _handle = fmtals::find_lom_id(index, id);
+    ASSERT_NE(_handle, nullptr) << id;
+    EXPECT_EQ(_handle->owner, owner) << id;
+    EXPECT_EQ(_handle->field, field) << id;
+    EXPECT_EQ(_handle->index, handle_index) << id;
+    EXPECT_EQ(_handle->child_index, child_index) << id;
+}
+
+/// @brief Builds a test project with LOM ids on the project, its tracks, clip slots, clips and
+/// scenes
+static fmtals::project make_lom_test_project()
+{
+    fmtals::project _proj = make_test_project(4, 2);
+    _proj.lom_id = 1;
+    _proj.scenes_list_wrapper_lom_id = 2;
+    fmtals::project::audio_track& _audio_track = std::get<fmtals::project::audio_track>(_proj.tracks[2]);
+    _audio_track.lom_id = 10;
+    _audio_track.mixer_lom_id = 11;
+    _audio_track.main_sequencer_lom_id = 12;
+    _audio_track.clip_slots.resize(2);
+    _audio_track.clip_slots[1].lom_id = 13;
+    _audio_track.events_audio_clips.resize(3);
+    _audio_track.events_audio_clips[2].lom_id = 14;
+    _audio_track.events_audio_clips[2].lom_id_view = 15;
+    std::get<fmtals::project::midi_track>(_proj.tracks[1]).tempo_lom_id = 20;
+    _proj.project_master_track.devices_list_wrapper_lom_id = 30;
+    _proj.scene_names[1].lom_id = 40;
+    _proj.scene_names[1].clip_slots_list_wrapper_lom_id = 41;
+    return _proj;
+}
+
+TEST(lom, index_locates_every_owner)
+{
+    const fmtals::project _proj = make_lom_test_project();
+    fmtals::lom_index _index;
+    fmtals::index_lom_ids(_proj, _index);
+    EXPECT_EQ(_index.count, 12u);
+    EXPECT_EQ(_index.max_id, 41u);
+    EXPECT_TRUE(_index.duplicate_ids.empty());
+    EXPECT_NO_THROW(fmtals::validate_lom_ids(_index));
+    expect_lom_handle(_index, 1, fmtals::lom_owner::project, fmtals::lom_field::lom_id);
+    expect_lom_handle(_index, 2, fmtals::lom_owner::project, fmtals::lom_field::scenes_list_wrapper);
+    expect_lom_handle(_index, 10, fmtals::lom_owner::track, fmtals::lom_field::lom_id, 2);
+    expect_lom_handle(_index, 11, fmtals::lom_owner::track, fmtals::lom_field::mixer, 2);
+    expect_lom_handle(_index, 12, fmtals::lom_owner::track, fmtals::lom_field::main_sequencer, 2);
+    expect_lom_handle(_index, 13, fmtals::lom_owner::clip_slot, fmtals::lom_field::lom_id, 2, 1);
+    expect_lom_handle(_index, 14, fmtals::lom_owner::audio_clip, fmtals::lom_field::lom_id, 2, 2);
+    expect_lom_handle(_index, 15, fmtals::lom_owner::audio_clip, fmtals::lom_field::lom_id_view, 2, 2);
+    expect_lom_handle(_index, 20, fmtals::lom_owner::track, fmtals::lom_field::tempo, 1);
+    expect_lom_handle(_index, 30, fmtals::lom_owner::master_track, fmtals::lom_field::devices_list_wrapper);
+    expect_lom_handle(_index, 40, fmtals::lom_owner::scene, fmtals::lom_field::lom_id, 1);
+    expect_lom_handle(_index, 41, fmtals::lom_owner::scene, fmtals::lom_field::clip_slots_list_wrapper, 1);
+    EXPECT_EQ(fmtals::find_lom_id(_index, 0), nullptr);
+    EXPECT_EQ(fmtals::find_lom_id(_index, 3), nullptr);
+    EXPECT_EQ(fmtals::find_lom_id(fmtals::lom_index(), 1), nullptr);
+
+    // indexing again clears the previous ids
+    fmtals::index_lom_ids(make_test_project(2, 1), _index);
+    EXPECT_EQ(_index.count, 0u);
+    EXPECT_EQ(_index.max_id, 0u);
+    EXPECT_EQ(fmtals::find_lom_id(_index, 10), nullptr);
+}
+
+TEST(lom, duplicates_keep_their_first_location)
+{
+    fmtals::project _proj = make_lom_test_project();
+    std::get<fmtals::project::midi_track>(_proj.tracks[3]).lom_id = 10;
+    _proj.scene_names[0].lom_id = 40;
+    fmtals::lom_index _index;
+    fmtals::index_lom_ids(_proj, _index);
+    EXPECT_EQ(_index.count, 12u);
+    EXPECT_EQ(_index.duplicate_ids, (std::vector<std::uint32_t> { 10, 40 }));
+    expect_lom_handle(_index, 10, fmtals::lom_owner::track, fmtals::lom_field::lom_id, 2);
+    expect_lom_handle(_index, 40, fmtals::lom_owner::scene, fmtals::lom_field::lom_id, 0);
+    try {
+        fmtals::validate_lom_ids(_index);
+        ADD_FAILURE() << "Duplicate LOM ids were not reported";
+    } catch (const std::runtime_error& _error) {
+        EXPECT_STREQ(_error.what(), "Duplicate LOM ids: 10 40");
+    }
+
+    EXPECT_FALSE(fmtals::insert_lom_id(_index, 1, { fmtals::lom_owner::scene, fmtals::lom_field::lom_id, 0 }));
+    EXPECT_EQ(_index.duplicate_ids.back(), 1u);
+    EXPECT_THROW(fmtals::insert_lom_id(_index, 0, { fmtals::lom_owner::scene, fmtals::lom_field::lom_id, 0 }), std::invalid_argument);
+}
+
+TEST(lom, allocate_takes_the_next_free_id)
+{
+    fmtals::lom_index _index;
+    fmtals::index_lom_ids(make_lom_test_project(), _index);
+    EXPECT_EQ(fmtals::allocate_lom_id(_index, { fmtals::lom_owner::scene, fmtals::lom_field::lom_id, 0 }), 42u);
+    EXPECT_EQ(fmtals::allocate_lom_id(_index, { fmtals::lom_owner::track, fmtals::lom_field::lom_id, 3 }), 43u);
+    expect_lom_handle(_index, 42, fmtals::lom_owner::scene, fmtals::lom_field::lom_id, 0);
+    expect_lom_handle(_index, 43, fmtals::lom_owner::track, fmtals::lom_field::lom_id, 3);
+    EXPECT_EQ(_index.count, 14u);
+
+    // an empty index starts at 1, the index grows as ids are allocated
+    fmtals::lom_index _empty;
+    for (std::uint32_t _id = 1; _id <= 5000; ++_id) {
+        ASSERT_EQ(fmtals::allocate_lom_id(_empty, { fmtals::lom_owner::clip_slot, fmtals::lom_field::lom_id, 0, _id }), _id);
+    }
+    for (std::uint32_t _id = 1; _id <= 5000; ++_id) {
+        ASSERT_NE(fmtals::find_lom_id(_empty, _id), nullptr);
+        EXPECT_EQ(fmtals::find_lom_id(_empty, _id)->child_index, _id);
+    }
+    EXPECT_GE(_empty.ids.size(), 2 * _empty.count);
+
+    fmtals::insert_lom_id(_index, UINT32_MAX, { fmtals::lom_owner::scene, fmtals::lom_field::lom_id, 1 });
+    EXPECT_THROW(fmtals::allocate_lom_id(_index, { fmtals::lom_owner::scene, fmtals::lom_field::lom_id, 1 }), std::runtime_error);
+}
+
+TEST(lom, import_indexes_the_set)
+{
+    fmtals::project _proj = make_lom_test_project();
+    fmtals::migrate_project(_proj, fmtals::version::v_12_0_0);
+    std::stringstream _stream(export_test_set(_proj));
+    fmtals::project _imported;
+    fmtals::version _ver;
+    fmtals::lom_index _index;
+    fmtals::import_project(_stream, _imported, _ver, _index);
+    fmtals::lom_index _expected;
+    fmtals::index_lom_ids(_imported, _expected);
+    EXPECT_EQ(_index.count, _expected.count);
+    EXPECT_EQ(_index.max_id, _expected.max_id);
+    expect_lom_handle(_index, 10, fmtals::lom_owner::track, fmtals::lom_field::lom_id, 2);
+    expect_lom_handle(_index, 14, fmtals::lom_owner::audio_clip, fmtals::lom_field::lom_id, 2, 2);
+    expect_lom_handle(_index, 40, fmtals::lom_owner::scene, fmtals::lom_field::lom_id, 1);
+}
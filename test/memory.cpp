@@ -0,0 +1,108 @@
+#include <fmtals/memory.hpp>
+
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+TEST(memory, usage_grows_with_the_project)
+{
+    const fmtals::project _small = make_test_project(2, 2);
+    const fmtals::project _large = make_test_project(40, 16);
+    const fmtals::project_memory _small_usage = fmtals::memory_usage(_small);
+    const fmtals::project_memory _large_usage = fmtals::memory_usage(_large);
+    EXPECT_EQ(_large_usage.total, _large_usage.settings + _large_usage.tracks + _large_usage.automation + _large_usage.clips + _large_usage.scenes + _large_usage.plugins);
+    EXPECT_GE(_small_usage.settings, sizeof(fmtals::project));
+    EXPECT_GT(_large_usage.tracks, _small_usage.tracks);
+    EXPECT_GT(_large_usage.automation, _small_usage.automation);
+    EXPECT_GT(_large_usage.scenes, _small_usage.scenes);
+}
+
+TEST(memory, counter_tracks_bytes_and_peak)
+{
+    const std::string _set = export_test_set(make_test_project(20, 4));
+    fmtals::memory_counter _counter;
+    {
+        fmtals::project _proj(&_counter);
+        fmtals::import_options _options;
+        _options.resource = &_counter;
+        std::stringstream _stream(_set);
+        fmtals::version _ver;
+        fmtals::import_project(_stream, _proj, _ver, _options);
+        const std::size_t _project_bytes = _counter.bytes;
+        EXPECT_GT(_project_bytes, 0u);
+        EXPECT_GT(_counter.peak_bytes, _project_bytes);
+
+        _counter.reset_peak();
+        EXPECT_EQ(_counter.peak_bytes, _project_bytes);
+        fmtals::export_options _export_options;
+        _export_options.resource = &_counter;
+        std::stringstream _output;
+        fmtals::export_project(_output, _proj, _ver, _export_options);
+        EXPECT_GT(_counter.peak_bytes, _project_bytes);
+        EXPECT_EQ(_counter.bytes, _project_bytes);
+    }
+    EXPECT_EQ(_counter.bytes, 0u);
+}
+
+TEST(memory, budget_aborts_and_releases_the_call)
+{
+    const std::string _set = export_test_set(make_test_project(20, 4));
+    std::size_t _peak = 0;
+    {
+        fmtals::memory_counter _counter;
+        fmtals::project _proj(&_counter);
+        fmtals::import_options _options;
+        _options.resource = &_counter;
+        std::stringstream _stream(_set);
+        fmtals::version _ver;
+        fmtals::import_project(_stream, _proj, _ver, _options);
+        _peak = _counter.peak_bytes;
+    }
+
+    fmtals::memory_counter _counter;
+    _counter.budget = _peak / 2;
+    {
+        fmtals::project _proj(&_counter);
+        fmtals::import_options _options;
+        _options.resource = &_counter;
+        std::stringstream _stream(_set);
+        fmtals::version _ver;
+        try {
+            fmtals::import_project(_stream, _proj, _ver, _options);
+            ADD_FAILURE() << "Import within half of its peak did not throw";
+        } catch (const std::runtime_error& _exception) {
+            EXPECT_NE(std::string(_exception.what()).find("Memory budget exceeded"), std::string::npos);
+        }
+        EXPECT_LE(_counter.bytes, _counter.budget);
+    }
+    EXPECT_EQ(_counter.bytes, 0u);
+
+    _counter.budget = _peak;
+    fmtals::project _proj(&_counter);
+    fmtals::import_options _options;
+    _options.resource = &_counter;
+    std::stringstream _stream(_set);
+    fmtals::version _ver;
+    EXPECT_NO_THROW(fmtals::import_project(_stream, _proj, _ver, _options));
+    EXPECT_EQ(_proj.tracks.size(), 20u);
+}
+
+TEST(memory, thread_safe_resources)
+{
+    fmtals::memory_counter _counter;
+    std::pmr::synchronized_pool_resource _synchronized_pool;
+    std::pmr::unsynchronized_pool_resource _unsynchronized_pool;
+    std::pmr::monotonic_buffer_resource _monotonic_buffer;
+    EXPECT_TRUE(fmtals::is_thread_safe_resource(std::pmr::new_delete_resource()));
+    EXPECT_TRUE(fmtals::is_thread_safe_resource(&_counter));
+    EXPECT_TRUE(fmtals::is_thread_safe_resource(&_synchronized_pool));
+    EXPECT_FALSE(fmtals::is_thread_safe_resource(&_unsynchronized_pool));
+    EXPECT_FALSE(fmtals::is_thread_safe_resource(&_monotonic_buffer));
+    _counter.upstream = &_monotonic_buffer;
+    EXPECT_FALSE(fmtals::is_thread_safe_resource(&_counter));
+}
@@ -0,0 +1,68 @@
+#include <fmtals/plugin.hpp>
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(plugin, state_round_trip)
+{
+    std::mt19937 _random(7);
+    std::uniform_int_distribution<int> _byte(0, 255);
+    // Sizes around the vector width and the line length of the encoder
+    for (const std::size_t _size : { 0, 1, 15, 16, 17, 31, 32, 33, 39, 40, 41, 80, 1000 }) {
+        std::vector<std::uint8_t> _state(_size);
+        for (std::uint8_t& _value : _state) {
+            _value = static_cast<std::uint8_t>(_byte(_random));
+        }
+        std::pmr::string _text;
+        fmtals::encode_plugin_state(_state.data(), _state.size(), _text);
+        EXPECT_EQ(_text.size(), _size * 2 + (_size + 39) / 40);
+        std::vector<std::uint8_t> _decoded { 1, 2, 3 };
+        fmtals::decode_plugin_state(_text, _decoded);
+        EXPECT_EQ(_decoded, _state) << _size << " bytes";
+    }
+}
+
+TEST(plugin, state_encoding)
+{
+    const std::vector<std::uint8_t> _state { 0x00, 0x0f, 0xa5, 0xff };
+    std::pmr::string _text;
+    fmtals::encode_plugin_state(_state.data(), _state.size(), _text);
+    EXPECT_EQ(_text, "\n000FA5FF");
+
+    const std::vector<std::uint8_t> _line(41, 0xab);
+    fmtals::encode_plugin_state(_line.data(), _line.size(), _text);
+    std::string _expected = "\n";
+    for (int _index = 0; _index < 40; ++_index) {
+        _expected += "AB";
+    }
+    EXPECT_EQ(std::string_view(_text), _expected + "\nAB");
+}
+
+TEST(plugin, state_decoding_skips_whitespace)
+{
+    std::vector<std::uint8_t> _state;
+    fmtals::decode_plugin_state("\n\t\t\t\t\t\t0001ab Cd\r\n\t\t\t\t\t\tEF", _state);
+    EXPECT_EQ(_state, (std::vector<std::uint8_t> { 0x00, 0x01, 0xab, 0xcd, 0xef }));
+    fmtals::decode_plugin_state(std::string(64, '7') + " \n" + std::string(30, 'f'), _state);
+    std::vector<std::uint8_t> _expected(32, 0x77);
+    _expected.insert(_expected.end(), 15, 0xff);
+    EXPECT_EQ(_state, _expected);
+    fmtals::decode_plugin_state("  \n ", _state);
+    EXPECT_TRUE(_state.empty());
+}
+
+TEST(plugin, state_decoding_rejects_invalid_text)
+{
+    std::vector<std::uint8_t> _state;
+    EXPECT_THROW(fmtals::decode_plugin_state("ABC", _state), std::runtime_error);
+    EXPECT_THROW(fmtals::decode_plugin_state("AB\nC", _state), std::runtime_error);
+    EXPECT_THROW(fmtals::decode_plugin_state("ABCG", _state), std::runtime_error);
+    EXPECT_THROW(fmtals::decode_plugin_state(std::string(40, '0') + "x" + std::string(41, '0'), _state), std::runtime_error);
+    EXPECT_THROW(fmtals::decode_plugin_state(std::string(63, '1') + "-", _state), std::runtime_error);
+}
@@ -0,0 +1,111 @@
+#include <fmtals/search.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+/// @brief Writes the set of a test project to a file
+/// @param path
+/// @param track_count
+/// @param scene_count
+static void write_test_set(const std::filesystem::path& path, const std::size_t track_count, const std::size_t scene_count)
+{
+    std::ofstream _stream(path, std::ios::binary);
+    _stream << export_test_set(make_test_project(track_count, scene_count));
+}
+
+static std::vector<std::string> find_search_paths(const fmtals::search_index& index, const fmtals::search_field field, const std::string_view term, const bool prefix = false)
+{
+    std::vector<std::size_t> _set_indices;
+    if (prefix) {
+        fmtals::find_search_sets_by_prefix(index, field, term, _set_indices);
+    } else {
+        fmtals::find_search_sets(index, field, term, _set_indices);
+    }
+    std::vector<std::string> _paths;
+    for (const std::size_t _set_index : _set_indices) {
+        _paths.emplace_back(std::filesystem::path(fmtals::get_search_set(index, _set_index).path).filename().string());
+    }
+    return _paths;
+}
+
+struct search : testing::Test {
+    std::filesystem::path directory = get_test_directory();
+    std::filesystem::path index_path = directory / "index";
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+};
+
+TEST_F(search, index_round_trip)
+{
+    write_test_set(directory / "a.als", 2, 1);
+    write_test_set(directory / "b.als", 4, 2);
+    const fmtals::search_update _update = fmtals::update_search_index(index_path, { directory / "b.als", directory / "a.als", directory / "missing.als" }, 2);
+    EXPECT_EQ(_update.indexed, 2u);
+    EXPECT_EQ(_update.reused, 0u);
+    EXPECT_EQ(_update.removed, 0u);
+    ASSERT_EQ(_update.failed.size(), 1u);
+    EXPECT_EQ(_update.failed[0].first, directory / "missing.als");
+
+    fmtals::search_index _index;
+    fmtals::open_search_index(index_path, _index);
+    ASSERT_EQ(fmtals::search_set_count(_index), 2u);
+    const fmtals::search_set _set = fmtals::get_search_set(_index, 0);
+    EXPECT_EQ(std::filesystem::path(_set.path), directory / "a.als");
+    EXPECT_EQ(_set.size, std::filesystem::file_size(directory / "a.als"));
+    EXPECT_EQ(find_search_paths(_index, fmtals::search_field::track, "MIDI 3"), (std::vector<std::string> { "b.als" }));
+    EXPECT_EQ(find_search_paths(_index, fmtals::search_field::track, "Audio 0"), (std::vector<std::string> { "a.als", "b.als" }));
+    EXPECT_EQ(find_search_paths(_index, fmtals::search_field::scene, "Scene 1"), (std::vector<std::string> { "b.als" }));
+    EXPECT_EQ(find_search_paths(_index, fmtals::search_field::track, "MIDI", true), (std::vector<std::string> { "a.als", "b.als" }));
+    EXPECT_EQ(find_search_paths(_index, fmtals::search_field::version, "12", true), (std::vector<std::string> { "a.als", "b.als" }));
+    EXPECT_TRUE(find_search_paths(_index, fmtals::search_field::track, "Audio").empty());
+    EXPECT_TRUE(find_search_paths(_index, fmtals::search_field::scene, "MIDI 1").empty());
+}
+
+TEST_F(search, update_reads_only_changed_sets)
+{
+    write_test_set(directory / "a.als", 2, 1);
+    write_test_set(directory / "b.als", 4, 2);
+    fmtals::update_search_index(index_path, { directory / "a.als", directory / "b.als" });
+
+    // A set rewritten with the same content is reused from its hash
+    write_test_set(directory / "a.als", 2, 1);
+    std::filesystem::last_write_time(directory / "a.als", std::filesystem::last_write_time(directory / "a.als") + std::chrono::hours(1));
+    write_test_set(directory / "b.als", 6, 2);
+    write_test_set(directory / "c.als", 3, 3);
+    fmtals::search_update _update = fmtals::update_search_index(index_path, { directory / "a.als", directory / "b.als", directory / "c.als" });
+    EXPECT_EQ(_update.indexed, 2u);
+    EXPECT_EQ(_update.reused, 1u);
+    EXPECT_EQ(_update.removed, 0u);
+    EXPECT_TRUE(_update.failed.empty());
+
+    fmtals::search_index _index;
+    fmtals::open_search_index(index_path, _index);
+    EXPECT_EQ(find_search_paths(_index, fmtals::search_field::track, "MIDI 5"), (std::vector<std::string> { "b.als" }));
+    EXPECT_EQ(find_search_paths(_index, fmtals::search_field::scene, "Scene 2"), (std::vector<std::string> { "c.als" }));
+    EXPECT_EQ(find_search_paths(_index, fmtals::search_field::track, "Audio 2"), (std::vector<std::string> { "b.als", "c.als" }));
+
+    _index = fmtals::search_index();
+    _update = fmtals::update_search_index(index_path, { directory / "c.als", directory / "b.als" });
+    EXPECT_EQ(_update.indexed, 0u);
+    EXPECT_EQ(_update.reused, 2u);
+    EXPECT_EQ(_update.removed, 1u);
+    fmtals::open_search_index(index_path, _index);
+    EXPECT_EQ(fmtals::search_set_count(_index), 2u);
+    EXPECT_EQ(find_search_paths(_index, fmtals::search_field::track, "Audio 0"), (std::vector<std::string> { "b.als", "c.als" }));
+}
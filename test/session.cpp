@@ -0,0 +1,124 @@
+#include <fmtals/session.hpp>
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+/// @brief Builds a project with an audio, a MIDI and a group track over four scenes. The audio
+/// and MIDI tracks hold a clip in the first and third scenes, the MIDI track another one in the
+/// second, and the group track holds no clip slot
+static fmtals::project make_session_project()
+{
+    fmtals::project _proj = make_test_project(2, 4);
+    _proj.tracks.emplace_back(fmtals::project::group_track());
+    for (std::size_t _track_index = 0; _track_index < 2; ++_track_index) {
+        fmtals::project::editable_track& _track = std::visit([](fmtals::project::editable_track& _track_visit) -> fmtals::project::editable_track& { return _track_visit; }, _proj.tracks[_track_index]);
+        _track.clip_slots.resize(4);
+        for (const std::size_t _scene_index : { std::size_t(0), std::size_t(2), std::size_t(1) }) {
+            if (_scene_index == 1 && _track_index == 0) {
+                continue;
+            }
+            fmtals::project::clip_slot& _slot = _track.clip_slots[_scene_index];
+            const std::uint32_t _color = static_cast<std::uint32_t>(10 * _track_index + _scene_index + 1);
+            _slot.has_clip = true;
+            _slot.clip_index = static_cast<std::uint32_t>(_track.session_clips.size());
+            _slot.clip_color = _color;
+            _track.session_clips.emplace_back("<MidiClip Id=\"" + std::to_string(_scene_index) + "\" Time=\"0\"><Name Value=\"Clip " + std::to_string(_track_index) + std::to_string(_scene_index) + "\" /><Color Value=\"" + std::to_string(_color) + "\" /></MidiClip>");
+        }
+        _track.clip_slots[3].has_stop = false;
+    }
+    fmtals::migrate_project(_proj, fmtals::version::v_12_0_0);
+    return _proj;
+}
+
+static const fmtals::project::editable_track& get_editable_track(const fmtals::project& proj, const std::size_t track_index)
+{
+    return std::visit([](const fmtals::project::editable_track& _track_visit) -> const fmtals::project::editable_track& { return _track_visit; }, proj.tracks[track_index]);
+}
+
+TEST(session, matrix_holds_every_slot)
+{
+    const fmtals::project _proj = make_session_project();
+    fmtals::session_matrix _matrix;
+    fmtals::index_session(_proj, _matrix);
+    EXPECT_EQ(_matrix.track_count, 3u);
+    EXPECT_EQ(_matrix.scene_count, 4u);
+    EXPECT_EQ(_matrix.slot_track_count, 2u);
+    EXPECT_EQ(_matrix.slots.size(), 12u);
+    EXPECT_EQ(_matrix.clip_counts, (std::vector<std::size_t> { 2, 1, 2, 0 }));
+    for (std::size_t _track_index = 0; _track_index < 2; ++_track_index) {
+        const fmtals::project::editable_track& _track = get_editable_track(_proj, _track_index);
+        for (std::size_t _scene_index = 0; _scene_index < 4; ++_scene_index) {
+            const fmtals::project::clip_slot& _clip_slot = _track.clip_slots[_scene_index];
+            const fmtals::session_slot* _slot = fmtals::find_session_slot(_matrix, _track_index, _scene_index);
+            ASSERT_NE(_slot, nullptr);
+            EXPECT_EQ(_slot->has_clip, _clip_slot.has_clip);
+            EXPECT_EQ(_slot->has_stop, _clip_slot.has_stop);
+            EXPECT_EQ(_slot->clip_index, _clip_slot.has_clip ? _clip_slot.clip_index : 0u);
+            EXPECT_EQ(_slot->color, _clip_slot.clip_color.value_or(0));
+        }
+    }
+    const fmtals::session_slot* _group_slot = fmtals::find_session_slot(_matrix, 2, 0);
+    ASSERT_NE(_group_slot, nullptr);
+    EXPECT_FALSE(_group_slot->has_clip);
+    EXPECT_FALSE(_group_slot->has_stop);
+    EXPECT_EQ(fmtals::find_session_slot(_matrix, 3, 0), nullptr);
+    EXPECT_EQ(fmtals::find_session_slot(_matrix, 0, 4), nullptr);
+}
+
+TEST(session, full_scenes_ignore_tracks_without_slots)
+{
+    fmtals::project _proj = make_session_project();
+    fmtals::session_matrix _matrix;
+    std::vector<std::size_t> _scene_indices;
+    fmtals::index_session(_proj, _matrix);
+    fmtals::find_full_scenes(_matrix, _scene_indices);
+    EXPECT_EQ(_scene_indices, (std::vector<std::size_t> { 0, 2 }));
+
+    std::get<fmtals::project::audio_track>(_proj.tracks[0]).clip_slots.resize(2);
+    fmtals::index_session(_proj, _matrix);
+    fmtals::find_full_scenes(_matrix, _scene_indices);
+    EXPECT_EQ(_scene_indices, (std::vector<std::size_t> { 0 }));
+
+    fmtals::index_session(make_test_project(2, 3), _matrix);
+    fmtals::find_full_scenes(_matrix, _scene_indices);
+    EXPECT_TRUE(_scene_indices.empty());
+}
+
+TEST(session, clips_round_trip_into_their_slots)
+{
+    fmtals::project _proj = make_session_project();
+    fmtals::project _imported;
+    import_test_set(export_test_set(_proj), _imported);
+    ASSERT_EQ(_imported.tracks.size(), 3u);
+    for (std::size_t _track_index = 0; _track_index < 2; ++_track_index) {
+        const fmtals::project::editable_track& _track = get_editable_track(_proj, _track_index);
+        const fmtals::project::editable_track& _imported_track = get_editable_track(_imported, _track_index);
+        ASSERT_EQ(_imported_track.clip_slots.size(), 4u);
+        ASSERT_EQ(_imported_track.session_clips.size(), _track.session_clips.size());
+        for (std::size_t _scene_index = 0; _scene_index < 4; ++_scene_index) {
+            const fmtals::project::clip_slot& _slot = _track.clip_slots[_scene_index];
+            const fmtals::project::clip_slot& _imported_slot = _imported_track.clip_slots[_scene_index];
+            EXPECT_EQ(_imported_slot.has_clip, _slot.has_clip);
+            EXPECT_EQ(_imported_slot.has_stop, _slot.has_stop);
+            EXPECT_EQ(_imported_slot.clip_color, _slot.clip_color);
+            if (_slot.has_clip) {
+                const std::string _name = "Clip " + std::to_string(_track_index) + std::to_string(_scene_index);
+                EXPECT_NE(_imported_track.session_clips[_imported_slot.clip_index].find(_name), std::pmr::string::npos);
+            }
+        }
+    }
+
+    // A color changed on the slot is written into the clip
+    std::get<fmtals::project::midi_track>(_imported.tracks[1]).clip_slots[1].clip_color = 42;
+    fmtals::project _reimported;
+    import_test_set(export_test_set(_imported), _reimported);
+    const fmtals::project::midi_track& _track = std::get<fmtals::project::midi_track>(_reimported.tracks[1]);
+    EXPECT_EQ(_track.clip_slots[1].clip_color, 42u);
+    EXPECT_NE(_track.session_clips[_track.clip_slots[1].clip_index].find("42"), std::pmr::string::npos);
+    EXPECT_EQ(std::get<fmtals::project::audio_track>(_reimported.tracks[0]).session_clips, std::get<fmtals::project::audio_track>(_imported.tracks[0]).session_clips);
+}
@@ -0,0 +1,84 @@
+#include <fmtals/snapshot.hpp>
+
+#include <sstream>
+#include <string>
+#include <variant>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+static std::string export_test_snapshot(const fmtals::project_snapshot& snapshot)
+{
+    std::stringstream _stream;
+    fmtals::export_project_snapshot(_stream, snapshot, fmtals::version::v_12_0_0);
+    return _stream.str();
+}
+
+static const fmtals::project::editable_track& get_editable_track(const fmtals::project::user_track& track)
+{
+    return std::visit([](const fmtals::project::editable_track& _track_visit) -> const fmtals::project::editable_track& { return _track_visit; }, track);
+}
+
+TEST(snapshot, load_rebuilds_the_project)
+{
+    const fmtals::project _proj = make_test_project(6, 3);
+    fmtals::project_snapshot _snapshot;
+    fmtals::make_project_snapshot(_proj, _snapshot);
+    ASSERT_EQ(_snapshot.tracks.size(), 6u);
+    EXPECT_EQ(_snapshot.scenes.size(), 3u);
+    for (const fmtals::snapshot_track<fmtals::project::user_track>& _track : _snapshot.tracks) {
+        EXPECT_TRUE(get_editable_track(*_track.header).automation_lanes.empty());
+        EXPECT_EQ(_track.device_chain->automation_lanes.size(), 2u);
+    }
+    EXPECT_EQ(export_test_snapshot(_snapshot), export_test_set(_proj));
+
+    fmtals::project _loaded = make_test_project(1, 1);
+    fmtals::load_project_snapshot(_snapshot, _loaded);
+    EXPECT_EQ(export_test_set(_loaded), export_test_set(_proj));
+}
+
+TEST(snapshot, edits_share_unchanged_nodes)
+{
+    fmtals::project_snapshot _original;
+    fmtals::make_project_snapshot(make_test_project(6, 3), _original);
+    const std::string _original_set = export_test_snapshot(_original);
+
+    fmtals::project_snapshot _renamed = _original;
+    fmtals::edit_snapshot_node(_renamed.tracks[2].header, [](fmtals::project::user_track& _track) {
+        std::visit([](fmtals::project::editable_track& _track_visit) { _track_visit.effective_name = fmtals::make_atom("Renamed"); }, _track);
+    });
+    fmtals::project_snapshot _edited = _renamed;
+    fmtals::edit_snapshot_node(_edited.tracks[3].device_chain, [](fmtals::project::device_chain& _device_chain) {
+        _device_chain.automation_lanes.resize(5);
+    });
+    fmtals::edit_snapshot_node(_edited.scenes[1], [](fmtals::project::scene& _scene) {
+        _scene.value = "Edited";
+    });
+
+    EXPECT_EQ(_renamed.settings, _original.settings);
+    EXPECT_NE(_renamed.tracks[2].header, _original.tracks[2].header);
+    EXPECT_EQ(_renamed.tracks[2].device_chain, _original.tracks[2].device_chain);
+    EXPECT_EQ(_edited.tracks[3].header, _original.tracks[3].header);
+    EXPECT_NE(_edited.tracks[3].device_chain, _original.tracks[3].device_chain);
+    EXPECT_EQ(_edited.tracks[2].header, _renamed.tracks[2].header);
+    for (const std::size_t _track_index : { 0, 1, 4, 5 }) {
+        EXPECT_EQ(_edited.tracks[_track_index].header, _original.tracks[_track_index].header);
+        EXPECT_EQ(_edited.tracks[_track_index].device_chain, _original.tracks[_track_index].device_chain);
+    }
+    EXPECT_EQ(_edited.scenes[0], _original.scenes[0]);
+    EXPECT_NE(_edited.scenes[1], _original.scenes[1]);
+    EXPECT_EQ(_edited.master_track.header, _original.master_track.header);
+
+    // Earlier snapshots never observe a later edit
+    EXPECT_EQ(export_test_snapshot(_original), _original_set);
+    fmtals::project _proj;
+    fmtals::load_project_snapshot(_renamed, _proj);
+    EXPECT_EQ(fmtals::atom_string(get_editable_track(_proj.tracks[2]).effective_name), "Renamed");
+    EXPECT_EQ(get_editable_track(_proj.tracks[3]).automation_lanes.size(), 2u);
+    EXPECT_EQ(_proj.scene_names[1].value, "Scene 1");
+    fmtals::load_project_snapshot(_edited, _proj);
+    EXPECT_EQ(fmtals::atom_string(get_editable_track(_proj.tracks[2]).effective_name), "Renamed");
+    EXPECT_EQ(get_editable_track(_proj.tracks[3]).automation_lanes.size(), 5u);
+    EXPECT_EQ(_proj.scene_names[1].value, "Edited");
+}
@@ -0,0 +1,122 @@
+#include <fmtals/diff.hpp>
+#include <fmtals/store.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+/// @brief Lists the chunk files of a store
+static std::vector<std::filesystem::path> list_test_chunks(const std::filesystem::path& directory)
+{
+    std::vector<std::filesystem::path> _chunks;
+    for (const std::filesystem::directory_entry& _entry : std::filesystem::recursive_directory_iterator(directory / "chunks")) {
+        if (_entry.is_regular_file()) {
+            _chunks.emplace_back(_entry.path());
+        }
+    }
+    return _chunks;
+}
+
+struct store : testing::Test {
+    std::filesystem::path directory = get_test_directory();
+
+    void SetUp() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+};
+
+TEST_F(store, revision_round_trip)
+{
+    for (const fmtals::version _ver : { fmtals::version::v_9_7_7, fmtals::version::v_11_0_0, fmtals::version::v_12_0_0 }) {
+        fmtals::project _proj = make_test_project(5, 3, _ver);
+        std::get<fmtals::project::audio_track>(_proj.tracks[2]).events_audio_clips.resize(2);
+        std::get<fmtals::project::audio_track>(_proj.tracks[2]).events_audio_clips[1].time = 8.5;
+        fmtals::migrate_project(_proj, _ver);
+        const std::string _revision = fmtals::store_project(directory, _proj, _ver);
+        EXPECT_EQ(_revision.size(), 16u);
+        EXPECT_EQ(fmtals::store_project(directory, _proj, _ver), _revision);
+
+        fmtals::project _loaded = make_test_project(1, 1);
+        fmtals::version _loaded_ver;
+        fmtals::load_stored_project(directory, _revision, _loaded, _loaded_ver);
+        EXPECT_EQ(_loaded_ver, _ver);
+        EXPECT_TRUE(fmtals::diff(_proj, _loaded).empty());
+        std::stringstream _stream;
+        fmtals::export_stored_project(_stream, directory, _revision, _ver);
+        EXPECT_EQ(_stream.str(), export_test_set(_proj, _ver));
+    }
+    EXPECT_EQ(fmtals::list_stored_projects(directory).size(), 3u);
+}
+
+TEST_F(store, revisions_share_the_chunks_of_unchanged_tracks)
+{
+    const fmtals::project _proj = make_test_project(8, 2);
+    const std::string _first = fmtals::store_project(directory, _proj, fmtals::version::v_12_0_0);
+    const std::size_t _first_chunk_count = list_test_chunks(directory).size();
+
+    // a renamed track only adds its header, a new scene the scene list
+    fmtals::project _edited = _proj;
+    std::visit([](fmtals::project::editable_track& _track_visit) { _track_visit.effective_name = fmtals::make_atom("Renamed"); }, _edited.tracks[3]);
+    _edited.scene_names.emplace_back().value = "Scene 2";
+    const std::string _second = fmtals::store_project(directory, _edited, fmtals::version::v_12_0_0);
+    EXPECT_NE(_second, _first);
+    EXPECT_EQ(list_test_chunks(directory).size(), _first_chunk_count + 2);
+    std::vector<std::string> _revisions { _first, _second };
+    std::sort(_revisions.begin(), _revisions.end());
+    EXPECT_EQ(fmtals::list_stored_projects(directory), _revisions);
+
+    fmtals::project _loaded;
+    fmtals::version _ver;
+    fmtals::load_stored_project(directory, _first, _loaded, _ver);
+    EXPECT_TRUE(fmtals::diff(_proj, _loaded).empty());
+    fmtals::load_stored_project(directory, _second, _loaded, _ver);
+    EXPECT_TRUE(fmtals::diff(_edited, _loaded).empty());
+}
+
+TEST_F(store, different_content_under_an_existing_hash_is_a_collision)
+{
+    const fmtals::project _proj = make_test_project(2, 1);
+    fmtals::store_project(directory, _proj, fmtals::version::v_12_0_0);
+    for (const std::filesystem::path& _chunk : list_test_chunks(directory)) {
+        const std::size_t _size = static_cast<std::size_t>(std::filesystem::file_size(_chunk));
+        std::ofstream(_chunk, std::ios::binary | std::ios::trunc) << std::string(_size, 'x');
+    }
+    EXPECT_THROW(fmtals::store_project(directory, _proj, fmtals::version::v_12_0_0), std::runtime_error);
+
+    // a shorter or longer content is a collision as well
+    const std::filesystem::path _chunk = list_test_chunks(directory)[0];
+    std::filesystem::resize_file(_chunk, 1);
+    EXPECT_THROW(fmtals::store_project(directory, _proj, fmtals::version::v_12_0_0), std::runtime_error);
+    std::filesystem::resize_file(_chunk, 100000);
+    EXPECT_THROW(fmtals::store_project(directory, _proj, fmtals::version::v_12_0_0), std::runtime_error);
+}
+
+TEST_F(store, load_rejects_invalid_revisions)
+{
+    const std::string _revision = fmtals::store_project(directory, make_test_project(2, 1), fmtals::version::v_12_0_0);
+    fmtals::project _proj;
+    fmtals::version _ver;
+    for (const std::string& _invalid : { std::string(), std::string("../revisions/") + _revision.substr(3), _revision.substr(1), _revision + "0", std::string(16, 'G'), std::string(16, 'A') }) {
+        EXPECT_THROW(fmtals::load_stored_project(directory, _invalid, _proj, _ver), std::runtime_error) << _invalid;
+    }
+    EXPECT_THROW(fmtals::load_stored_project(directory, std::string(16, '0'), _proj, _ver), std::runtime_error);
+
+    // temporaries left in the revisions are not listed
+    std::ofstream(directory / "revisions" / (_revision + ".tmp1"), std::ios::binary) << "x";
+    EXPECT_EQ(fmtals::list_stored_projects(directory), (std::vector<std::string> { _revision }));
+}
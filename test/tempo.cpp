@@ -0,0 +1,104 @@
+#include <fmtals/tempo.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+/// @brief Builds a project whose master track tempo is automated with events of beat and tempo
+/// @param events
+static fmtals::project make_tempo_project(const std::vector<std::pair<double, float>>& events)
+{
+    fmtals::project _proj;
+    _proj.project_master_track.tempo = 120;
+    _proj.project_master_track.tempo_automation_target_id = 8;
+    fmtals::project::automation_envelope& _envelope = _proj.project_master_track.automation_envelopes.emplace_back();
+    _envelope.pointee_id = 8;
+    for (const std::pair<double, float>& _event : events) {
+        _envelope.events.push_back({ 0, _event.first, _event.second });
+    }
+    return _proj;
+}
+
+/// @brief Integrates 60 / tempo over beats with Simpson's rule, tempo being linear from tempo_begin
+/// to tempo_end over the range
+static double integrate_seconds(const double beats, const double tempo_begin, const double tempo_end)
+{
+    const std::size_t _steps = 1000;
+    const double _step = beats / _steps;
+    double _sum = 0;
+    for (std::size_t _index = 0; _index <= _steps; ++_index) {
+        const double _tempo = tempo_begin + (tempo_end - tempo_begin) * _index / _steps;
+        const double _weight = _index == 0 || _index == _steps ? 1 : (_index % 2 ? 4 : 2);
+        _sum += _weight * 60 / _tempo;
+    }
+    return _sum * _step / 3;
+}
+
+TEST(tempo, constant_tempo_without_envelope)
+{
+    fmtals::project _proj;
+    _proj.project_master_track.tempo = 120;
+    fmtals::tempo_map _map;
+    fmtals::build_tempo_map(_proj, _map);
+    ASSERT_EQ(_map.segments.size(), 1u);
+    EXPECT_DOUBLE_EQ(fmtals::beats_to_seconds(_map, 8), 4);
+    EXPECT_DOUBLE_EQ(fmtals::seconds_to_beats(_map, 4), 8);
+    EXPECT_DOUBLE_EQ(fmtals::beats_to_seconds(_map, -2), -1);
+}
+
+TEST(tempo, ramp_matches_closed_form)
+{
+    // 120 to 240 beats per minute over 4 beats, then constant
+    fmtals::tempo_map _map;
+    fmtals::build_tempo_map(make_tempo_project({ { 0, 120 }, { 4, 240 } }), _map);
+    const double _ramp_seconds = 60.0 / 30.0 * std::log(2.0);
+    EXPECT_NEAR(fmtals::beats_to_seconds(_map, 4), _ramp_seconds, 1e-12);
+    EXPECT_NEAR(fmtals::beats_to_seconds(_map, 8), _ramp_seconds + 1, 1e-12);
+    EXPECT_NEAR(fmtals::beats_to_seconds(_map, 2), integrate_seconds(2, 120, 180), 1e-9);
+    for (const double _beat : { -3.0, 0.0, 0.5, 2.0, 3.999, 4.0, 17.25 }) {
+        EXPECT_NEAR(fmtals::seconds_to_beats(_map, fmtals::beats_to_seconds(_map, _beat)), _beat, 1e-9);
+    }
+}
+
+TEST(tempo, step_and_events_before_origin)
+{
+    // Live writes the first event far before the arrangement, seconds still start at beat 0
+    fmtals::tempo_map _map;
+    fmtals::build_tempo_map(make_tempo_project({ { -63072000, 100 }, { 8, 100 }, { 8, 200 }, { 16, 200 } }), _map);
+    EXPECT_DOUBLE_EQ(fmtals::beats_to_seconds(_map, 0), 0);
+    EXPECT_NEAR(fmtals::beats_to_seconds(_map, 8), 4.8, 1e-9);
+    EXPECT_NEAR(fmtals::beats_to_seconds(_map, 12), 4.8 + 1.2, 1e-9);
+    EXPECT_NEAR(fmtals::seconds_to_beats(_map, 6), 12, 1e-9);
+    EXPECT_NEAR(fmtals::beats_to_seconds(_map, 32), 4.8 + 7.2, 1e-9);
+}
+
+TEST(tempo, vector_overloads_match_scalar)
+{
+    fmtals::tempo_map _map;
+    fmtals::build_tempo_map(make_tempo_project({ { 0, 90 }, { 4, 150 }, { 12, 150 }, { 20, 60 } }), _map);
+    const std::vector<double> _beats = { 30, -1, 0, 2, 4, 7, 12, 15, 20, 25, 3 };
+    std::vector<double> _seconds;
+    fmtals::beats_to_seconds(_map, _beats, _seconds);
+    ASSERT_EQ(_seconds.size(), _beats.size());
+    for (std::size_t _index = 0; _index < _beats.size(); ++_index) {
+        EXPECT_DOUBLE_EQ(_seconds[_index], fmtals::beats_to_seconds(_map, _beats[_index]));
+    }
+    std::vector<double> _round_trip;
+    fmtals::seconds_to_beats(_map, _seconds, _round_trip);
+    for (std::size_t _index = 0; _index < _beats.size(); ++_index) {
+        EXPECT_NEAR(_round_trip[_index], _beats[_index], 1e-9);
+    }
+}
+
+TEST(tempo, invalid_maps_throw)
+{
+    fmtals::tempo_map _map;
+    EXPECT_THROW(fmtals::build_tempo_map(make_tempo_project({ { 0, 120 }, { 4, 0 } }), _map), std::runtime_error);
+    fmtals::project _proj;
+    EXPECT_THROW(fmtals::build_tempo_map(_proj, _map), std::runtime_error);
+    _map.segments.clear();
+    EXPECT_THROW(fmtals::beats_to_seconds(_map, 1), std::runtime_error);
+    EXPECT_THROW(fmtals::seconds_to_beats(_map, 1), std::runtime_error);
+}
@@ -0,0 +1,197 @@
+#include <fmtals/timeline.hpp>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+/// @brief Builds a project of audio tracks, with a MIDI track in between, whose clips start on
+/// whole beats and may overlap
+/// @param generator
+static fmtals::project make_timeline_project(std::mt19937& generator)
+{
+    std::uniform_int_distribution<std::uint32_t> _time(0, 200);
+    std::uniform_int_distribution<int> _length(0, 24);
+    fmtals::project _proj;
+    for (std::size_t _track_index = 0; _track_index < 6; ++_track_index) {
+        if (_track_index == 2) {
+            _proj.tracks.emplace_back(fmtals::project::midi_track());
+            continue;
+        }
+        fmtals::project::audio_track _track;
+        _track.events_audio_clips.resize(10 + 7 * _track_index);
+        for (fmtals::project::audio_clip& _clip : _track.events_audio_clips) {
+            _clip.time = _time(generator);
+            _clip.current_start = 4;
+            _clip.current_end = 4 + static_cast<float>(_length(generator)) / 2;
+        }
+        _proj.tracks.emplace_back(std::move(_track));
+    }
+    return _proj;
+}
+
+/// @brief Retrieves the track and clip indices of the clips overlapping [start, end) by checking
+/// every clip, or playing at start when end is not greater than start
+static std::vector<std::pair<std::size_t, std::size_t>> find_clips_by_scan(const fmtals::project& proj, const double start, const double end)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> _found;
+    for (std::size_t _track_index = 0; _track_index < proj.tracks.size(); ++_track_index) {
+        const fmtals::project::audio_track* _track = std::get_if<fmtals::project::audio_track>(&proj.tracks[_track_index]);
+        for (std::size_t _clip_index = 0; _track && _clip_index < _track->events_audio_clips.size(); ++_clip_index) {
+            const fmtals::project::audio_clip& _clip = _track->events_audio_clips[_clip_index];
+            const double _clip_start = _clip.time;
+            const double _clip_end = _clip_start + (_clip.current_end - _clip.current_start);
+            const bool _found_clip = end > start ? _clip_start < end && start < _clip_end : _clip_start <= start && start < _clip_end;
+            if (_found_clip) {
+                _found.emplace_back(_track_index, _clip_index);
+            }
+        }
+    }
+    return _found;
+}
+
+/// @brief Checks the clips found by the index against a scan of the project, and that they are
+/// sorted by start
+static void expect_same_clips(const std::vector<fmtals::timeline_clip>& clips, std::vector<std::pair<std::size_t, std::size_t>> expected)
+{
+    EXPECT_TRUE(std::is_sorted(clips.begin(), clips.end(), [](const fmtals::timeline_clip& lhs, const fmtals::timeline_clip& rhs) { return lhs.start < rhs.start; }));
+    std::vector<std::pair<std::size_t, std::size_t>> _found;
+    for (const fmtals::timeline_clip& _clip : clips) {
+        _found.emplace_back(_clip.track_index, _clip.clip_index);
+    }
+    std::sort(_found.begin(), _found.end());
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(_found, expected);
+}
+
+static void expect_index_matches_scan(const fmtals::timeline_index& index, const fmtals::project& proj)
+{
+    std::vector<fmtals::timeline_clip> _clips;
+    for (double _time = -2; _time < 240; _time += 1.25) {
+        fmtals::find_timeline_clips(index, _time, _clips);
+        expect_same_clips(_clips, find_clips_by_scan(proj, _time, _time));
+        fmtals::find_timeline_clips(index, _time, _time + 9.5, _clips);
+        expect_same_clips(_clips, find_clips_by_scan(proj, _time, _time + 9.5));
+    }
+}
+
+TEST(timeline, stab_and_range_queries_match_scan)
+{
+    std::mt19937 _generator(7);
+    const fmtals::project _proj = make_timeline_project(_generator);
+    fmtals::timeline_index _index;
+    fmtals::index_timeline(_proj, _index);
+    ASSERT_EQ(_index.track_offsets.size(), _proj.tracks.size() + 1);
+    EXPECT_EQ(_index.track_offsets[3] - _index.track_offsets[2], 0u);
+    expect_index_matches_scan(_index, _proj);
+}
+
+TEST(timeline, queries_after_moving_clips)
+{
+    std::mt19937 _generator(11);
+    fmtals::project _proj = make_timeline_project(_generator);
+    fmtals::timeline_index _index;
+    fmtals::index_timeline(_proj, _index);
+    std::uniform_int_distribution<std::size_t> _track_index(0, _proj.tracks.size() - 1);
+    std::uniform_int_distribution<std::uint32_t> _time(0, 220);
+    std::uniform_int_distribution<int> _length(0, 40);
+    for (std::size_t _move = 0; _move < 60; ++_move) {
+        const std::size_t _moved_track = _track_index(_generator);
+        fmtals::project::audio_track* _track = std::get_if<fmtals::project::audio_track>(&_proj.tracks[_moved_track]);
+        if (!_track) {
+            continue;
+        }
+        const std::size_t _moved_clip = std::uniform_int_distribution<std::size_t>(0, _track->events_audio_clips.size() - 1)(_generator);
+        fmtals::project::audio_clip& _clip = _track->events_audio_clips[_moved_clip];
+        _clip.time = _time(_generator);
+        _clip.current_end = _clip.current_start + static_cast<float>(_length(_generator)) / 2;
+        fmtals::move_timeline_clip(_index, _proj, _moved_track, _moved_clip);
+    }
+    expect_index_matches_scan(_index, _proj);
+
+    fmtals::timeline_index _rebuilt;
+    fmtals::index_timeline(_proj, _rebuilt);
+    std::vector<fmtals::timeline_clip> _moved_clips;
+    std::vector<fmtals::timeline_clip> _rebuilt_clips;
+    fmtals::find_timeline_clips(_index, 0, 300, _moved_clips);
+    fmtals::find_timeline_clips(_rebuilt, 0, 300, _rebuilt_clips);
+    EXPECT_EQ(_moved_clips.size(), _rebuilt_clips.size());
+    EXPECT_EQ(_index.max_level, _rebuilt.max_level);
+}
+
+TEST(timeline, empty_project_and_zero_length_clips)
+{
+    fmtals::project _proj;
+    fmtals::timeline_index _index;
+    fmtals::index_timeline(_proj, _index);
+    std::vector<fmtals::timeline_clip> _clips;
+    fmtals::find_timeline_clips(_index, 0, _clips);
+    EXPECT_TRUE(_clips.empty());
+
+    fmtals::project::audio_track _track;
+    _track.events_audio_clips.resize(2);
+    _track.events_audio_clips[0].time = 8;
+    _track.events_audio_clips[1].time = 8;
+    _track.events_audio_clips[1].current_end = 4;
+    _proj.tracks.emplace_back(std::move(_track));
+    fmtals::index_timeline(_proj, _index);
+    fmtals::find_timeline_clips(_index, 8, _clips);
+    ASSERT_EQ(_clips.size(), 1u);
+    EXPECT_EQ(_clips[0].clip_index, 1u);
+    fmtals::find_timeline_clips(_index, 12, _clips);
+    EXPECT_TRUE(_clips.empty());
+}
+
+TEST(timeline, clips_survive_export_and_import)
+{
+    for (const fmtals::version _ver : { fmtals::version::v_9_7_7, fmtals::version::v_11_0_0, fmtals::version::v_12_0_0 }) {
+        fmtals::project _proj = make_test_project(4, 1, _ver);
+        for (const std::size_t _track_index : { 0, 2 }) {
+            fmtals::project::audio_track& _track = std::get<fmtals::project::audio_track>(_proj.tracks[_track_index]);
+            _track.events_audio_clips.resize(3);
+            for (std::size_t _clip_index = 0; _clip_index < 3; ++_clip_index) {
+                fmtals::project::audio_clip& _clip = _track.events_audio_clips[_clip_index];
+                _clip.time = 6.5 * static_cast<double>(_clip_index) + static_cast<double>(_track_index);
+                _clip.current_start = 1;
+                _clip.current_end = 9.25f;
+                _clip.name = "Clip " + std::to_string(_clip_index);
+                _clip.follow_time = 4;
+                _clip.warp_markers.resize(_clip_index);
+                _clip.color = static_cast<std::uint32_t>(_clip_index + 3);
+            }
+        }
+        fmtals::migrate_project(_proj, _ver);
+
+        fmtals::project _imported;
+        EXPECT_EQ(import_test_set(export_test_set(_proj, _ver), _imported), _ver);
+        ASSERT_EQ(_imported.tracks.size(), _proj.tracks.size());
+        for (const std::size_t _track_index : { 0, 2 }) {
+            const fmtals::project::audio_track& _track = std::get<fmtals::project::audio_track>(_proj.tracks[_track_index]);
+            const fmtals::project::audio_track& _imported_track = std::get<fmtals::project::audio_track>(_imported.tracks[_track_index]);
+            ASSERT_EQ(_imported_track.events_audio_clips.size(), 3u);
+            for (std::size_t _clip_index = 0; _clip_index < 3; ++_clip_index) {
+                const fmtals::project::audio_clip& _clip = _track.events_audio_clips[_clip_index];
+                const fmtals::project::audio_clip& _imported_clip = _imported_track.events_audio_clips[_clip_index];
+                EXPECT_EQ(_imported_clip.time, _clip.time);
+                EXPECT_EQ(_imported_clip.current_end, _clip.current_end);
+                EXPECT_EQ(_imported_clip.name, _clip.name);
+                EXPECT_EQ(_imported_clip.follow_time, 4u);
+                EXPECT_EQ(_imported_clip.warp_markers.size(), _clip_index);
+                EXPECT_EQ(_imported_clip.color, _clip.color);
+                EXPECT_EQ(_imported_clip.color_index, _clip.color_index);
+            }
+        }
+
+        fmtals::timeline_index _index;
+        fmtals::index_timeline(_imported, _index);
+        EXPECT_EQ(_index.clips.size(), 6u);
+        expect_index_matches_scan(_index, _imported);
+        std::vector<fmtals::timeline_clip> _clips;
+        fmtals::find_timeline_clips(_index, 8, _clips);
+        expect_same_clips(_clips, { { 0, 0 }, { 0, 1 }, { 2, 0 } });
+    }
+}
@@ -0,0 +1,282 @@
+#include "simd.hpp"
+#include "xml.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common.hpp"
+
+extern void gz_decompress(std::istream& gz_stream, const std::function<void(const char*, std::size_t)>& callback);
+
+/// @brief Exports a project and retrieves the XML text of the set
+/// @param proj
+/// @param ver
+static std::string export_test_xml(const fmtals::project& proj, const fmtals::version ver)
+{
+    std::stringstream _stream(export_test_set(proj, ver));
+    std::string _text;
+    gz_decompress(_stream, [&](const char* chunk, const std::size_t size) {
+        _text.append(chunk, size);
+    });
+    return _text;
+}
+
+static std::string_view node_name(const xml_node* node)
+{
+    return std::string_view(node->name(), node->name_size());
+}
+
+static std::string_view node_value(const xml_node* node)
+{
+    return std::string_view(node->value(), node->value_size());
+}
+
+/// @brief Checks that two trees hold the same nodes with the same names, values and attributes
+static void expect_same_tree(const xml_node* expected, const xml_node* node, const std::string& path = std::string())
+{
+    ASSERT_EQ(node->type(), expected->type()) << path;
+    ASSERT_EQ(node_name(node), node_name(expected)) << path;
+    ASSERT_EQ(node_value(node), node_value(expected)) << path;
+    const std::string _path = path + "/" + std::string(node_name(expected));
+    const xml_attribute* _expected_attribute = expected->first_attribute();
+    const xml_attribute* _attribute = node->first_attribute();
+    for (; _expected_attribute && _attribute; _expected_attribute = _expected_attribute->next_attribute(), _attribute = _attribute->next_attribute()) {
+        ASSERT_EQ(std::string_view(_attribute->name(), _attribute->name_size()), std::string_view(_expected_attribute->name(), _expected_attribute->name_size())) << _path;
+        ASSERT_EQ(std::string_view(_attribute->value(), _attribute->value_size()), std::string_view(_expected_attribute->value(), _expected_attribute->value_size())) << _path;
+    }
+    ASSERT_EQ(_attribute == nullptr, _expected_attribute == nullptr) << _path;
+    const xml_node* _expected_child = expected->first_node();
+    const xml_node* _child = node->first_node();
+    for (; _expected_child && _child; _expected_child = _expected_child->next_sibling(), _child = _child->next_sibling()) {
+        expect_same_tree(_expected_child, _child, _path);
+        if (testing::Test::HasFatalFailure()) {
+            return;
+        }
+    }
+    ASSERT_EQ(_child == nullptr, _expected_child == nullptr) << _path;
+}
+
+/// @brief Parses a text with rapidxml and with xml_parse and checks that both trees are the same
+static void expect_same_parse(const std::string& text)
+{
+    std::vector<char> _expected_text(text.begin(), text.end());
+    _expected_text.push_back('\0');
+    xml_document _expected;
+    _expected.parse<0>(_expected_text.data());
+
+    // the text is not terminated, so that reading past its end is caught by sanitizers
+    std::vector<char> _text(text.begin(), text.end());
+    xml_document _document;
+    xml_parse(_document, _text.data(), _text.size());
+    expect_same_tree(&_expected, &_document);
+}
+
+static const std::string markup_test_text = "\xef\xbb\xbf<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                                            "<!DOCTYPE Ableton [ <!ENTITY unused \"x\"> ]>\n"
+                                            "<!-- comment with <tags> -->\n"
+                                            "<Ableton MajorVersion=\"5\" Creator='Ableton &quot;Live&quot; 12' Empty=\"\">\n"
+                                            "\t<Name Value=\"&lt;a &amp; b&gt; &apos;c&apos; &#65;&#x42;&#xe9; &unknown; x\" />\n"
+                                            "\t<Spaced   Value = \"1\"\t\n/>\n"
+                                            "\t<Text>  some &amp; text <Child/> tail &lt;&gt;  </Text>\n"
+                                            "\t<Data><![CDATA[<raw & data>]]></Data>\n"
+                                            "\t<?processing instruction?>\n"
+                                            "\t<Buffer>\n\t\t" + std::string(100, 'A') + "&amp;" + std::string(37, 'B') + "\n\t</Buffer>\n"
+                                            "\t<Long Value=\"" + std::string(70, 'x') + "&quot;" + std::string(33, 'y') + "\" />\n"
+                                            "</Ableton>\n";
+
+TEST(xml, parse_matches_rapidxml_on_exported_sets)
+{
+    for (const fmtals::version _ver : { fmtals::version::v_9_7_7, fmtals::version::v_11_0_0, fmtals::version::v_12_0_0 }) {
+        fmtals::project _proj = make_test_project(7, 3, _ver);
+        std::get<fmtals::project::audio_track>(_proj.tracks[0]).events_audio_clips.resize(2);
+        std::get<fmtals::project::audio_track>(_proj.tracks[0]).events_audio_clips[1].name = "<Clip> & \"quoted\" 'name'";
+        std::get<fmtals::project::midi_track>(_proj.tracks[1]).effective_name = fmtals::make_atom("Track & <name>");
+        fmtals::migrate_project(_proj, _ver);
+        expect_same_parse(export_test_xml(_proj, _ver));
+    }
+}
+
+TEST(xml, parse_matches_rapidxml_on_markup)
+{
+    expect_same_parse(markup_test_text);
+    expect_same_parse("<A/>");
+    expect_same_parse("<A><B>text</B><B x='1'/></A>");
+
+    std::vector<char> _text(markup_test_text.begin(), markup_test_text.end());
+    xml_document _document;
+    xml_parse(_document, _text.data(), _text.size());
+    const xml_node* _root = _document.first_node("Ableton");
+    ASSERT_NE(_root, nullptr);
+    EXPECT_STREQ(_root->first_attribute("Creator")->value(), "Ableton \"Live\" 12");
+    EXPECT_STREQ(_root->first_node("Name")->first_attribute("Value")->value(), "<a & b> 'c' AB\xc3\xa9 &unknown; x");
+    EXPECT_STREQ(_root->first_node("Data")->first_node()->value(), "<raw & data>");
+    EXPECT_EQ(std::string(_root->first_node("Buffer")->value()).find("A&B"), 102u);
+}
+
+TEST(xml, parse_children_appends_to_a_node)
+{
+    std::string _document_text = "<Root><Value /></Root>";
+    xml_document _document;
+    xml_parse(_document, _document_text.data(), _document_text.size());
+    xml_node* _value = _document.first_node("Root")->first_node("Value");
+    std::string _text = "<First A=\"1\" /><Second>2</Second>";
+    xml_parse_children(_document, _value, _text.data(), _text.size());
+    ASSERT_NE(_value->first_node("First"), nullptr);
+    EXPECT_STREQ(_value->first_node("First")->first_attribute("A")->value(), "1");
+    EXPECT_STREQ(_value->first_node("Second")->value(), "2");
+    EXPECT_EQ(_value->first_node("Second")->next_sibling(), nullptr);
+}
+
+/// @brief Checks that every prefix of a text in [first, last) fails to parse
+static void expect_truncations_throw(const std::string& text, const std::size_t first, const std::size_t last)
+{
+    for (std::size_t _size = first; _size < last; ++_size) {
+        std::vector<char> _text(text.begin(), text.begin() + static_cast<std::ptrdiff_t>(_size));
+        xml_document _document;
+        EXPECT_THROW(xml_parse(_document, _text.data(), _text.size()), std::runtime_error) << "truncated at " << _size << ": " << text.substr(_size > 20 ? _size - 20 : 0, std::min<std::size_t>(_size, 20));
+    }
+}
+
+TEST(xml, truncated_text_throws)
+{
+    // prefixes ending after the byte order mark or between the declarations and the root element
+    // are complete documents
+    const std::size_t _root = markup_test_text.find("<Ableton ");
+    expect_truncations_throw(markup_test_text, 1, 3);
+    expect_truncations_throw(markup_test_text, 4, markup_test_text.find("?>") + 2);
+    expect_truncations_throw(markup_test_text, markup_test_text.find("<!DOCTYPE") + 1, markup_test_text.find("]>") + 2);
+    expect_truncations_throw(markup_test_text, markup_test_text.find("<!--") + 1, markup_test_text.find("-->") + 3);
+    expect_truncations_throw(markup_test_text, _root + 1, markup_test_text.rfind('>') + 1);
+
+    const std::string _set = export_test_xml(make_test_project(1, 1), fmtals::version::v_12_0_0);
+    expect_truncations_throw(_set, _set.find("<Ableton") + 1, _set.rfind('>') + 1);
+}
+
+TEST(xml, invalid_markup_throws)
+{
+    for (std::string _text : { "text", "<A", "<A B>", "<A B=1/>", "<A B=\"1/>", "<A></A", "<A>&#x110000;</A>", "<A>&#12</A>", "< A/>", "<A/", "<!-- A" }) {
+        xml_document _document;
+        EXPECT_THROW(xml_parse(_document, _text.data(), _text.size()), std::runtime_error) << _text;
+    }
+}
+
+TEST(xml, scan_helpers_match_scalar_search)
+{
+    const std::string _blank(80, ' ');
+    for (std::size_t _size = 0; _size <= _blank.size(); ++_size) {
+        for (std::size_t _position = 0; _position <= _size; ++_position) {
+            std::string _text = _blank.substr(0, _size);
+            if (_position < _size) {
+                _text[_position] = _position % 2 ? '<' : '&';
+            }
+            const char* const _begin = _text.data();
+            const char* const _end = _text.data() + _size;
+            EXPECT_EQ((simd_find<'<', '&'>(_begin, _end) - _begin), static_cast<std::ptrdiff_t>(_position));
+            EXPECT_EQ(simd_skip<' '>(_begin, _end) - _begin, static_cast<std::ptrdiff_t>(_position));
+            EXPECT_EQ(simd_find<'>'>(_begin, _end), _end);
+            EXPECT_EQ((simd_skip<' ', '<', '&'>(_begin, _end)), _end);
+        }
+    }
+}
+
+/// @brief Parses a text and prints its document back
+static std::string print_test_xml(const std::string& text, const std::size_t indent = 0)
+{
+    std::vector<char> _text(text.begin(), text.end());
+    xml_document _document;
+    xml_parse(_document, _text.data(), _text.size());
+    std::pmr::string _printed;
+    xml_print(_printed, &_document, indent);
+    return std::string(_printed);
+}
+
+TEST(xml, print_escapes_markup_characters)
+{
+    EXPECT_EQ(print_test_xml("<A B=\"&lt;&gt;&amp;&quot;&apos;\">&lt;x&gt; &amp; &quot;y&apos;</A>"), "<A B=\"&lt;&gt;&amp;&quot;&apos;\">&lt;x&gt; &amp; &quot;y&apos;</A>\n");
+    EXPECT_EQ(print_test_xml("<A B='\"' C=\"'\" />"), "<A B=\"&quot;\" C=\"&apos;\" />\n");
+
+    // Markup characters on each side of the vector width
+    const std::string _characters = "<>&\"'";
+    for (std::size_t _position = 0; _position < 70; ++_position) {
+        std::string _value(70, 'v');
+        _value[_position] = _characters[_position % _characters.size()];
+        std::string _expected = "<A B=\"";
+        for (const char _character : _value) {
+            switch (_character) {
+            case '<':
+                _expected += "&lt;";
+                break;
+            case '>':
+                _expected += "&gt;";
+                break;
+            case '&':
+                _expected += "&amp;";
+                break;
+            case '"':
+                _expected += "&quot;";
+                break;
+            case '\'':
+                _expected += "&apos;";
+                break;
+            default:
+                _expected += _character;
+                break;
+            }
+        }
+        _expected += "\" />\n";
+        EXPECT_EQ(print_test_xml(_expected.substr(0, _expected.size() - 1)), _expected) << _position;
+    }
+}
+
+TEST(xml, print_formats_empty_elements_and_indentation)
+{
+    const std::string _text = "<A><B/><C D=\"1\"></C><E>v</E><F><G/><H>w</H></F></A>";
+    EXPECT_EQ(print_test_xml(_text), "<A>\n\t<B />\n\t<C D=\"1\" />\n\t<E>v</E>\n\t<F>\n\t\t<G />\n\t\t<H>w</H>\n\t</F>\n</A>\n");
+    EXPECT_EQ(print_test_xml(_text, 2), "\t\t<A>\n\t\t\t<B />\n\t\t\t<C D=\"1\" />\n\t\t\t<E>v</E>\n\t\t\t<F>\n\t\t\t\t<G />\n\t\t\t\t<H>w</H>\n\t\t\t</F>\n\t\t</A>\n");
+
+    // The parser skips declarations and comments, the printer writes them
+    std::string _document_text = "<A><![CDATA[d]]></A>";
+    xml_document _document;
+    xml_parse(_document, _document_text.data(), _document_text.size());
+    xml_node* _declaration = _document.allocate_node(cereal::rapidxml::node_declaration);
+    _declaration->append_attribute(_document.allocate_attribute("version", "1.0"));
+    _declaration->append_attribute(_document.allocate_attribute("encoding", "UTF-8"));
+    _document.prepend_node(_declaration);
+    _document.first_node("A")->prepend_node(_document.allocate_node(cereal::rapidxml::node_comment, nullptr, "c"));
+    std::pmr::string _printed;
+    xml_print(_printed, &_document);
+    EXPECT_EQ(std::string_view(_printed), "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<A>\n\t<!--c-->\n\t<![CDATA[d]]>\n</A>\n");
+
+    // Printing appends to the text
+    _printed = "<B>\n";
+    xml_print(_printed, _document.first_node("A")->first_node(), 1);
+    EXPECT_EQ(std::string_view(_printed), "<B>\n\t<!--c-->\n");
+}
+
+TEST(xml, print_reproduces_exported_sets)
+{
+    for (const fmtals::version _ver : { fmtals::version::v_9_7_7, fmtals::version::v_11_0_0, fmtals::version::v_12_0_0 }) {
+        fmtals::project _proj = make_test_project(5, 2, _ver);
+        std::get<fmtals::project::audio_track>(_proj.tracks[2]).events_audio_clips.resize(1);
+        std::get<fmtals::project::audio_track>(_proj.tracks[2]).events_audio_clips[0].name = "<Clip> & \"quoted\" 'name'";
+        std::get<fmtals::project::midi_track>(_proj.tracks[1]).effective_name = fmtals::make_atom("Track & <name>");
+        fmtals::migrate_project(_proj, _ver);
+        const std::string _set = export_test_set(_proj, _ver);
+        const std::string _text = export_test_xml(_proj, _ver);
+        const std::string _root_text = _text.substr(_text.find("<Ableton"));
+        EXPECT_EQ(print_test_xml(_root_text), _root_text);
+
+        fmtals::project _imported;
+        EXPECT_EQ(import_test_set(_set, _imported), _ver);
+        EXPECT_EQ(export_test_set(_imported, _ver), _set);
+        EXPECT_EQ(export_test_xml(_imported, _ver), _text);
+    }
+}
@@ -1,52 +1,197 @@
 #include <fmtals/fmtals.hpp>
+#include <fmtals/pack.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <functional>
 
-extern void gz_decompress(std::istream& gz_stream, std::string& data);
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
 
-std::string remove_double_newlines(const std::string& input)
-{
-    std::istringstream _stream(input);
-    std::string _line;
-    std::string _result;
-    while (std::getline(_stream, _line)) {
-        if (!_line.empty()) {
-            _result += _line;
+extern void gz_decompress(std::istream& gz_stream, const std::function<void(const char*, std::size_t)>& callback);
+
+/// @brief Removes line breaks from the inflated XML while it is streamed through a small output
+/// buffer. Compact mode drops every line break, pretty mode only drops blank lines
+struct newline_filter {
+    std::ostream& stream;
+    bool pretty;
+    bool line_has_content = false;
+    bool pending_carriage_return = false;
+    std::string buffer;
+
+    newline_filter(std::ostream& output_stream, const bool pretty_lines)
+        : stream(output_stream)
+        , pretty(pretty_lines)
+    {
+    }
+
+    void write(const char* chunk, const std::size_t size)
+    {
+        for (std::size_t _index = 0; _index < size; ++_index) {
+            const char _character = chunk[_index];
+            if (_character == '\n') {
+                if (pretty && line_has_content) {
+                    buffer.push_back('\n');
+                }
+                line_has_content = false;
+                pending_carriage_return = false;
+                continue;
+            }
+            if (pretty && pending_carriage_return) {
+                buffer.push_back('\r');
+                pending_carriage_return = false;
+            }
+            if (pretty && _character == '\r') {
+                pending_carriage_return = true;
+                continue;
+            }
+            buffer.push_back(_character);
+            line_has_content = true;
+        }
+        if (buffer.size() >= 65536) {
+            flush();
         }
     }
-    return _result;
-}
+
+    /// @brief Writes the buffer. A pending carriage return stays pending, the next chunk may start
+    /// with the line feed that drops it
+    void flush()
+    {
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    /// @brief Writes the buffer with a carriage return still pending at the end of the text
+    void finish()
+    {
+        if (pending_carriage_return) {
+            buffer.push_back('\r');
+            pending_carriage_return = false;
+        }
+        flush();
+    }
+};
 
 int main(int argc, char* argv[])
 {
-    if (argc < 2) {
+    bool _pretty = false;
+    std::string _member_name;
+    std::vector<std::string> _paths;
+    for (int _arg = 1; _arg < argc; ++_arg) {
+        const std::string _argument(argv[_arg]);
+        if (_argument == "--pretty") {
+            _pretty = true;
+        } else if (_argument == "--compact") {
+            _pretty = false;
+        } else if (_argument == "--member" && _arg + 1 < argc) {
+            _member_name = argv[++_arg];
+        } else {
+            _paths.emplace_back(_argument);
+        }
+    }
+    if (_paths.empty() || _paths.size() > 2) {
         std::cerr << "Usage: drag a .als file onto the executable\n";
+        std::cerr << "       als2xml [--compact | --pretty] <input.als | -> [output.xml | -]\n";
+        std::cerr << "       als2xml [--compact | --pretty] --member <name.als> <input.alp> [output.xml | -]\n";
         return 1;
     }
-    std::filesystem::path _input_path(argv[1]);
-    if (!std::filesystem::exists(_input_path)) {
-        std::cerr << "Error: File does not exist\n";
-        return 2;
-    }
-    if (_input_path.extension() != ".als" && _input_path.extension() != ".alp") {
-        std::cerr << "Error: File is not an Ableton Live set or preset\n";
-        return 3;
+    const bool _use_stdin = _paths[0] == "-";
+    std::filesystem::path _input_path(_paths[0]);
+    if (!_use_stdin) {
+        if (!std::filesystem::exists(_input_path)) {
+            std::cerr << "Error: File does not exist\n";
+            return 2;
+        }
+        if (_input_path.extension() != ".als" && _input_path.extension() != ".alp") {
+            std::cerr << "Error: File is not an Ableton Live set or preset\n";
+            return 3;
+        }
     }
-    std::ifstream _input_stream(_input_path, std::ios::binary);
-    std::string _xml_data;
-    gz_decompress(_input_stream, _xml_data);
     std::filesystem::path _output_path = _input_path;
     _output_path.replace_extension(".xml");
-    std::ofstream _output_stream(_output_path);
+    if (_paths.size() == 2) {
+        _output_path = _paths[1];
+    }
+    const bool _use_stdout = (_use_stdin && _paths.size() == 1) || _output_path == "-";
+
+#ifdef _WIN32
+    if (_use_stdin) {
+        _setmode(_fileno(stdin), _O_BINARY);
+    }
+    if (_use_stdout) {
+        _setmode(_fileno(stdout), _O_BINARY);
+    }
+#endif
+    std::ios::sync_with_stdio(false);
+    std::ifstream _input_file;
+    if (!_use_stdin) {
+        _input_file.open(_input_path, std::ios::binary);
+    }
+    std::istream& _input_stream = _use_stdin ? std::cin : _input_file;
+    fmtals::pack _pack;
+    const fmtals::pack_member* _pack_member = nullptr;
+    const bool _is_pack = !_use_stdin && _input_file.peek() == 'P';
+    if (_is_pack) {
+        try {
+            fmtals::open_pack(_input_path, _pack);
+        } catch (const std::exception& _exception) {
+            std::cerr << "Error: " << _exception.what() << '\n';
+            return 5;
+        }
+        const std::vector<fmtals::pack_member>::const_iterator _member = std::find_if(_pack.members.begin(), _pack.members.end(), [&](const fmtals::pack_member& member) {
+            return member.name == _member_name;
+        });
+        if (_member == _pack.members.end()) {
+            std::cerr << "Error: Select a Live Pack member with --member, available sets are:\n";
+            for (const fmtals::pack_member& _listed_member : _pack.members) {
+                if (std::filesystem::u8path(_listed_member.name).extension() == ".als") {
+                    std::cerr << "  " << _listed_member.name << '\n';
+                }
+            }
+            return 3;
+        }
+        _input_file.close();
+        _input_file.clear();
+        _pack_member = &*_member;
+    }
+    std::ofstream _output_file;
+    if (!_use_stdout) {
+        _output_file.open(_output_path, std::ios::binary);
+        if (!_output_file) {
+            std::cerr << "Error: Could not write to file: " << _output_path << '\n';
+            return 4;
+        }
+    }
+    std::ostream& _output_stream = _use_stdout ? std::cout : _output_file;
+
+    newline_filter _filter(_output_stream, _pretty);
+    try {
+        const auto _write = [&](const char* chunk, const std::size_t size) {
+            _filter.write(chunk, size);
+        };
+        if (_is_pack) {
+            fmtals::stream_pack_member(_pack, *_pack_member, [&](std::istream& member_stream) {
+                gz_decompress(member_stream, _write);
+            });
+        } else {
+            gz_decompress(_input_stream, _write);
+        }
+    } catch (const std::exception& _exception) {
+        std::cerr << "Error: " << _exception.what() << '\n';
+        return 5;
+    }
+    _filter.finish();
+    _output_stream.flush();
     if (!_output_stream) {
         std::cerr << "Error: Could not write to file: " << _output_path << '\n';
         return 4;
     }
-    _output_stream << remove_double_newlines(_xml_data);
-    // _output_stream << (_xml_data);
-    _output_stream.close();
-    std::cout << "XML written to: " << _output_path << '\n';
+    if (!_use_stdout) {
+        _output_file.close();
+        std::cout << "XML written to: " << _output_path << '\n';
+    }
     return 0;
-}
\ No newline at end of file
+}
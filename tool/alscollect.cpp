@@ -0,0 +1,142 @@
+#include <fmtals/sample.hpp>
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "parallel.hpp"
+
+/// @brief Represents a referenced file after resolution, shared by every set that references it
+struct collected_sample {
+    std::filesystem::path resolved_path;
+    std::string reference;
+    std::optional<std::uint64_t> expected_size;
+    bool exists = false;
+    std::uint64_t size = 0;
+    std::uint32_t crc32 = 0;
+};
+
+std::filesystem::path resolve_sample(const std::filesystem::path& set_path, const fmtals::sample_reference& reference)
+{
+    if (!reference.relative_path.empty()) {
+        const std::filesystem::path _relative_path = set_path.parent_path() / std::filesystem::u8path(reference.relative_path);
+        if (std::filesystem::is_regular_file(_relative_path)) {
+            return _relative_path.lexically_normal();
+        }
+    }
+    if (!reference.path.empty()) {
+        return std::filesystem::u8path(reference.path).lexically_normal();
+    }
+    return (set_path.parent_path() / std::filesystem::u8path(reference.relative_path)).lexically_normal();
+}
+
+void hash_sample(collected_sample& sample, std::vector<char>& buffer)
+{
+    std::ifstream _stream(sample.resolved_path, std::ios::binary);
+    if (!_stream) {
+        return;
+    }
+    sample.exists = true;
+    uLong _crc = crc32(0L, Z_NULL, 0);
+    while (_stream) {
+        _stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const std::streamsize _count = _stream.gcount();
+        if (_count <= 0) {
+            break;
+        }
+        _crc = crc32(_crc, reinterpret_cast<const Bytef*>(buffer.data()), static_cast<uInt>(_count));
+        sample.size += static_cast<std::uint64_t>(_count);
+    }
+    sample.crc32 = static_cast<std::uint32_t>(_crc);
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t _jobs = parallel_jobs(0);
+    std::vector<std::filesystem::path> _set_paths;
+    for (int _arg = 1; _arg < argc; ++_arg) {
+        if (std::string(argv[_arg]) == "--jobs" && _arg + 1 < argc) {
+            const std::string _value(argv[++_arg]);
+            const std::from_chars_result _result = std::from_chars(_value.data(), _value.data() + _value.size(), _jobs);
+            if (_result.ec != std::errc() || _result.ptr != _value.data() + _value.size() || _jobs == 0 || _jobs > 1024) {
+                std::cerr << "Error: Invalid value for --jobs: " << _value << '\n';
+                return 1;
+            }
+        } else {
+            _set_paths.emplace_back(argv[_arg]);
+        }
+    }
+    if (_set_paths.empty()) {
+        std::cerr << "Usage: alscollect [--jobs <count>] <input.als>...\n";
+        std::cerr << "Lists the samples referenced by Ableton Live sets with their size and CRC-32,\n";
+        std::cerr << "and flags samples that are missing or whose size differs from the recorded one\n";
+        return 1;
+    }
+    const std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+
+    std::vector<std::vector<fmtals::sample_reference>> _references(_set_paths.size());
+    std::atomic<std::size_t> _failed_count = 0;
+    std::mutex _report_mutex;
+    parallel_for(_set_paths.size(), _jobs, [&](const std::size_t index) {
+        try {
+            std::ifstream _stream(_set_paths[index], std::ios::binary);
+            if (!_stream) {
+                throw std::runtime_error("Could not read file");
+            }
+            _references[index] = fmtals::scan_sample_references(_stream);
+        } catch (const std::exception& _exception) {
+            ++_failed_count;
+            std::lock_guard<std::mutex> _lock(_report_mutex);
+            std::cerr << "Error: " << _set_paths[index] << ": " << _exception.what() << '\n';
+        }
+    });
+
+    std::map<std::filesystem::path, std::size_t> _sample_indices;
+    std::vector<collected_sample> _samples;
+    for (std::size_t _set_index = 0; _set_index < _set_paths.size(); ++_set_index) {
+        for (const fmtals::sample_reference& _reference : _references[_set_index]) {
+            const std::filesystem::path _resolved_path = resolve_sample(_set_paths[_set_index], _reference);
+            if (_sample_indices.emplace(_resolved_path, _samples.size()).second) {
+                collected_sample& _sample = _samples.emplace_back();
+                _sample.resolved_path = _resolved_path;
+                _sample.reference = _reference.path.empty() ? _reference.relative_path : _reference.path;
+                _sample.expected_size = _reference.file_size;
+            }
+        }
+    }
+
+    parallel_for(
+        _samples.size(), _jobs, []() { return std::vector<char>(1 << 20); },
+        [&](std::vector<char>& _buffer, const std::size_t index) { hash_sample(_samples[index], _buffer); });
+
+    std::size_t _missing_count = 0;
+    std::size_t _modified_count = 0;
+    std::uint64_t _total_size = 0;
+    for (const collected_sample& _sample : _samples) {
+        char _crc[9];
+        std::snprintf(_crc, sizeof(_crc), "%08x", _sample.crc32);
+        if (!_sample.exists) {
+            ++_missing_count;
+            std::cout << "MISSING  " << _sample.reference << '\n';
+        } else if (_sample.expected_size && *_sample.expected_size != _sample.size) {
+            ++_modified_count;
+            std::cout << "MODIFIED " << _sample.size << ' ' << _crc << ' ' << _sample.resolved_path.u8string() << " (recorded size " << *_sample.expected_size << ")\n";
+        } else {
+            std::cout << "OK       " << _sample.size << ' ' << _crc << ' ' << _sample.resolved_path.u8string() << '\n';
+        }
+        _total_size += _sample.size;
+    }
+    const std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - _start;
+    std::cout << "Collected " << _samples.size() << " samples (" << _total_size << " bytes) from " << _set_paths.size() - _failed_count << " Ableton Live sets in " << _elapsed.count() << " s, "
+              << _missing_count << " missing, " << _modified_count << " modified\n";
+    return (_failed_count || _missing_count || _modified_count) ? 4 : 0;
+}
@@ -0,0 +1,146 @@
+#include <fmtals/fmtals.hpp>
+#include <fmtals/memory.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "parallel.hpp"
+
+bool parse_version(const std::string& text, fmtals::version& ver)
+{
+    static const std::pair<const char*, fmtals::version> _versions[] = {
+        { "9.0.0", fmtals::version::v_9_0_0 },
+        { "9.1.0", fmtals::version::v_9_1_0 },
+        { "9.2.0", fmtals::version::v_9_2_0 },
+        { "9.7.7", fmtals::version::v_9_7_7 },
+        { "11.0.0", fmtals::version::v_11_0_0 },
+        { "12.0.0", fmtals::version::v_12_0_0 },
+    };
+    for (const std::pair<const char*, fmtals::version>& _version : _versions) {
+        if (text == _version.first) {
+            ver = _version.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Parses a whole argument as an integer within [minimum, maximum]
+bool parse_count(const std::string& text, const std::size_t minimum, const std::size_t maximum, std::size_t& value)
+{
+    const std::from_chars_result _result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return _result.ec == std::errc() && _result.ptr == text.data() + text.size() && value >= minimum && value <= maximum;
+}
+
+/// @brief Converts a set with every allocation of the conversion counted against a budget, 0
+/// meaning no budget, and retrieves the peak of the bytes allocated
+std::size_t convert_file(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const fmtals::version& ver, const std::size_t budget)
+{
+    fmtals::memory_counter _counter;
+    _counter.budget = budget;
+    fmtals::project _project { fmtals::project::allocator_type(&_counter) };
+    fmtals::version _input_version;
+    {
+        std::ifstream _input_stream(input_path, std::ios::binary);
+        if (!_input_stream) {
+            throw std::runtime_error("Could not read file");
+        }
+        fmtals::import_options _options;
+        _options.resource = &_counter;
+        fmtals::import_project(_input_stream, _project, _input_version, _options);
+    }
+    fmtals::migrate_project(_project, ver);
+    std::filesystem::create_directories(output_path.parent_path());
+    std::filesystem::path _temporary_path = output_path;
+    _temporary_path += ".tmp";
+    try {
+        std::ofstream _output_stream(_temporary_path, std::ios::binary);
+        fmtals::export_options _options;
+        _options.resource = &_counter;
+        fmtals::export_project(_output_stream, _project, ver, _options);
+        _output_stream.close();
+        if (!_output_stream) {
+            throw std::runtime_error("Could not write to file: " + _temporary_path.string());
+        }
+        std::filesystem::rename(_temporary_path, output_path);
+    } catch (...) {
+        std::error_code _error;
+        std::filesystem::remove(_temporary_path, _error);
+        throw;
+    }
+    return _counter.peak_bytes;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4) {
+        std::cerr << "Usage: alsconvert <input directory> <output directory> <version> [--jobs <count>] [--memory <megabytes>]\n";
+        std::cerr << "Versions: 9.0.0, 9.1.0, 9.2.0, 9.7.7, 11.0.0, 12.0.0\n";
+        return 1;
+    }
+    std::filesystem::path _input_directory(argv[1]);
+    std::filesystem::path _output_directory(argv[2]);
+    if (!std::filesystem::is_directory(_input_directory)) {
+        std::cerr << "Error: Input directory does not exist\n";
+        return 2;
+    }
+    fmtals::version _version;
+    if (!parse_version(argv[3], _version)) {
+        std::cerr << "Error: Unsupported Ableton Live version: " << argv[3] << '\n';
+        return 3;
+    }
+    std::size_t _jobs = parallel_jobs(0);
+    std::size_t _budget = 0;
+    for (int _arg = 4; _arg < argc; ++_arg) {
+        const std::string _option(argv[_arg]);
+        if ((_option == "--jobs" || _option == "--memory") && _arg + 1 < argc) {
+            const std::string _value(argv[++_arg]);
+            const bool _valid = _option == "--jobs" ? parse_count(_value, 1, 1024, _jobs) : parse_count(_value, 0, std::numeric_limits<std::size_t>::max() >> 20, _budget);
+            if (!_valid) {
+                std::cerr << "Error: Invalid value for " << _option << ": " << _value << '\n';
+                std::cerr << "Usage: alsconvert <input directory> <output directory> <version> [--jobs <count>] [--memory <megabytes>]\n";
+                return 1;
+            }
+        }
+    }
+    _budget <<= 20;
+
+    std::vector<std::filesystem::path> _input_paths;
+    for (const std::filesystem::directory_entry& _entry : std::filesystem::recursive_directory_iterator(_input_directory)) {
+        if (_entry.is_regular_file() && _entry.path().extension() == ".als") {
+            _input_paths.emplace_back(_entry.path());
+        }
+    }
+    std::sort(_input_paths.begin(), _input_paths.end());
+
+    std::atomic<std::size_t> _failed_count = 0;
+    std::mutex _report_mutex;
+    const std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+    parallel_for(_input_paths.size(), _jobs, [&](const std::size_t _index) {
+        const std::filesystem::path& _input_path = _input_paths[_index];
+        const std::filesystem::path _output_path = _output_directory / std::filesystem::relative(_input_path, _input_directory);
+        const std::chrono::steady_clock::time_point _file_start = std::chrono::steady_clock::now();
+        try {
+            const std::size_t _peak_bytes = convert_file(_input_path, _output_path, _version, _budget);
+            const std::chrono::duration<double, std::milli> _elapsed = std::chrono::steady_clock::now() - _file_start;
+            std::lock_guard<std::mutex> _lock(_report_mutex);
+            std::cout << "OK     " << _elapsed.count() << " ms " << (_peak_bytes >> 10) << " KB " << _input_path.string() << '\n';
+        } catch (const std::exception& _exception) {
+            const std::chrono::duration<double, std::milli> _elapsed = std::chrono::steady_clock::now() - _file_start;
+            ++_failed_count;
+            std::lock_guard<std::mutex> _lock(_report_mutex);
+            std::cout << "FAILED " << _elapsed.count() << " ms " << _input_path.string() << ": " << _exception.what() << '\n';
+        }
+    });
+    const std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - _start;
+    std::cout << "Converted " << _input_paths.size() - _failed_count << " of " << _input_paths.size() << " Ableton Live sets in " << _elapsed.count() << " s\n";
+    return _failed_count ? 4 : 0;
+}
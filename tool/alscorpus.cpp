@@ -0,0 +1,91 @@
+#include <fmtals/corpus.hpp>
+
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cerr << "Usage: alscorpus <dataset directory> [--batch <count>] [<input.als or directory>...]\n";
+        std::cerr << "Appends Ableton Live sets to a columnar dataset of their projects, tracks,\n";
+        std::cerr << "automation lanes, scenes and audio clips, or lists its columns without sets\n";
+        return 1;
+    }
+    const std::filesystem::path _dataset_path(argv[1]);
+    std::size_t _batch = 256;
+    std::vector<std::filesystem::path> _set_paths;
+    for (int _arg = 2; _arg < argc; ++_arg) {
+        const std::string _option(argv[_arg]);
+        if (_option == "--batch" && _arg + 1 < argc) {
+            const std::string _value(argv[++_arg]);
+            const std::from_chars_result _result = std::from_chars(_value.data(), _value.data() + _value.size(), _batch);
+            if (_result.ec != std::errc() || _result.ptr != _value.data() + _value.size() || _batch == 0 || _batch > 1000000) {
+                std::cerr << "Error: Invalid value for --batch: " << _value << '\n';
+                return 1;
+            }
+        } else if (std::filesystem::is_directory(argv[_arg])) {
+            for (const std::filesystem::directory_entry& _entry : std::filesystem::recursive_directory_iterator(argv[_arg])) {
+                if (_entry.is_regular_file() && _entry.path().extension() == ".als") {
+                    _set_paths.emplace_back(_entry.path());
+                }
+            }
+        } else {
+            _set_paths.emplace_back(argv[_arg]);
+        }
+    }
+
+    if (_set_paths.empty()) {
+        static const char* _table_names[] = { "project", "track", "automation_lane", "scene", "audio_clip" };
+        static const char* _type_names[] = { "boolean", "int32", "uint32", "float32", "string" };
+        fmtals::corpus_dataset _dataset;
+        try {
+            fmtals::open_corpus_dataset(_dataset_path, _dataset);
+        } catch (const std::exception& _exception) {
+            std::cerr << "Error: " << _exception.what() << '\n';
+            return 2;
+        }
+        for (const fmtals::corpus_column& _column : fmtals::list_corpus_columns(_dataset)) {
+            std::cout << _table_names[static_cast<std::size_t>(_column.table)] << '.' << _column.name << ' '
+                      << _type_names[static_cast<std::size_t>(_column.type)] << ' ' << _column.row_count << '\n';
+        }
+        return 0;
+    }
+
+    const std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+    std::size_t _appended = 0;
+    std::size_t _failed = 0;
+    fmtals::corpus_builder _builder;
+    fmtals::project _proj;
+    for (std::size_t _index = 0; _index < _set_paths.size(); ++_index) {
+        try {
+            std::ifstream _stream(_set_paths[_index], std::ios::binary);
+            if (!_stream) {
+                throw std::runtime_error("Failed to open file");
+            }
+            fmtals::version _ver;
+            fmtals::import_project(_stream, _proj, _ver);
+            fmtals::add_corpus_project(_builder, _proj, _ver, _set_paths[_index].generic_string());
+            ++_appended;
+        } catch (const std::exception& _exception) {
+            std::cerr << "Error: " << _set_paths[_index] << ": " << _exception.what() << '\n';
+            ++_failed;
+        }
+        if ((_index + 1) % _batch == 0 || _index + 1 == _set_paths.size()) {
+            try {
+                fmtals::append_corpus_dataset(_dataset_path, _builder);
+            } catch (const std::exception& _exception) {
+                std::cerr << "Error: " << _exception.what() << '\n';
+                return 3;
+            }
+            _builder = fmtals::corpus_builder();
+        }
+    }
+    const std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - _start;
+    std::cout << "Appended " << _appended << " Ableton Live sets in " << _elapsed.count() << " s, " << _failed << " failed\n";
+    return _failed == 0 ? 0 : 4;
+}
@@ -0,0 +1,131 @@
+#include <fmtals/search.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+bool parse_field(const std::string& text, fmtals::search_field& field)
+{
+    static const std::pair<const char*, fmtals::search_field> _fields[] = {
+        { "plugin", fmtals::search_field::plugin },
+        { "sample", fmtals::search_field::sample },
+        { "sample-name", fmtals::search_field::sample_name },
+        { "track", fmtals::search_field::track },
+        { "scene", fmtals::search_field::scene },
+        { "version", fmtals::search_field::version },
+        { "creator", fmtals::search_field::creator },
+    };
+    for (const std::pair<const char*, fmtals::search_field>& _field : _fields) {
+        if (text == _field.first) {
+            field = _field.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Represents a query term, every set of the result contains all of them
+struct query_term {
+    fmtals::search_field field;
+    std::string text;
+    bool prefix = false;
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        std::cerr << "Usage: alsindex <index> [--jobs <count>] <input.als or directory>...\n";
+        std::cerr << "       alsindex <index> [--find <field> <term>] [--prefix <field> <prefix>]...\n";
+        std::cerr << "Updates a search index so that it holds the Ableton Live sets specified, reading\n";
+        std::cerr << "only new and modified sets, or lists the indexed sets that contain every term\n";
+        std::cerr << "Fields: plugin, sample, sample-name, track, scene, version, creator\n";
+        return 1;
+    }
+    const std::filesystem::path _index_path(argv[1]);
+    std::size_t _jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::filesystem::path> _set_paths;
+    std::vector<query_term> _query;
+    for (int _arg = 2; _arg < argc; ++_arg) {
+        const std::string _option(argv[_arg]);
+        if (_option == "--jobs" && _arg + 1 < argc) {
+            const std::string _value(argv[++_arg]);
+            const std::from_chars_result _result = std::from_chars(_value.data(), _value.data() + _value.size(), _jobs);
+            if (_result.ec != std::errc() || _result.ptr != _value.data() + _value.size() || _jobs == 0 || _jobs > 1024) {
+                std::cerr << "Error: Invalid value for --jobs: " << _value << '\n';
+                return 1;
+            }
+        } else if ((_option == "--find" || _option == "--prefix") && _arg + 2 < argc) {
+            query_term& _term = _query.emplace_back();
+            if (!parse_field(argv[++_arg], _term.field)) {
+                std::cerr << "Error: Unsupported field: " << argv[_arg] << '\n';
+                return 3;
+            }
+            _term.text = argv[++_arg];
+            _term.prefix = _option == "--prefix";
+        } else if (std::filesystem::is_directory(argv[_arg])) {
+            for (const std::filesystem::directory_entry& _entry : std::filesystem::recursive_directory_iterator(argv[_arg])) {
+                if (_entry.is_regular_file() && _entry.path().extension() == ".als") {
+                    _set_paths.emplace_back(_entry.path());
+                }
+            }
+        } else {
+            _set_paths.emplace_back(argv[_arg]);
+        }
+    }
+    const std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+
+    if (_query.empty()) {
+        fmtals::search_update _update;
+        try {
+            _update = fmtals::update_search_index(_index_path, _set_paths, _jobs);
+        } catch (const std::exception& _exception) {
+            std::cerr << "Error: " << _exception.what() << '\n';
+            return 2;
+        }
+        for (const std::pair<std::filesystem::path, std::string>& _failed : _update.failed) {
+            std::cerr << "Error: " << _failed.first << ": " << _failed.second << '\n';
+        }
+        const std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - _start;
+        std::cout << "Indexed " << _update.indexed << " Ableton Live sets in " << _elapsed.count() << " s, " << _update.reused << " unchanged, "
+                  << _update.removed << " removed, " << _update.failed.size() << " failed\n";
+        return _update.failed.empty() ? 0 : 4;
+    }
+
+    fmtals::search_index _index;
+    try {
+        fmtals::open_search_index(_index_path, _index);
+    } catch (const std::exception& _exception) {
+        std::cerr << "Error: " << _exception.what() << '\n';
+        return 2;
+    }
+    std::vector<std::size_t> _set_indices;
+    std::vector<std::size_t> _term_set_indices;
+    std::vector<std::size_t> _intersection;
+    for (std::size_t _term_index = 0; _term_index < _query.size(); ++_term_index) {
+        const query_term& _term = _query[_term_index];
+        if (_term.prefix) {
+            fmtals::find_search_sets_by_prefix(_index, _term.field, _term.text, _term_set_indices);
+        } else {
+            fmtals::find_search_sets(_index, _term.field, _term.text, _term_set_indices);
+        }
+        if (_term_index == 0) {
+            _set_indices.swap(_term_set_indices);
+        } else {
+            _intersection.clear();
+            std::set_intersection(_set_indices.begin(), _set_indices.end(), _term_set_indices.begin(), _term_set_indices.end(), std::back_inserter(_intersection));
+            _set_indices.swap(_intersection);
+        }
+    }
+    for (const std::size_t _set_index : _set_indices) {
+        std::cout << fmtals::get_search_set(_index, _set_index).path << '\n';
+    }
+    const std::chrono::duration<double, std::milli> _elapsed = std::chrono::steady_clock::now() - _start;
+    std::cerr << "Found " << _set_indices.size() << " of " << fmtals::search_set_count(_index) << " Ableton Live sets in " << _elapsed.count() << " ms\n";
+    return 0;
+}
@@ -0,0 +1,704 @@
+#include <fmtals/atom.hpp>
+#include <fmtals/fmtals.hpp>
+#include <fmtals/lom.hpp>
+#include <fmtals/memory.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include <csignal>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Protocol. Every integer is little endian, a string is a u32 byte count followed by its bytes
+// and a path is a string. A request is a u32 byte count followed by a u8 opcode and its payload,
+// a response is a u32 byte count followed by a u8 status and its payload. On error the status is
+// 1 and the payload is a message string, otherwise the status is 0 and the payload is:
+//
+//   0x01 header  (path)           u32 version, major version, minor version, creator, revision,
+//                                 u32 track count, u32 return track count, u32 scene count
+//   0x02 tracks  (path)           u32 count, then per track u8 kind (0 audio, 1 midi, 2 group,
+//                                 3 return), u32 id, u32 lom id, effective name, user name,
+//                                 u8 has color, u32 color
+//   0x03 scenes  (path)           u32 count, then per scene name, annotation, u32 color index,
+//                                 u32 lom id
+//   0x04 lom id  (path, u32 id)   u8 found, u32 owner, u32 field, u64 index, u64 child index
+//   0x05 stats   ()               u32 entry count, u64 cached bytes, u64 budget bytes, u64 hits,
+//                                 u64 misses, u64 imports
+//
+// Requests larger than max_request_size close the connection. Sets are imported on worker threads
+// on the first request that names them, the client waits for the import while the others are
+// still answered, and stay cached until their file changes or the cache exceeds its memory
+// budget, least recently used sets are evicted first. The socket is only accessible to the user
+// running the daemon.
+
+static constexpr std::uint32_t max_request_size = 1 << 16;
+
+/// @brief Represents an imported set. The project lives in its own arena so that its footprint is
+/// known and it is freed at once on eviction
+struct cached_set {
+    std::string path;
+    fmtals::memory_counter counter;
+    std::pmr::monotonic_buffer_resource arena { &counter };
+    fmtals::project proj { fmtals::project::allocator_type(&arena) };
+    fmtals::version ver = fmtals::version::v_12_0_0;
+    fmtals::lom_index index;
+
+    std::size_t bytes() const
+    {
+        return counter.bytes + index.ids.capacity() * sizeof(std::uint32_t) + index.handles.capacity() * sizeof(fmtals::lom_handle);
+    }
+};
+
+/// @brief Represents the import of a set on a worker thread. Workers only touch the set and the
+/// error, the event loop owns the rest
+struct import_job {
+    std::string path;
+    std::unique_ptr<cached_set> set;
+    std::exception_ptr error;
+    bool stale = false;
+    std::vector<std::uint64_t> clients;
+};
+
+/// @brief Represents the imports waiting for a worker and the ones done, the event file descriptor
+/// wakes the event loop when an import is done
+struct import_queue {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::shared_ptr<import_job>> pending;
+    std::deque<std::shared_ptr<import_job>> done;
+    int event_fd = -1;
+    bool stopping = false;
+};
+
+/// @brief Represents a watched directory and the names of the cached and importing sets it
+/// contains
+struct watched_directory {
+    std::string path;
+    std::map<std::string, std::size_t> names;
+};
+
+/// @brief Represents the cache of the daemon, sets are kept from the most to the least recently
+/// used
+struct set_cache {
+    std::size_t budget = 0;
+    std::size_t bytes = 0;
+    std::list<std::unique_ptr<cached_set>> sets;
+    std::unordered_map<std::string, std::list<std::unique_ptr<cached_set>>::iterator> lookup;
+    std::unordered_map<std::string, std::shared_ptr<import_job>> importing;
+    int inotify_fd = -1;
+    std::unordered_map<int, watched_directory> directories;
+    std::unordered_map<std::string, int> directory_watches;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t imports = 0;
+};
+
+void watch_set(set_cache& cache, const std::filesystem::path& path)
+{
+    const std::string _directory = path.parent_path().string();
+    auto _watch = cache.directory_watches.find(_directory);
+    if (_watch == cache.directory_watches.end()) {
+        const int _descriptor = inotify_add_watch(cache.inotify_fd, _directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE);
+        if (_descriptor < 0) {
+            throw std::runtime_error("Could not watch directory: " + _directory);
+        }
+        _watch = cache.directory_watches.emplace(_directory, _descriptor).first;
+        cache.directories[_descriptor].path = _directory;
+    }
+    ++cache.directories[_watch->second].names[path.filename().string()];
+}
+
+void unwatch_set(set_cache& cache, const std::filesystem::path& path)
+{
+    const auto _watch = cache.directory_watches.find(path.parent_path().string());
+    if (_watch == cache.directory_watches.end()) {
+        return;
+    }
+    watched_directory& _directory = cache.directories[_watch->second];
+    const auto _name = _directory.names.find(path.filename().string());
+    if (_name != _directory.names.end() && --_name->second == 0) {
+        _directory.names.erase(_name);
+    }
+    if (_directory.names.empty()) {
+        inotify_rm_watch(cache.inotify_fd, _watch->second);
+        cache.directories.erase(_watch->second);
+        cache.directory_watches.erase(_watch);
+    }
+}
+
+void evict_set(set_cache& cache, const std::string& path)
+{
+    const auto _found = cache.lookup.find(path);
+    if (_found == cache.lookup.end()) {
+        return;
+    }
+    cache.bytes -= (*_found->second)->bytes();
+    unwatch_set(cache, path);
+    cache.sets.erase(_found->second);
+    cache.lookup.erase(_found);
+}
+
+cached_set* find_set(set_cache& cache, const std::string& path)
+{
+    const auto _found = cache.lookup.find(path);
+    if (_found == cache.lookup.end()) {
+        return nullptr;
+    }
+    cache.sets.splice(cache.sets.begin(), cache.sets, _found->second);
+    return cache.sets.front().get();
+}
+
+cached_set& add_set(set_cache& cache, std::unique_ptr<cached_set> set)
+{
+    const std::string _path = set->path;
+    cache.bytes += set->bytes();
+    cache.sets.emplace_front(std::move(set));
+    cache.lookup[_path] = cache.sets.begin();
+    while (cache.bytes > cache.budget && cache.sets.size() > 1) {
+        evict_set(cache, cache.sets.back()->path);
+    }
+    return *cache.sets.front();
+}
+
+/// @brief Queues the import of a set for a client, or adds the client to the import of the set
+/// already queued. The directory is watched before reading so that a change during the import
+/// is not missed
+void queue_import(set_cache& cache, import_queue& queue, const std::string& path, const std::uint64_t client_id)
+{
+    auto _found = cache.importing.find(path);
+    if (_found == cache.importing.end()) {
+        std::shared_ptr<import_job> _job = std::make_shared<import_job>();
+        _job->path = path;
+        watch_set(cache, path);
+        _found = cache.importing.emplace(path, _job).first;
+        std::lock_guard<std::mutex> _lock(queue.mutex);
+        queue.pending.emplace_back(std::move(_job));
+        queue.condition.notify_one();
+    }
+    _found->second->clients.emplace_back(client_id);
+}
+
+/// @brief Imports the sets queued until the queue stops
+void run_imports(import_queue& queue)
+{
+    while (true) {
+        std::shared_ptr<import_job> _job;
+        {
+            std::unique_lock<std::mutex> _lock(queue.mutex);
+            queue.condition.wait(_lock, [&]() { return queue.stopping || !queue.pending.empty(); });
+            if (queue.stopping) {
+                return;
+            }
+            _job = std::move(queue.pending.front());
+            queue.pending.pop_front();
+        }
+        try {
+            if (!std::filesystem::is_regular_file(_job->path)) {
+                throw std::runtime_error("Could not read file: " + _job->path);
+            }
+            std::unique_ptr<cached_set> _set = std::make_unique<cached_set>();
+            _set->path = _job->path;
+            std::ifstream _stream(_job->path, std::ios::binary);
+            if (!_stream) {
+                throw std::runtime_error("Could not read file: " + _job->path);
+            }
+            fmtals::import_project(_stream, _set->proj, _set->ver, _set->index);
+            _job->set = std::move(_set);
+        } catch (...) {
+            _job->error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> _lock(queue.mutex);
+            queue.done.emplace_back(std::move(_job));
+        }
+        const std::uint64_t _one = 1;
+        if (write(queue.event_fd, &_one, sizeof(_one)) < 0) {
+            std::cerr << "Error: Could not wake the event loop: " << std::strerror(errno) << '\n';
+        }
+    }
+}
+
+void read_events(set_cache& cache)
+{
+    alignas(inotify_event) char _buffer[16384];
+    while (true) {
+        const ssize_t _count = read(cache.inotify_fd, _buffer, sizeof(_buffer));
+        if (_count <= 0) {
+            return;
+        }
+        for (ssize_t _offset = 0; _offset < _count;) {
+            const inotify_event* _event = reinterpret_cast<const inotify_event*>(_buffer + _offset);
+            _offset += static_cast<ssize_t>(sizeof(inotify_event) + _event->len);
+            const auto _directory = cache.directories.find(_event->wd);
+            if (_directory == cache.directories.end() || !_event->len) {
+                continue;
+            }
+            const std::string _name(_event->name);
+            if (_directory->second.names.count(_name)) {
+                const std::string _path = (std::filesystem::path(_directory->second.path) / _name).string();
+                evict_set(cache, _path);
+                const auto _job = cache.importing.find(_path);
+                if (_job != cache.importing.end()) {
+                    _job->second->stale = true;
+                }
+            }
+        }
+    }
+}
+
+/// @brief Represents a request or response payload being read or written
+struct message {
+    std::string data;
+    std::size_t offset = 0;
+
+    template <typename T>
+    T read()
+    {
+        if (data.size() - offset < sizeof(T)) {
+            throw std::runtime_error("Truncated request");
+        }
+        T _value = 0;
+        for (std::size_t _byte = 0; _byte < sizeof(T); ++_byte) {
+            _value |= static_cast<T>(static_cast<unsigned char>(data[offset++])) << (_byte * 8);
+        }
+        return _value;
+    }
+
+    std::string read_string()
+    {
+        const std::uint32_t _size = read<std::uint32_t>();
+        if (data.size() - offset < _size) {
+            throw std::runtime_error("Truncated request");
+        }
+        offset += _size;
+        return data.substr(offset - _size, _size);
+    }
+
+    template <typename T>
+    void write(const T value)
+    {
+        for (std::size_t _byte = 0; _byte < sizeof(T); ++_byte) {
+            data.push_back(static_cast<char>(static_cast<std::uint64_t>(value) >> (_byte * 8)));
+        }
+    }
+
+    void write_string(const std::string_view text)
+    {
+        write<std::uint32_t>(static_cast<std::uint32_t>(text.size()));
+        data.append(text);
+    }
+};
+
+void answer_stats(const set_cache& cache, message& response)
+{
+    response.write<std::uint32_t>(static_cast<std::uint32_t>(cache.sets.size()));
+    response.write<std::uint64_t>(cache.bytes);
+    response.write<std::uint64_t>(cache.budget);
+    response.write<std::uint64_t>(cache.hits);
+    response.write<std::uint64_t>(cache.misses);
+    response.write<std::uint64_t>(cache.imports);
+}
+
+/// @brief Answers a request about a set, the request is read past its path
+void answer_set_request(const cached_set& set, const std::uint8_t opcode, message& request, message& response)
+{
+    const fmtals::project& _project = set.proj;
+    switch (opcode) {
+    case 0x01:
+        response.write<std::uint32_t>(static_cast<std::uint32_t>(set.ver));
+        response.write_string(_project.major_version);
+        response.write_string(_project.minor_version);
+        response.write_string(_project.creator);
+        response.write_string(_project.revision);
+        response.write<std::uint32_t>(static_cast<std::uint32_t>(_project.tracks.size()));
+        response.write<std::uint32_t>(static_cast<std::uint32_t>(_project.return_tracks.size()));
+        response.write<std::uint32_t>(static_cast<std::uint32_t>(_project.scene_names.size()));
+        break;
+    case 0x02:
+        response.write<std::uint32_t>(static_cast<std::uint32_t>(_project.tracks.size()));
+        for (const fmtals::project::user_track& _track : _project.tracks) {
+            response.write<std::uint8_t>(static_cast<std::uint8_t>(_track.index()));
+            std::visit(
+                [&](const fmtals::project::editable_track& track) {
+                    response.write<std::uint32_t>(track.id);
+                    response.write<std::uint32_t>(track.lom_id);
+                    response.write_string(fmtals::atom_string(track.effective_name));
+                    response.write_string(track.user_name);
+                    response.write<std::uint8_t>(track.color.has_value());
+                    response.write<std::uint32_t>(track.color.value_or(0));
+                },
+                _track);
+        }
+        break;
+    case 0x03:
+        response.write<std::uint32_t>(static_cast<std::uint32_t>(_project.scene_names.size()));
+        for (const fmtals::project::scene& _scene : _project.scene_names) {
+            response.write_string(_scene.value);
+            response.write_string(_scene.annotation);
+            response.write<std::uint32_t>(_scene.color_index);
+            response.write<std::uint32_t>(_scene.lom_id);
+        }
+        break;
+    case 0x04: {
+        const fmtals::lom_handle* _handle = fmtals::find_lom_id(set.index, request.read<std::uint32_t>());
+        response.write<std::uint8_t>(_handle != nullptr);
+        response.write<std::uint32_t>(_handle ? static_cast<std::uint32_t>(_handle->owner) : 0);
+        response.write<std::uint32_t>(_handle ? static_cast<std::uint32_t>(_handle->field) : 0);
+        response.write<std::uint64_t>(_handle ? _handle->index : fmtals::lom_handle::npos);
+        response.write<std::uint64_t>(_handle ? _handle->child_index : fmtals::lom_handle::npos);
+        break;
+    }
+    }
+}
+
+/// @brief Represents a connected client with the bytes received and not yet answered. While the
+/// set named by a request is imported the client waits with the rest of the request pending
+struct client {
+    std::uint64_t id = 0;
+    int fd = -1;
+    std::string input;
+    std::string output;
+    bool waiting = false;
+    std::uint8_t pending_opcode = 0;
+    message pending;
+};
+
+void write_response(client& connection, const message& response)
+{
+    message _header;
+    _header.write<std::uint32_t>(static_cast<std::uint32_t>(response.data.size()));
+    connection.output += _header.data;
+    connection.output += response.data;
+}
+
+void write_error(client& connection, const char* what)
+{
+    message _response;
+    _response.write<std::uint8_t>(1);
+    _response.write_string(what);
+    write_response(connection, _response);
+}
+
+/// @brief Answers a request at once, or queues the import of the set it names and leaves the
+/// client waiting
+void start_request(set_cache& cache, import_queue& queue, client& connection, message& request)
+{
+    message _response;
+    _response.write<std::uint8_t>(0);
+    try {
+        const std::uint8_t _opcode = request.read<std::uint8_t>();
+        if (_opcode == 0x05) {
+            answer_stats(cache, _response);
+        } else if (_opcode >= 0x01 && _opcode <= 0x04) {
+            const std::string _path = std::filesystem::weakly_canonical(std::filesystem::u8path(request.read_string())).string();
+            const cached_set* _set = find_set(cache, _path);
+            if (!_set) {
+                ++cache.misses;
+                queue_import(cache, queue, _path, connection.id);
+                connection.waiting = true;
+                connection.pending_opcode = _opcode;
+                connection.pending = std::move(request);
+                return;
+            }
+            ++cache.hits;
+            answer_set_request(*_set, _opcode, request, _response);
+        } else {
+            throw std::runtime_error("Unknown opcode");
+        }
+    } catch (const std::exception& _exception) {
+        write_error(connection, _exception.what());
+        return;
+    }
+    write_response(connection, _response);
+}
+
+/// @brief Answers the request of a client that waited for the import of a set, set is null when
+/// the import failed with error
+void finish_request(client& connection, const cached_set* set, const std::exception_ptr& error)
+{
+    connection.waiting = false;
+    message _response;
+    _response.write<std::uint8_t>(0);
+    try {
+        if (!set) {
+            std::rethrow_exception(error);
+        }
+        answer_set_request(*set, connection.pending_opcode, connection.pending, _response);
+    } catch (const std::exception& _exception) {
+        write_error(connection, _exception.what());
+        return;
+    }
+    write_response(connection, _response);
+}
+
+/// @brief Answers the complete requests received from a client until one has to wait for an
+/// import. Returns false when the client sent a request larger than max_request_size
+bool process_client(set_cache& cache, import_queue& queue, client& connection)
+{
+    while (!connection.waiting && connection.input.size() >= 4) {
+        message _size_reader { connection.input.substr(0, 4) };
+        const std::uint32_t _size = _size_reader.read<std::uint32_t>();
+        if (_size > max_request_size) {
+            return false;
+        }
+        if (connection.input.size() - 4 < _size) {
+            return true;
+        }
+        message _request { connection.input.substr(4, _size) };
+        connection.input.erase(0, 4 + static_cast<std::size_t>(_size));
+        start_request(cache, queue, connection, _request);
+    }
+    return true;
+}
+
+/// @brief Writes as much of the pending output of a client as the socket accepts. Returns false
+/// when the client is gone
+bool flush_client(client& connection)
+{
+    while (!connection.output.empty()) {
+        const ssize_t _count = send(connection.fd, connection.output.data(), connection.output.size(), MSG_NOSIGNAL);
+        if (_count < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        connection.output.erase(0, static_cast<std::size_t>(_count));
+    }
+    return true;
+}
+
+/// @brief Creates a directory only accessible to the current user, or checks that an existing one
+/// is. Returns false when it is not a directory, is owned by another user or grants any access to
+/// group or others
+bool make_private_directory(const std::string& path)
+{
+    if (mkdir(path.c_str(), 0700) != 0 && errno != EEXIST) {
+        return false;
+    }
+    struct stat _status;
+    return lstat(path.c_str(), &_status) == 0 && S_ISDIR(_status.st_mode) && _status.st_uid == getuid() && (_status.st_mode & 077) == 0;
+}
+
+/// @brief Removes the socket left behind by a daemon that is gone. Returns false when the path
+/// holds anything else, such as a file, a socket of another user or a socket still listened on
+bool remove_stale_socket(const sockaddr_un& address)
+{
+    struct stat _status;
+    if (lstat(address.sun_path, &_status) != 0) {
+        return errno == ENOENT;
+    }
+    if (!S_ISSOCK(_status.st_mode) || _status.st_uid != getuid()) {
+        return false;
+    }
+    const int _fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (_fd < 0) {
+        return false;
+    }
+    const bool _stale = connect(_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 && errno == ECONNREFUSED;
+    close(_fd);
+    return _stale && unlink(address.sun_path) == 0;
+}
+
+/// @brief Parses a whole argument as an integer within [minimum, maximum]
+bool parse_count(const std::string& text, const std::size_t minimum, const std::size_t maximum, std::size_t& value)
+{
+    const std::from_chars_result _result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return _result.ec == std::errc() && _result.ptr == text.data() + text.size() && value >= minimum && value <= maximum;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* _runtime_directory = getenv("XDG_RUNTIME_DIR");
+    std::string _socket_path = (_runtime_directory ? std::string(_runtime_directory) + "/fmtalsd" : "/tmp/fmtalsd-" + std::to_string(getuid())) + "/fmtalsd.sock";
+    set_cache _cache;
+    std::size_t _budget = 1024;
+    std::size_t _jobs = std::max(1u, std::thread::hardware_concurrency());
+    for (int _arg = 1; _arg < argc; ++_arg) {
+        const std::string _option(argv[_arg]);
+        if (_option == "--socket" && _arg + 1 < argc) {
+            _socket_path = argv[++_arg];
+        } else if (_option == "--memory" && _arg + 1 < argc && parse_count(argv[_arg + 1], 0, std::numeric_limits<std::size_t>::max() >> 20, _budget)) {
+            ++_arg;
+        } else if (_option == "--jobs" && _arg + 1 < argc && parse_count(argv[_arg + 1], 1, 1024, _jobs)) {
+            ++_arg;
+        } else {
+            std::cerr << "Usage: fmtalsd [--socket <path>] [--memory <megabytes>] [--jobs <count>]\n";
+            std::cerr << "Keeps imported Ableton Live sets in memory and answers queries about them\n";
+            std::cerr << "over a Unix domain socket, sets are imported again when their file changes.\n";
+            std::cerr << "The socket is created in a directory only accessible to the current user\n";
+            return 1;
+        }
+    }
+    _cache.budget = _budget << 20;
+
+    sockaddr_un _address {};
+    _address.sun_family = AF_UNIX;
+    if (_socket_path.size() >= sizeof(_address.sun_path)) {
+        std::cerr << "Error: Socket path is too long\n";
+        return 2;
+    }
+    std::memcpy(_address.sun_path, _socket_path.c_str(), _socket_path.size() + 1);
+    const std::string _socket_directory = std::filesystem::path(_socket_path).parent_path().string();
+    if (!make_private_directory(_socket_directory.empty() ? "." : _socket_directory)) {
+        std::cerr << "Error: " << _socket_directory << " must be a directory owned by the current user with mode 0700\n";
+        return 2;
+    }
+    if (!remove_stale_socket(_address)) {
+        std::cerr << "Error: " << _socket_path << " is in use or is not a socket of the current user\n";
+        return 2;
+    }
+    const int _listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    const mode_t _mask = umask(0177);
+    const bool _bound = _listen_fd >= 0 && bind(_listen_fd, reinterpret_cast<const sockaddr*>(&_address), sizeof(_address)) == 0;
+    umask(_mask);
+    if (!_bound || listen(_listen_fd, 64) < 0) {
+        std::cerr << "Error: Could not listen on " << _socket_path << ": " << std::strerror(errno) << '\n';
+        return 2;
+    }
+    _cache.inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_cache.inotify_fd < 0) {
+        std::cerr << "Error: Could not initialize inotify: " << std::strerror(errno) << '\n';
+        return 2;
+    }
+    import_queue _queue;
+    _queue.event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_queue.event_fd < 0) {
+        std::cerr << "Error: Could not create event: " << std::strerror(errno) << '\n';
+        return 2;
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    std::vector<std::thread> _workers;
+    for (std::size_t _worker = 0; _worker < _jobs; ++_worker) {
+        _workers.emplace_back(run_imports, std::ref(_queue));
+    }
+    std::cout << "Listening on " << _socket_path << " with a " << (_cache.budget >> 20) << " MB budget and " << _jobs << " import threads\n";
+
+    std::vector<client> _clients;
+    std::uint64_t _next_client_id = 0;
+    std::vector<pollfd> _poll_fds;
+    while (true) {
+        _poll_fds.clear();
+        _poll_fds.push_back({ _listen_fd, POLLIN, 0 });
+        _poll_fds.push_back({ _cache.inotify_fd, POLLIN, 0 });
+        _poll_fds.push_back({ _queue.event_fd, POLLIN, 0 });
+        for (const client& _client : _clients) {
+            // a waiting client is not read from so that its pending input stays bounded
+            _poll_fds.push_back({ _client.fd, static_cast<short>((_client.waiting ? 0 : POLLIN) | (_client.output.empty() ? 0 : POLLOUT)), 0 });
+        }
+        if (poll(_poll_fds.data(), _poll_fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error: " << std::strerror(errno) << '\n';
+            {
+                std::lock_guard<std::mutex> _lock(_queue.mutex);
+                _queue.stopping = true;
+                _queue.condition.notify_all();
+            }
+            for (std::thread& _worker : _workers) {
+                _worker.join();
+            }
+            return 2;
+        }
+
+        // file changes are processed before requests so that no stale set is answered
+        if (_poll_fds[1].revents & POLLIN) {
+            read_events(_cache);
+        }
+        for (std::size_t _index = _clients.size(); _index-- > 0;) {
+            client& _client = _clients[_index];
+            const short _events = _poll_fds[_index + 3].revents;
+            bool _alive = true;
+            if (_events & (POLLIN | POLLHUP | POLLERR)) {
+                char _buffer[65536];
+                const ssize_t _count = recv(_client.fd, _buffer, sizeof(_buffer), 0);
+                if (_count > 0) {
+                    _client.input.append(_buffer, static_cast<std::size_t>(_count));
+                    _alive = process_client(_cache, _queue, _client);
+                } else if (_count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    _alive = false;
+                }
+            }
+            if (_alive) {
+                _alive = flush_client(_client);
+            }
+            if (!_alive) {
+                close(_client.fd);
+                _clients.erase(_clients.begin() + static_cast<std::ptrdiff_t>(_index));
+            }
+        }
+        if (_poll_fds[2].revents & POLLIN) {
+            std::uint64_t _count;
+            while (read(_queue.event_fd, &_count, sizeof(_count)) > 0) {
+            }
+            std::deque<std::shared_ptr<import_job>> _done;
+            {
+                std::lock_guard<std::mutex> _lock(_queue.mutex);
+                _done.swap(_queue.done);
+            }
+            for (const std::shared_ptr<import_job>& _job : _done) {
+                if (_job->stale) {
+                    // the file changed during the import
+                    _job->stale = false;
+                    _job->set.reset();
+                    _job->error = nullptr;
+                    std::lock_guard<std::mutex> _lock(_queue.mutex);
+                    _queue.pending.emplace_back(_job);
+                    _queue.condition.notify_one();
+                    continue;
+                }
+                _cache.importing.erase(_job->path);
+                const cached_set* _set = nullptr;
+                if (_job->set) {
+                    ++_cache.imports;
+                    _set = &add_set(_cache, std::move(_job->set));
+                } else {
+                    unwatch_set(_cache, _job->path);
+                }
+                for (const std::uint64_t _client_id : _job->clients) {
+                    const auto _client = std::find_if(_clients.begin(), _clients.end(), [&](const client& connection) { return connection.id == _client_id; });
+                    if (_client == _clients.end()) {
+                        continue;
+                    }
+                    finish_request(*_client, _set, _job->error);
+                    if (!process_client(_cache, _queue, *_client) || !flush_client(*_client)) {
+                        close(_client->fd);
+                        _clients.erase(_client);
+                    }
+                }
+            }
+        }
+        if (_poll_fds[0].revents & POLLIN) {
+            for (int _fd = accept4(_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC); _fd >= 0; _fd = accept4(_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) {
+                client& _client = _clients.emplace_back();
+                _client.id = _next_client_id++;
+                _client.fd = _fd;
+            }
+        }
+    }
+}
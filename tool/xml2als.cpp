@@ -1,39 +1,97 @@
 #include <fmtals/fmtals.hpp>
 
+#include <atomic>
+#include <charconv>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <sstream>
+#include <vector>
 
-extern void gz_compress(std::ostream& gz_stream, const std::string& data);
+#include "parallel.hpp"
+
+extern void gz_compress(std::ostream& gz_stream, std::istream& data_stream);
+
+void compress_file(const std::filesystem::path& input_path, const std::filesystem::path& output_path)
+{
+    std::ifstream _input_stream(input_path);
+    if (!_input_stream) {
+        throw std::runtime_error("Could not read file");
+    }
+    std::filesystem::path _temporary_path = output_path;
+    _temporary_path += ".tmp";
+    try {
+        std::ofstream _output_stream(_temporary_path, std::ios::binary);
+        gz_compress(_output_stream, _input_stream);
+        _output_stream.close();
+        if (!_output_stream) {
+            throw std::runtime_error("Could not write to file: " + _temporary_path.string());
+        }
+        std::filesystem::rename(_temporary_path, output_path);
+    } catch (...) {
+        std::error_code _error;
+        std::filesystem::remove(_temporary_path, _error);
+        throw;
+    }
+}
 
 int main(int argc, char* argv[])
 {
-    if (argc < 2) {
+    std::size_t _jobs = parallel_jobs(0);
+    std::vector<std::filesystem::path> _arguments;
+    for (int _arg = 1; _arg < argc; ++_arg) {
+        if (std::string(argv[_arg]) == "--jobs" && _arg + 1 < argc) {
+            const std::string _value(argv[++_arg]);
+            const std::from_chars_result _result = std::from_chars(_value.data(), _value.data() + _value.size(), _jobs);
+            if (_result.ec != std::errc() || _result.ptr != _value.data() + _value.size() || _jobs == 0 || _jobs > 1024) {
+                std::cerr << "Error: Invalid value for --jobs: " << _value << '\n';
+                return 1;
+            }
+        } else {
+            _arguments.emplace_back(argv[_arg]);
+        }
+    }
+    if (_arguments.empty()) {
         std::cerr << "Usage: drag a .xml file onto the executable\n";
+        std::cerr << "       xml2als [--jobs <count>] <file.xml | directory>...\n";
         return 1;
     }
-    std::filesystem::path _input_path(argv[1]);
-    if (!std::filesystem::exists(_input_path)) {
-        std::cerr << "Error: File does not exist\n";
-        return 2;
-    }
-    if (_input_path.extension() != ".xml") {
-        std::cerr << "Error: File is not an XML file\n";
-        return 3;
+    std::vector<std::filesystem::path> _input_paths;
+    for (const std::filesystem::path& _argument : _arguments) {
+        if (std::filesystem::is_directory(_argument)) {
+            for (const std::filesystem::directory_entry& _entry : std::filesystem::recursive_directory_iterator(_argument)) {
+                if (_entry.is_regular_file() && _entry.path().extension() == ".xml") {
+                    _input_paths.emplace_back(_entry.path());
+                }
+            }
+            continue;
+        }
+        if (!std::filesystem::exists(_argument)) {
+            std::cerr << "Error: File does not exist: " << _argument << '\n';
+            return 2;
+        }
+        if (_argument.extension() != ".xml") {
+            std::cerr << "Error: File is not an XML file: " << _argument << '\n';
+            return 3;
+        }
+        _input_paths.emplace_back(_argument);
     }
-    std::ifstream _input_stream(_input_path);
-    std::ostringstream ss;
-    ss << _input_stream.rdbuf();
-    std::string _xml_data = ss.str();
-    std::filesystem::path _output_path = _input_path;
-    _output_path.replace_extension(".als");
-    std::ofstream _output_stream(_output_path, std::ios::binary);
-    gz_compress(_output_stream, _xml_data);
-    if (!_output_stream) {
-        std::cerr << "Error: Could not write to file: " << _output_path << '\n';
-        return 4;
-    }
-    _output_stream.close();
-    std::cout << "Ableton Live set written to: " << _output_path << '\n';
-    return 0;
-}
\ No newline at end of file
+
+    std::atomic<std::size_t> _failed_count = 0;
+    std::mutex _report_mutex;
+    parallel_for(_input_paths.size(), _jobs, [&](const std::size_t _index) {
+        const std::filesystem::path& _input_path = _input_paths[_index];
+        std::filesystem::path _output_path = _input_path;
+        _output_path.replace_extension(".als");
+        try {
+            compress_file(_input_path, _output_path);
+            std::lock_guard<std::mutex> _lock(_report_mutex);
+            std::cout << "Ableton Live set written to: " << _output_path << '\n';
+        } catch (const std::exception& _exception) {
+            ++_failed_count;
+            std::lock_guard<std::mutex> _lock(_report_mutex);
+            std::cerr << "Error: " << _input_path << ": " << _exception.what() << '\n';
+        }
+    });
+    return _failed_count ? 4 : 0;
+}